@@ -0,0 +1,188 @@
+#include "df_aggregate.h"
+
+// SlidingWindow
+
+SlidingWindow::SlidingWindow(std::size_t capacity)
+	: m_values(capacity > 0 ? capacity : 1), m_minimum(m_values.size()), m_maximum(m_values.size()),
+	  m_next(0), m_count(0), m_mean(0.0), m_squares(0.0)
+{}
+
+void SlidingWindow::add(double value) noexcept
+{
+	// Dropping the oldest sample of a full window
+	if(m_count == m_values.size()) {
+		uint32_t oldest = m_next - m_count;
+		double previous = this->value(oldest);
+
+		// Reverting the Welford update of the oldest sample
+		m_count--;
+		if(m_count == 0) {
+			m_mean = 0.0;
+			m_squares = 0.0;
+		}
+		else {
+			double delta = previous - m_mean;
+			m_mean -= delta / m_count;
+			m_squares -= delta * (previous - m_mean);
+		}
+
+		if(m_minimum.front() == oldest) m_minimum.pop_front();
+		if(m_maximum.front() == oldest) m_maximum.pop_front();
+	}
+
+	// Storing the sample and updating the mean and the squared differences
+	m_values[m_next % m_values.size()] = value;
+	m_count++;
+
+	double delta = value - m_mean;
+	m_mean += delta / m_count;
+	m_squares += delta * (value - m_mean);
+
+	// Dropping the samples which can not be the extremum anymore
+	while(!m_minimum.empty() && this->value(m_minimum.back()) >= value) m_minimum.pop_back();
+	while(!m_maximum.empty() && this->value(m_maximum.back()) <= value) m_maximum.pop_back();
+	m_minimum.push_back(m_next);
+	m_maximum.push_back(m_next);
+
+	m_next++;
+}
+
+void SlidingWindow::clear() noexcept
+{
+	m_minimum.clear();
+	m_maximum.clear();
+	m_count = 0;
+	m_mean = 0.0;
+	m_squares = 0.0;
+}
+
+std::size_t SlidingWindow::count() const noexcept
+{
+	return m_count;
+}
+
+double SlidingWindow::min() const noexcept
+{
+	return m_minimum.empty() ? 0.0 : value(m_minimum.front());
+}
+
+double SlidingWindow::max() const noexcept
+{
+	return m_maximum.empty() ? 0.0 : value(m_maximum.front());
+}
+
+double SlidingWindow::mean() const noexcept
+{
+	return m_mean;
+}
+
+double SlidingWindow::variance() const noexcept
+{
+	// Rounding errors of removing samples must not turn the variance negative
+	return (m_count > 0 && m_squares > 0.0) ? m_squares / m_count : 0.0;
+}
+
+double SlidingWindow::value(uint32_t sequence) const noexcept
+{
+	return m_values[sequence % m_values.size()];
+}
+
+// SlidingWindow::MonotonicQueue
+
+SlidingWindow::MonotonicQueue::MonotonicQueue(std::size_t capacity)
+	: m_sequences(capacity), m_front(0), m_size(0)
+{}
+
+void SlidingWindow::MonotonicQueue::clear() noexcept
+{
+	m_front = 0;
+	m_size = 0;
+}
+
+bool SlidingWindow::MonotonicQueue::empty() const noexcept
+{
+	return m_size == 0;
+}
+
+uint32_t SlidingWindow::MonotonicQueue::front() const noexcept
+{
+	return m_sequences[m_front];
+}
+
+uint32_t SlidingWindow::MonotonicQueue::back() const noexcept
+{
+	return m_sequences[(m_front + m_size - 1) % m_sequences.size()];
+}
+
+void SlidingWindow::MonotonicQueue::push_back(uint32_t sequence) noexcept
+{
+	m_sequences[(m_front + m_size) % m_sequences.size()] = sequence;
+	m_size++;
+}
+
+void SlidingWindow::MonotonicQueue::pop_back() noexcept
+{
+	m_size--;
+}
+
+void SlidingWindow::MonotonicQueue::pop_front() noexcept
+{
+	m_front = (m_front + 1) % m_sequences.size();
+	m_size--;
+}
+
+// DF_Aggregate
+
+DF_Aggregate::DF_Aggregate(const std::vector<std::string>& fields, std::size_t window, std::size_t step)
+	: m_fields(fields), m_windows(fields.size(), SlidingWindow(window)), m_window(window > 0 ? window : 1),
+	  m_step((step > 0 && step < m_window) ? step : m_window), m_received(0)
+{
+	// Adding input & output ports
+	m_ports.addInputPort("in");
+	m_ports.addOutputPort("out");
+}
+
+void DF_Aggregate::process()
+{
+	CO_BEGIN();
+
+	while(true) {
+
+		// Reading input message
+		CO_AWAIT_RECEIVE(m_ports["in"], m_message);
+
+		// Adding the numeric fields of the message to their windows
+		for(std::size_t i = 0; i < m_fields.size(); i++) {
+			double value = 0.0;
+			if(m_message.has_child(m_fields[i]) && m_message[m_fields[i]].get_number(value)) m_windows[i].add(value);
+		}
+
+		// Waiting for the rest of the step
+		if(++m_received < m_step) continue;
+		m_received = 0;
+
+		// Creating the summary of the windows, unless nobody consumes it
+		if(m_ports["out"].hasSubscribers()) {
+			m_message.clear();
+			for(std::size_t i = 0; i < m_fields.size(); i++) {
+				const SlidingWindow& window = m_windows[i];
+				Node& summary = m_message[m_fields[i]];
+
+				summary["count"]    = (double) window.count();
+				summary["min"]      = window.min();
+				summary["max"]      = window.max();
+				summary["mean"]     = window.mean();
+				summary["variance"] = window.variance();
+			}
+
+			m_ports["out"].send(m_message);
+		}
+
+		// Starting the next tumbling window empty
+		if(m_step == m_window) {
+			for(SlidingWindow& window : m_windows) window.clear();
+		}
+	}
+
+	CO_END();
+}
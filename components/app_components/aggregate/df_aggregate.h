@@ -0,0 +1,156 @@
+#pragma once
+#ifndef DATAFLOW_COMPONENTS_DF_AGGREGATE_H_INCLUDED
+#define DATAFLOW_COMPONENTS_DF_AGGREGATE_H_INCLUDED
+
+// Standard includes
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Project includes
+#include "dataflow.h"
+
+
+/**
+ * The SlidingWindow class keeps the statistics of the last samples of a value
+ * in a ring buffer. Adding a sample (and dropping the oldest one when the window
+ * is full) is O(1): the mean and the variance are updated incrementally with
+ * Welford's method, which stays accurate for large values with small variance
+ * (eg. air pressure in Pascals), and the minimum and the maximum are the fronts
+ * of two monotonic queues of the samples in the window.
+ */
+class SlidingWindow {
+public:
+
+	/**
+	 * Constructs an empty SlidingWindow.
+	 * @param capacity [in] The number of samples in a full window.
+	 */
+	explicit SlidingWindow(std::size_t capacity);
+
+	/**
+	 * Adds a sample to the window, dropping the oldest one when the window is full.
+	 * @param value [in] The value of the sample.
+	 */
+	void add(double value) noexcept;
+
+	/**
+	 * Removes all of the samples from the window.
+	 */
+	void clear() noexcept;
+
+	/**
+	 * Queries the number of samples in the window.
+	 * @return The number of samples, at most the capacity.
+	 */
+	std::size_t count() const noexcept;
+
+	/**
+	 * Queries the smallest sample in the window.
+	 * @return The smallest sample, zero when the window is empty.
+	 */
+	double min() const noexcept;
+
+	/**
+	 * Queries the largest sample in the window.
+	 * @return The largest sample, zero when the window is empty.
+	 */
+	double max() const noexcept;
+
+	/**
+	 * Queries the mean of the samples in the window.
+	 * @return The mean of the samples, zero when the window is empty.
+	 */
+	double mean() const noexcept;
+
+	/**
+	 * Queries the population variance of the samples in the window.
+	 * @return The variance of the samples, zero when the window is empty.
+	 */
+	double variance() const noexcept;
+
+private:
+
+	/**
+	 * The MonotonicQueue class implements a double-ended queue of the sequence numbers
+	 * of the samples which can still become the extremum of the window. It is stored
+	 * in a ring buffer of the capacity of the window, so it never allocates.
+	 */
+	class MonotonicQueue {
+	public:
+		explicit MonotonicQueue(std::size_t capacity);
+
+		// Operations of the double-ended queue, front() and back() require a non-empty queue
+		void     clear() noexcept;
+		bool     empty() const noexcept;
+		uint32_t front() const noexcept;
+		uint32_t back() const noexcept;
+		void     push_back(uint32_t sequence) noexcept;
+		void     pop_back() noexcept;
+		void     pop_front() noexcept;
+
+	private:
+		std::vector<uint32_t> m_sequences; /**< The ring buffer of the sequence numbers. */
+		std::size_t           m_front;     /**< The index of the front element.          */
+		std::size_t           m_size;      /**< The number of elements.                  */
+	};
+
+	/**
+	 * Queries the value of a sample in the window.
+	 * @param  sequence [in] The sequence number of the sample.
+	 * @return The value of the sample.
+	 */
+	double value(uint32_t sequence) const noexcept;
+
+	std::vector<double> m_values;  /**< The ring buffer of the samples.                    */
+	MonotonicQueue      m_minimum; /**< The candidates of the minimum, increasing values.   */
+	MonotonicQueue      m_maximum; /**< The candidates of the maximum, decreasing values.   */
+	uint32_t            m_next;    /**< The sequence number of the next sample.            */
+	std::size_t         m_count;   /**< The number of samples in the window.               */
+	double              m_mean;    /**< The running mean of the samples.                   */
+	double              m_squares; /**< The running sum of squared differences to the mean. */
+};
+
+/**
+ * This class implements windowed statistics over the numeric fields of the
+ * messages, eg. to upload a summary of the sensor readings instead of every raw
+ * reading. The windows are counted in messages: tumbling windows (step equal to
+ * the window) summarize each group of messages once, sliding windows (smaller
+ * step) summarize the last messages after every step. The component is
+ * cooperative and runs on a shared executor task of the Dataflow.
+ *
+ * Ports:
+ *
+ * [input] "in"   - Used to receive the messages to aggregate. Fields missing from
+ *                  a message or not holding a number are skipped for that message.
+ *
+ * [output] "out" - Used to send the summary of each window, which contains a child
+ *                  for each field with the "count", "min", "max", "mean" and
+ *                  "variance" of its values in the window (all of them doubles).
+ */
+class DF_Aggregate : public CooperativeComponent {
+public:
+
+	/**
+	 * Constructs a DF_Aggregate.
+	 * @param fields [in] The names of the numeric fields to aggregate.
+	 * @param window [in] The number of messages in a window.
+	 * @param step   [in] The number of messages between the summaries, zero for
+	 *                    tumbling windows (a summary after each whole window).
+	 */
+	DF_Aggregate(const std::vector<std::string>& fields, std::size_t window, std::size_t step = 0);
+
+	virtual void process() override;
+
+private:
+
+	std::vector<std::string>   m_fields;   /**< The names of the aggregated fields.           */
+	std::vector<SlidingWindow> m_windows;  /**< The window of each field.                     */
+	std::size_t                m_window;   /**< The number of messages in a window.           */
+	std::size_t                m_step;     /**< The number of messages between the summaries. */
+	std::size_t                m_received; /**< The messages received since the last summary. */
+	Node                       m_message;  /**< The message being processed.                  */
+};
+
+#endif // DATAFLOW_COMPONENTS_DF_AGGREGATE_H_INCLUDED
@@ -2,15 +2,22 @@
 #ifndef DATAFLOW_COMPONENTS_APP_COMPONENTS_H_INCLUDED
 #define DATAFLOW_COMPONENTS_APP_COMPONENTS_H_INCLUDED
 
+#include "aggregate/df_aggregate.h"
 #include "bme280/df_bme280.h"
+#include "combine/df_combine.h"
 #include "debounce/df_debounce.h"
 #include "debug/df_debug.h"
+#include "durable/df_durable_queue.h"
+#include "filter/df_filter.h"
 #include "function/df_function.h"
 #include "gpio/df_gpio.h"
 #include "interfaces/df_i2c_master.h"
 #include "interfaces/df_sdspi.h"
+#include "rate/df_rate.h"
+#include "router/df_router.h"
 #include "thingspeak/df_thingspeak_read.h"
 #include "thingspeak/df_thingspeak_write.h"
+#include "timers/df_ticker.h"
 #include "timers/df_watchdog.h"
 #include "wifi/df_wifi.h"
 
@@ -0,0 +1,162 @@
+#include "app_registry.h"
+#include "app_components.h"
+
+/**
+ * Converts the GPIO trigger type parameter to the corresponding enumeration.
+ * @param  trigger [in] The name of the trigger type.
+ * @return The trigger type, DISABLED for unknown names.
+ */
+static DF_GPIO::TriggerType triggerType(const std::string& trigger)
+{
+	if(trigger == "posedge") return DF_GPIO::TriggerType::POSEDGE;
+	if(trigger == "negedge") return DF_GPIO::TriggerType::NEGEDGE;
+	if(trigger == "anyedge") return DF_GPIO::TriggerType::ANYEDGE;
+	if(trigger == "low")     return DF_GPIO::TriggerType::LOW_LEVEL;
+	if(trigger == "high")    return DF_GPIO::TriggerType::HIGH_LEVEL;
+
+	return DF_GPIO::TriggerType::DISABLED;
+}
+
+/**
+ * Converts the GPIO pull mode parameter to the corresponding enumeration.
+ * @param  pull [in] The name of the pull mode.
+ * @return The pull mode, NONE for unknown names.
+ */
+static DF_GPIO::PullMode pullMode(const std::string& pull)
+{
+	if(pull == "up")   return DF_GPIO::PullMode::PULLUP;
+	if(pull == "down") return DF_GPIO::PullMode::PULLDOWN;
+
+	return DF_GPIO::PullMode::NONE;
+}
+
+void registerAppComponents(ComponentRegistry& registry)
+{
+	// Shorthands for reading parameters
+	auto number = &ComponentRegistry::getNumber;
+	auto string = &ComponentRegistry::getString;
+	auto strings = &ComponentRegistry::getStrings;
+	auto boolean = &ComponentRegistry::getBool;
+
+	// Reading the filter coefficients as single precision
+	auto numbers = [](const Node& p, const std::string& name) {
+		std::vector<double> values = ComponentRegistry::getNumbers(p, name);
+		return std::vector<float>(values.begin(), values.end());
+	};
+
+	registry.add<DF_Aggregate>("DF_Aggregate", [number, strings](const Node& p) {
+		return new DF_Aggregate(strings(p, "fields"), number(p, "window", 10), number(p, "step", 0));
+	});
+
+	registry.add<DF_BME280>("DF_BME280", [](const Node&) {
+		return new DF_BME280();
+	});
+
+	registry.add<DF_CombineLatest>("DF_CombineLatest", [strings, boolean](const Node& p) {
+		return new DF_CombineLatest(strings(p, "inputs"), boolean(p, "require_all", true));
+	});
+
+	registry.add<DF_Debounce>("DF_Debounce", [number](const Node& p) {
+		return new DF_Debounce(number(p, "debounce_ms", 50));
+	});
+
+	registry.add<DF_Debug>("DF_Debug", [](const Node&) {
+		return new DF_Debug();
+	});
+
+	registry.add<DF_DurableQueue>("DF_DurableQueue", [number, string](const Node& p) {
+		return new DF_DurableQueue(string(p, "path", ""), number(p, "capacity", 16), number(p, "batch", 8),
+				number(p, "flush_ms", 1000), number(p, "retry_ms", 20000));
+	});
+
+	registry.add<DF_EMA>("DF_EMA", [number, strings](const Node& p) {
+		return new DF_EMA(strings(p, "fields"), number(p, "alpha", 0.1));
+	});
+
+	registry.add<DF_FIR>("DF_FIR", [number, numbers, strings](const Node& p) {
+		return new DF_FIR(strings(p, "fields"), numbers(p, "taps"), number(p, "decimation", 1));
+	});
+
+	registry.add<DF_GPIO>("DF_GPIO", [number, string](const Node& p) {
+		return new DF_GPIO(number(p, "gpio", 0),
+				string(p, "direction", "input") == "output" ? DF_GPIO::Direction::OUTPUT : DF_GPIO::Direction::INPUT,
+				pullMode(string(p, "pull", "none")),
+				triggerType(string(p, "trigger", "disabled")));
+	});
+
+	registry.add<DF_I2C_Master>("DF_I2C_Master", [number](const Node& p) {
+		return new DF_I2C_Master(number(p, "port", 1), number(p, "scl_pin", 21),
+				number(p, "sda_pin", 22), number(p, "speed_hz", 100000));
+	});
+
+	registry.add<DF_IIR>("DF_IIR", [number, numbers, strings](const Node& p) {
+		return new DF_IIR(strings(p, "fields"), numbers(p, "coefficients"), number(p, "decimation", 1));
+	});
+
+	registry.add<DF_Join>("DF_Join", [number, string, strings](const Node& p) {
+		return new DF_Join(strings(p, "inputs"), string(p, "field", "timestamp"), number(p, "tolerance", 0),
+				number(p, "capacity", 8));
+	});
+
+	registry.add<DF_Kalman>("DF_Kalman", [number, strings](const Node& p) {
+		return new DF_Kalman(strings(p, "fields"), number(p, "process_noise", 0.01), number(p, "measurement_noise", 1));
+	});
+
+	registry.add<DF_Median>("DF_Median", [number, strings](const Node& p) {
+		return new DF_Median(strings(p, "fields"), number(p, "window", 5));
+	});
+
+	registry.add<DF_RateLimit>("DF_RateLimit", [number](const Node& p) {
+		return new DF_RateLimit(number(p, "interval_ms", 1000), number(p, "burst", 1));
+	});
+
+	registry.add<DF_Router>("DF_Router", [](const Node& p) {
+		DF_Router* router = new DF_Router();
+		if(p.has_child("routes")) {
+			for(const Node* route = p["routes"].first_child(); route != nullptr; route = route->next_sibling()) router->route(*route);
+		}
+		return router;
+	});
+
+	registry.add<DF_SDSPI>("DF_SDSPI", [number](const Node& p) {
+		return new DF_SDSPI(number(p, "miso_pin", 13), number(p, "mosi_pin", 14),
+				number(p, "sck_pin", 15), number(p, "cs_pin", 12));
+	});
+
+	registry.add<DF_SampleHold>("DF_SampleHold", [number](const Node& p) {
+		return new DF_SampleHold(number(p, "period_ms", 1000));
+	});
+
+	registry.add<DF_ThingspeakRead>("DF_ThingspeakRead", [number, string](const Node& p) {
+		return new DF_ThingspeakRead(number(p, "channel_id", 0), number(p, "field_id", 1),
+				string(p, "read_key", ""));
+	});
+
+	registry.add<DF_ThingspeakWrite>("DF_ThingspeakWrite", [string](const Node& p) {
+		return new DF_ThingspeakWrite(string(p, "write_key", ""));
+	});
+
+	registry.add<DF_Throttle>("DF_Throttle", [number](const Node& p) {
+		return new DF_Throttle(number(p, "window_ms", 15000));
+	});
+
+	registry.add<DF_Ticker>("DF_Ticker", [number](const Node& p) {
+		return new DF_Ticker(number(p, "period_ms", 1000), number(p, "phase_ms", 0));
+	});
+
+	registry.add<DF_TrailingDebounce>("DF_TrailingDebounce", [number](const Node& p) {
+		return new DF_TrailingDebounce(number(p, "window_ms", 50));
+	});
+
+	registry.add<DF_Watchdog>("DF_Watchdog", [number](const Node& p) {
+		return new DF_Watchdog(number(p, "period_ms", 10000));
+	});
+
+	registry.add<DF_WifiConnect>("DF_WifiConnect", [string](const Node& p) {
+		return new DF_WifiConnect(string(p, "ssid", ""), string(p, "password", ""));
+	});
+
+	registry.add<DF_Zip>("DF_Zip", [number, strings](const Node& p) {
+		return new DF_Zip(strings(p, "inputs"), number(p, "capacity", 8));
+	});
+}
@@ -0,0 +1,53 @@
+#pragma once
+#ifndef DATAFLOW_COMPONENTS_APP_REGISTRY_H_INCLUDED
+#define DATAFLOW_COMPONENTS_APP_REGISTRY_H_INCLUDED
+
+// Project includes
+#include "registry.h"
+
+
+/**
+ * Registers the application components to the specified registry, so they can
+ * be used in graph descriptions loaded by the GraphLoader. The type names are
+ * identical to the class names. The DF_Function component is not registered,
+ * as its behaviour is defined by code, the application should register its own
+ * function components with dedicated type names instead.
+ *
+ * Parameters (numbers unless noted otherwise):
+ *
+ * "DF_Aggregate"        - "fields" (string array), "window", "step"
+ * "DF_BME280"           - none
+ * "DF_CombineLatest"    - "inputs" (string array), "require_all" (bool)
+ * "DF_Debounce"         - "debounce_ms"
+ * "DF_Debug"            - none
+ * "DF_DurableQueue"     - "path" (string, empty for RTC memory), "capacity", "batch", "flush_ms", "retry_ms"
+ * "DF_EMA"              - "fields" (string array), "alpha"
+ * "DF_FIR"              - "fields" (string array), "taps" (number array), "decimation"
+ * "DF_GPIO"             - "gpio", "direction" ("input"/"output"), "pull" ("up"/"down"/"none"),
+ *                         "trigger" ("disabled"/"posedge"/"negedge"/"anyedge"/"low"/"high")
+ * "DF_I2C_Master"       - "port", "scl_pin", "sda_pin", "speed_hz"
+ * "DF_IIR"              - "fields" (string array), "coefficients" (number array, 5 per biquad section),
+ *                         "decimation"
+ * "DF_Join"             - "inputs" (string array), "field" (string), "tolerance", "capacity"
+ * "DF_Kalman"           - "fields" (string array), "process_noise", "measurement_noise"
+ * "DF_Median"           - "fields" (string array), "window"
+ * "DF_RateLimit"        - "interval_ms", "burst"
+ * "DF_Router"           - "routes" (array of rules, see DF_Router::route()), each with "output" (string)
+ *                         and optionally "has" (string array), "type" (string), "types" (child names to
+ *                         type names) and "ranges" (child names to [min, max] arrays)
+ * "DF_SampleHold"       - "period_ms"
+ * "DF_SDSPI"            - "miso_pin", "mosi_pin", "sck_pin", "cs_pin"
+ * "DF_ThingspeakRead"   - "channel_id", "field_id", "read_key" (string)
+ * "DF_ThingspeakWrite"  - "write_key" (string)
+ * "DF_Throttle"         - "window_ms"
+ * "DF_Ticker"           - "period_ms", "phase_ms"
+ * "DF_TrailingDebounce" - "window_ms"
+ * "DF_Watchdog"         - "period_ms"
+ * "DF_WifiConnect"      - "ssid" (string), "password" (string)
+ * "DF_Zip"              - "inputs" (string array), "capacity"
+ *
+ * @param registry [in] The registry to add the application components to.
+ */
+void registerAppComponents(ComponentRegistry& registry);
+
+#endif // DATAFLOW_COMPONENTS_APP_REGISTRY_H_INCLUDED
@@ -1,12 +1,21 @@
 #include "df_bme280.h"
 
+// Standard includes
+#include <cstring>
+
 DF_BME280::DF_BME280()
+	: m_calibrated(false), m_mutex(xSemaphoreCreateMutex())
 {
 	m_ports.addInputPort("in");
 	m_ports.addInputPort("interface");
 	m_ports.addOutputPort("out");
 }
 
+DF_BME280::~DF_BME280()
+{
+	vSemaphoreDelete(m_mutex);
+}
+
 void DF_BME280::process()
 {
 	// Node object to read messages
@@ -18,8 +27,14 @@ void DF_BME280::process()
 	// Setting up the driver interface for the sensor
 	setDriverInterface((DriverInterface*) message);
 
-	// Initializing the sensor
-	initialize();
+	// Initializing the sensor, calibration constants restored from a snapshot are reused
+	xSemaphoreTake(m_mutex, portMAX_DELAY);
+	if(!m_calibrated) {
+		readCalibration();
+		m_calibrated = true;
+	}
+	configure();
+	xSemaphoreGive(m_mutex);
 
 	// Reading messages from the IN port
 	while(true) {
@@ -27,19 +42,46 @@ void DF_BME280::process()
 		// Receiving message from the IN port
 		m_ports["in"].receive(message);
 
+		// Skipping the measurement when nobody consumes it
+		if(!m_ports["out"].hasSubscribers()) continue;
+
 		// Starting the measurements
 		set_mode(BME280::Mode::Forced);
 
 		// Waiting for the measurements to finish
 		vTaskDelay((get_measurement_delay_ms() + 100) / portTICK_RATE_MS);
 
-		// Creating output message
+		// Creating output message, the compensation updates the calibration data
 		message.clear();
+		xSemaphoreTake(m_mutex, portMAX_DELAY);
 		message["temperature"] = (double) get_temperature();
 		message["pressure"]    = (double) get_pressure();
 		message["humidity"]    = (double) get_humidity();
+		xSemaphoreGive(m_mutex);
 
 		// Sending the measurement data to the output port
 		m_ports["out"].send(message);
 	}
 }
+
+std::size_t DF_BME280::saveState(uint8_t* buffer, std::size_t size)
+{
+	// Checking if there is anything to save and enough space to save it
+	xSemaphoreTake(m_mutex, portMAX_DELAY);
+	std::size_t saved = (m_calibrated && size >= sizeof(m_calibration)) ? sizeof(m_calibration) : 0;
+
+	// Copying the calibration constants, while the task of the component does not modify them
+	if(saved != 0) memcpy(buffer, &m_calibration, sizeof(m_calibration));
+	xSemaphoreGive(m_mutex);
+
+	return saved;
+}
+
+void DF_BME280::restoreState(const uint8_t* buffer, std::size_t size)
+{
+	// Checking if the saved state has the expected layout
+	if(size != sizeof(m_calibration)) return;
+
+	memcpy(&m_calibration, buffer, sizeof(m_calibration));
+	m_calibrated = true;
+}
@@ -2,6 +2,10 @@
 #ifndef DATAFLOW_COMPONENTS_DF_BME280_H_INCLUDED
 #define DATAFLOW_COMPONENTS_DF_BME280_H_INCLUDED
 
+// FreeRTOS includes
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
 // Project includes
 #include "dataflow.h"
 #include "bme280.h"
@@ -25,6 +29,10 @@
  * [output] "out"      - Used to send out the measured temperature, pressure and
  *                       humidity values. The output message contains the "temperature",
  *                       "pressure" and "humidity" fields, which are of type double.
+ *
+ * The calibration constants of the sensor are saved into the graph snapshot, so
+ * they are not read again from the device after waking up from deep sleep. The
+ * snapshot may be saved while the component is running.
  */
 class DF_BME280 : public BME280, public Component {
 public:
@@ -34,10 +42,35 @@ public:
 	 */
 	DF_BME280();
 
+	/**
+	 * Destroys the DF_BME280.
+	 */
+	~DF_BME280();
+
 	/**
 	 *
 	 */
 	virtual void process() override;
+
+	/**
+	 * Saves the calibration constants of the sensor into the snapshot.
+	 * @param  buffer [out] The buffer to write the state into.
+	 * @param  size   [in]  The available size of the buffer in bytes.
+	 * @return The number of bytes written, zero when there is no state to save.
+	 */
+	virtual std::size_t saveState(uint8_t* buffer, std::size_t size) override;
+
+	/**
+	 * Restores the calibration constants of the sensor from the snapshot.
+	 * @param buffer [in] The buffer containing the saved state.
+	 * @param size   [in] The size of the saved state in bytes.
+	 */
+	virtual void restoreState(const uint8_t* buffer, std::size_t size) override;
+
+private:
+
+	bool              m_calibrated; /**< Whether the calibration constants are known.          */
+	SemaphoreHandle_t m_mutex;      /**< The mutex guarding the calibration against snapshots. */
 };
 
 #endif // DATAFLOW_COMPONENTS_DF_BME280_H_INCLUDED
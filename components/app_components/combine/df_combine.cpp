@@ -0,0 +1,163 @@
+#include "df_combine.h"
+
+// DF_Combiner
+
+DF_Combiner::DF_Combiner(const std::vector<std::string>& inputs, std::size_t capacity)
+	: m_inputs(inputs), m_buffers(inputs.size()), m_capacity(capacity > 0 ? capacity : 1), m_dropped(0), m_merged("merged")
+{
+	// Adding an input port for each stream
+	for(const std::string& input : m_inputs) m_ports.addInputPort(input);
+	m_ports.addOutputPort("out");
+
+	// Looking up the input ports once, the ports are not moved by adding others
+	for(const std::string& input : m_inputs) m_receivers.push_back(&m_ports[input]);
+}
+
+void DF_Combiner::process()
+{
+	// Receiving a message from each input which has one, the executor keeps
+	// resuming the component while any of them has messages
+	for(std::size_t i = 0; i < m_receivers.size(); i++) {
+		if(!m_receivers[i]->receive(m_message, 0)) continue;
+
+		m_progressed = true;
+		accept(i, m_message);
+	}
+}
+
+std::size_t DF_Combiner::dropped() const noexcept
+{
+	return m_dropped;
+}
+
+void DF_Combiner::buffer(std::size_t input, const Node& message)
+{
+	std::deque<Node>& buffer = m_buffers[input];
+
+	// Dropping the oldest message of a full buffer
+	if(buffer.size() >= m_capacity) {
+		buffer.pop_front();
+		m_dropped++;
+	}
+
+	buffer.push_back(message);
+}
+
+void DF_Combiner::emitFronts()
+{
+	m_merged.clear();
+
+	// Merging and removing the front messages
+	for(std::size_t i = 0; i < m_buffers.size(); i++) {
+		merge(i, m_buffers[i].front());
+		m_buffers[i].pop_front();
+	}
+
+	m_ports["out"].send(m_merged);
+}
+
+void DF_Combiner::merge(std::size_t input, const Node& message)
+{
+	// Copying the message shares its children, the child keeps the name of the input
+	Node& child = m_merged[m_inputs[input]];
+	child = message;
+	child.name() = m_inputs[input];
+}
+
+// DF_Zip
+
+DF_Zip::DF_Zip(const std::vector<std::string>& inputs, std::size_t capacity)
+	: DF_Combiner(inputs, capacity)
+{}
+
+void DF_Zip::accept(std::size_t input, const Node& message)
+{
+	buffer(input, message);
+
+	// Waiting until every input has a message
+	for(const std::deque<Node>& buffer : m_buffers) {
+		if(buffer.empty()) return;
+	}
+
+	emitFronts();
+}
+
+// DF_CombineLatest
+
+DF_CombineLatest::DF_CombineLatest(const std::vector<std::string>& inputs, bool requireAll)
+	: DF_Combiner(inputs, 1), m_requireAll(requireAll)
+{}
+
+void DF_CombineLatest::accept(std::size_t input, const Node& message)
+{
+	// Replacing the latest message of the input
+	m_buffers[input].clear();
+	m_buffers[input].push_back(message);
+
+	// Waiting for the first message of every input when required
+	if(m_requireAll) {
+		for(const std::deque<Node>& buffer : m_buffers) {
+			if(buffer.empty()) return;
+		}
+	}
+
+	// Merging the latest messages, which are kept for the next update
+	m_merged.clear();
+	for(std::size_t i = 0; i < m_buffers.size(); i++) {
+		if(!m_buffers[i].empty()) merge(i, m_buffers[i].front());
+	}
+
+	m_ports["out"].send(m_merged);
+}
+
+// DF_Join
+
+DF_Join::DF_Join(const std::vector<std::string>& inputs, const std::string& field, double tolerance, std::size_t capacity)
+	: DF_Combiner(inputs, capacity), m_field(field), m_tolerance(tolerance)
+{}
+
+void DF_Join::accept(std::size_t input, const Node& message)
+{
+	// Dropping the messages which can not be aligned
+	double time = 0.0;
+	if(!timestamp(message, time)) {
+		m_dropped++;
+		return;
+	}
+
+	buffer(input, message);
+
+	while(true) {
+
+		// Waiting until every input has a message
+		double newest = 0.0;
+		for(std::size_t i = 0; i < m_buffers.size(); i++) {
+			if(m_buffers[i].empty()) return;
+
+			timestamp(m_buffers[i].front(), time);
+			if(i == 0 || time > newest) newest = time;
+		}
+
+		// Dropping the front messages too old to match the newest one, as the
+		// following messages of the same input can only match newer ones
+		bool aligned = true;
+		for(std::deque<Node>& buffer : m_buffers) {
+			timestamp(buffer.front(), time);
+
+			if(time < newest - m_tolerance) {
+				buffer.pop_front();
+				m_dropped++;
+				aligned = false;
+			}
+		}
+
+		// Merging the front messages, which are within the tolerance
+		if(aligned) emitFronts();
+	}
+}
+
+bool DF_Join::timestamp(const Node& message, double& timestamp) const noexcept
+{
+	// Accepting timestamps of any numeric type (eg. integer epoch times)
+	return message.has_child(m_field) && message[m_field].get_number(timestamp);
+}
@@ -0,0 +1,165 @@
+#pragma once
+#ifndef DATAFLOW_COMPONENTS_DF_COMBINE_H_INCLUDED
+#define DATAFLOW_COMPONENTS_DF_COMBINE_H_INCLUDED
+
+// Standard includes
+#include <deque>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Project includes
+#include "dataflow.h"
+
+
+/**
+ * This class implements the common part of the components merging several streams
+ * of messages into one, so the consumers receive merged messages instead of checking
+ * which stream each message belongs to. The combiners are cooperative and run on a
+ * shared executor task of the Dataflow, receiving from whichever input has messages.
+ *
+ * Ports:
+ *
+ * [input] <inputs> - An input port for each stream, named by the constructor.
+ *
+ * [output] "out"   - Used to send the merged messages, which contain a child for each
+ *                    input named after its port, holding the message of that stream.
+ *
+ * The buffers of the combiners are bounded: when a stream runs ahead of the others,
+ * its oldest buffered messages are dropped and counted (see dropped()).
+ */
+class DF_Combiner : public CooperativeComponent {
+public:
+
+	virtual void process() override;
+
+	/**
+	 * Queries the number of messages dropped from the buffers.
+	 * @return The number of messages dropped.
+	 */
+	std::size_t dropped() const noexcept;
+
+protected:
+
+	/**
+	 * Constructs a DF_Combiner.
+	 * @param inputs   [in] The names of the input ports.
+	 * @param capacity [in] The number of messages buffered per input.
+	 */
+	DF_Combiner(const std::vector<std::string>& inputs, std::size_t capacity);
+
+	/**
+	 * Handles a message received on an input port.
+	 * @param input   [in] The index of the input port.
+	 * @param message [in] The message received.
+	 */
+	virtual void accept(std::size_t input, const Node& message) = 0;
+
+	/**
+	 * Appends a message to the buffer of an input, dropping the oldest message
+	 * when the buffer is full.
+	 * @param input   [in] The index of the input.
+	 * @param message [in] The message to buffer.
+	 */
+	void buffer(std::size_t input, const Node& message);
+
+	/**
+	 * Sends a merged message of the front messages of the buffers, which are removed.
+	 */
+	void emitFronts();
+
+	/**
+	 * Adds the message of an input to the merged message.
+	 * @param input   [in] The index of the input.
+	 * @param message [in] The message of the input.
+	 */
+	void merge(std::size_t input, const Node& message);
+
+	std::vector<std::string>      m_inputs;    /**< The names of the input ports.               */
+	std::vector<Port*>            m_receivers; /**< The input ports, in the order of the names. */
+	std::vector<std::deque<Node>> m_buffers;   /**< The buffered messages of each input.        */
+	std::size_t                   m_capacity;  /**< The number of messages buffered per input.  */
+	std::size_t                   m_dropped;   /**< The number of messages dropped.             */
+	Node                          m_message;   /**< The message being received.                 */
+	Node                          m_merged;    /**< The merged message being sent.              */
+};
+
+/**
+ * This class pairs the messages of the inputs by their order: the Nth message of
+ * each input is merged into the Nth output message, once every input has sent it.
+ */
+class DF_Zip : public DF_Combiner {
+public:
+
+	/**
+	 * Constructs a DF_Zip.
+	 * @param inputs   [in] The names of the input ports.
+	 * @param capacity [in] The number of messages buffered per input.
+	 */
+	DF_Zip(const std::vector<std::string>& inputs, std::size_t capacity = 8);
+
+protected:
+	virtual void accept(std::size_t input, const Node& message) override;
+};
+
+/**
+ * This class merges the latest message of each input whenever any of them sends
+ * a new one, eg. to redraw a display from the latest readings of several sources.
+ */
+class DF_CombineLatest : public DF_Combiner {
+public:
+
+	/**
+	 * Constructs a DF_CombineLatest.
+	 * @param inputs     [in] The names of the input ports.
+	 * @param requireAll [in] Whether to wait for a message from every input before the
+	 *                        first merged message, otherwise the inputs without messages
+	 *                        are left out of the merged messages.
+	 */
+	DF_CombineLatest(const std::vector<std::string>& inputs, bool requireAll = true);
+
+protected:
+	virtual void accept(std::size_t input, const Node& message) override;
+
+private:
+	bool m_requireAll; /**< Whether every input has to send a message first. */
+};
+
+/**
+ * This class merges the messages of the inputs with matching timestamps. The streams
+ * must be ordered by their timestamps, which are read from a numeric field of the
+ * messages. Messages are merged when their timestamps are within the tolerance of
+ * each other, messages older than the tolerance compared to the newest front message
+ * can not be matched anymore and are dropped (just like messages without timestamps).
+ */
+class DF_Join : public DF_Combiner {
+public:
+
+	/**
+	 * Constructs a DF_Join.
+	 * @param inputs    [in] The names of the input ports.
+	 * @param field     [in] The name of the field holding the timestamp of the messages.
+	 * @param tolerance [in] The largest difference of the timestamps of merged messages.
+	 * @param capacity  [in] The number of messages buffered per input.
+	 */
+	DF_Join(const std::vector<std::string>& inputs, const std::string& field = "timestamp",
+			double tolerance = 0.0, std::size_t capacity = 8);
+
+protected:
+	virtual void accept(std::size_t input, const Node& message) override;
+
+private:
+
+	/**
+	 * Reads the timestamp of a message.
+	 * @param  message   [in]  The message to read.
+	 * @param  timestamp [out] The timestamp of the message.
+	 * @return True when the message has a numeric timestamp.
+	 */
+	bool timestamp(const Node& message, double& timestamp) const noexcept;
+
+	std::string m_field;     /**< The name of the timestamp field.            */
+	double      m_tolerance; /**< The largest difference of timestamps merged. */
+};
+
+#endif // DATAFLOW_COMPONENTS_DF_COMBINE_H_INCLUDED
@@ -10,23 +10,24 @@ DF_Debounce::DF_Debounce(uint8_t debounce_ms)
 
 void DF_Debounce::process()
 {
+	CO_BEGIN();
+
 	// Reading input messages indefinitely
 	while(true) {
 
-		// Node object to receive messages
-		Node message;
-
 		// Reading input message
-		m_ports["in"].receive(message);
+		CO_AWAIT_RECEIVE(m_ports["in"], m_message);
 
 		// Checking if the debounce time has elapsed
 		if((xTaskGetTickCount() - m_lastDebounced) > pdMS_TO_TICKS(m_debounce_ms)) {
 
 			// Forwarding the message to the output port
-			m_ports["out"].send(message);
+			m_ports["out"].send(m_message);
 
 			// Resetting the debounce timing
 			m_lastDebounced = xTaskGetTickCount();
 		}
 	}
+
+	CO_END();
 }
@@ -4,7 +4,7 @@
 
 #include "dataflow.h"
 
-class DF_Debounce : public Component {
+class DF_Debounce : public CooperativeComponent {
 public:
 
 	DF_Debounce(uint8_t debounce_ms);
@@ -12,6 +12,7 @@ public:
 	virtual void process() override;
 
 private:
+	Node     m_message;
 	uint64_t m_lastDebounced;
 	uint8_t  m_debounce_ms;
 };
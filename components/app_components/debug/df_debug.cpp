@@ -8,22 +8,30 @@ DF_Debug::DF_Debug()
 
 void DF_Debug::process()
 {
-	while(true) {
+	CO_BEGIN();
 
-		// Node object for reading messages
-		Node message;
+	while(true) {
 
 		// Reading message from the input port
-		m_ports["in"].receive(message);
+		CO_AWAIT_RECEIVE(m_ports["in"], m_message);
 
 		// Printing the message
-		for(auto it = message.begin(); it != message.end(); it++) {
-			std::cout << std::string(it.level(), ' ') << it->name() << ": " << *it << std::endl;
-		}
+		print(m_message, 0);
 
-		// Writing to the output port if it is connected
-		if(m_ports["out"].isConnected()) {
-			m_ports["out"].send(message);
+		// Writing to the output port if anything consumes it
+		if(m_ports["out"].hasSubscribers()) {
+			m_ports["out"].send(m_message);
 		}
 	}
+
+	CO_END();
+}
+
+void DF_Debug::print(const Node& node, std::size_t level)
+{
+	std::cout << std::string(level, ' ') << node.name() << ": " << node << std::endl;
+
+	for(const Node* child = node.first_child(); child != nullptr; child = child->next_sibling()) {
+		print(*child, level + 1);
+	}
 }
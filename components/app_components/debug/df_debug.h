@@ -4,6 +4,7 @@
 
 // Standard includes
 #include <string>
+#include <cstddef>
 
 // Project includes
 #include "dataflow.h"
@@ -11,7 +12,8 @@
 
 /**
  * This class implements a generic debugging facility which prints
- * the messages it receives to the standard output.
+ * the messages it receives to the standard output. The component is
+ * cooperative and runs on a shared executor task of the Dataflow.
  *
  * Ports:
  *
@@ -22,12 +24,24 @@
  *                  to this port after being printed. Otherwise the messages are
  *                  dropped.
  */
-class DF_Debug : public Component {
+class DF_Debug : public CooperativeComponent {
 public:
 
 	DF_Debug();
 
 	virtual void process() override;
+
+private:
+
+	/**
+	 * Prints a Node and its children, indented by their depth. The message is
+	 * only read, so the children shared with the sender are not copied.
+	 * @param node  [in] The Node to print.
+	 * @param level [in] The depth of the Node in the message.
+	 */
+	static void print(const Node& node, std::size_t level);
+
+	Node m_message; /**< The message being processed. */
 };
 
 
@@ -0,0 +1,426 @@
+#include "df_durable_queue.h"
+
+// Standard includes
+#include <cstdio>
+#include <cstring>
+
+// ESP-IDF includes
+#include "esp_log.h"
+
+// Project includes
+#include "serializer.h"
+#include "snapshot.h"
+
+// The size of the header of the journal records: type, length and checksum
+static const std::size_t RECORD_HEADER = 9;
+
+// The child of the messages sent carrying their sequence id
+static const std::string SEQUENCE = "queue_sequence";
+
+static void putU32(uint8_t* buffer, uint32_t value)
+{
+	for(std::size_t i = 0; i < 4; i++) buffer[i] = (uint8_t) (value >> (8 * i));
+}
+
+static uint32_t getU32(const uint8_t* buffer)
+{
+	return buffer[0] | (buffer[1] << 8) | (buffer[2] << 16) | ((uint32_t) buffer[3] << 24);
+}
+
+DF_DurableQueue::DF_DurableQueue(const std::string& path, std::size_t capacity, std::size_t batch,
+		uint32_t flush_ms, uint32_t retry_ms)
+	: m_path(path), m_capacity(capacity > 0 ? capacity : 1), m_batch(batch > 0 ? batch : 1),
+	  m_flush(pdMS_TO_TICKS(flush_ms) > 0 ? pdMS_TO_TICKS(flush_ms) : 1),
+	  m_retry(pdMS_TO_TICKS(retry_ms) > 0 ? pdMS_TO_TICKS(retry_ms) : 1),
+	  m_sequence(0), m_generation(0), m_pending(0), m_records(0), m_dropped(0), m_loaded(false), m_inflight(false),
+	  m_mutex(xSemaphoreCreateMutex())
+{
+	// Adding input & output ports, the timer port only needs room for a few expirations
+	m_ports.addInputPort("in");
+	m_ports.addInputPort("ack");
+	m_ports.addInputPort("timer", 2);
+	m_ports.addOutputPort("out");
+
+	// Both Timers expire to the timer port, told apart by the name of their message
+	// (the retry Timer is targeted when started, see startRetry())
+	m_ports["timer"].setInternal(true);
+	m_flushTimer.setTarget(m_ports["timer"], Node("flush"));
+}
+
+DF_DurableQueue::~DF_DurableQueue()
+{
+	m_flushTimer.stop();
+	m_retryTimer.stop();
+
+	flush();
+	vSemaphoreDelete(m_mutex);
+}
+
+void DF_DurableQueue::process()
+{
+	// Rebuilding the queue from the journal when started, the file system is mounted by now
+	if(!m_loaded) {
+		xSemaphoreTake(m_mutex, portMAX_DELAY);
+		if(!m_path.empty()) replay();
+		m_loaded = true;
+		xSemaphoreGive(m_mutex);
+
+		m_progressed = true;
+		deliver();
+	}
+
+	// Handling the expirations first, so they are not delayed by a burst of messages
+	if(m_ports["timer"].receive(m_message, 0)) {
+		m_progressed = true;
+
+		if(m_message.name() == "flush") flush();
+		else if(m_message.get<uint32_t>() != nullptr && *m_message.get<uint32_t>() == m_generation) {
+			// Sending the head again, its acknowledgement is overdue or it did not fit the output.
+			// Expirations of the previous starts of the retry Timer are ignored
+			m_inflight = false;
+			deliver();
+		}
+	}
+
+	// Removing the head acknowledged by its sequence id, the acknowledgements of duplicates sent by a retry are ignored
+	if(m_ports["ack"].receive(m_message, 0)) {
+		m_progressed = true;
+
+		double sequence = -1;
+		if(m_message.has_child(SEQUENCE)) m_message[SEQUENCE].get_number(sequence);
+
+		xSemaphoreTake(m_mutex, portMAX_DELAY);
+		bool acknowledged = !m_ids.empty() && sequence == m_ids.front();
+		if(acknowledged) pop();
+		xSemaphoreGive(m_mutex);
+
+		if(acknowledged) {
+			m_inflight = false;
+			stopRetry();
+			deliver();
+		}
+	}
+
+	if(m_ports["in"].receive(m_message, 0)) {
+		m_progressed = true;
+
+		// Dropping the messages arriving at a full queue, and those too deep to be encoded
+		xSemaphoreTake(m_mutex, portMAX_DELAY);
+		if(m_queue.size() < m_capacity && NodeSerializer::serializedSize(m_message) != 0) push(m_message);
+		else m_dropped++;
+		xSemaphoreGive(m_mutex);
+
+		deliver();
+	}
+}
+
+std::size_t DF_DurableQueue::saveState(uint8_t* buffer, std::size_t size)
+{
+	xSemaphoreTake(m_mutex, portMAX_DELAY);
+
+	// Writing the pending changes in file mode, nothing goes into the snapshot
+	if(!m_path.empty()) {
+		write();
+		xSemaphoreGive(m_mutex);
+		return 0;
+	}
+
+	// Saving the messages as [length][message] records, while they fit
+	std::size_t offset = 0;
+	std::size_t saved = 0;
+
+	for(const Node& message : m_queue) {
+		std::size_t length = NodeSerializer::serializedSize(message);
+		if(offset + 4 + length > size) break;
+
+		putU32(buffer + offset, length);
+		NodeSerializer::serialize(message, buffer + offset + 4, length);
+		offset += 4 + length;
+		saved++;
+	}
+
+	if(saved < m_queue.size()) {
+		ESP_LOGW("DATAFLOW", "Durable queue saved %u of %u messages, the rest does not fit the snapshot.",
+				(unsigned) saved, (unsigned) m_queue.size());
+	}
+
+	xSemaphoreGive(m_mutex);
+	return offset;
+}
+
+void DF_DurableQueue::restoreState(const uint8_t* buffer, std::size_t size)
+{
+	xSemaphoreTake(m_mutex, portMAX_DELAY);
+
+	// Loading the saved messages in front of the ones received so far
+	std::deque<Node> restored;
+	std::size_t offset = 0;
+
+	while(offset + 4 <= size && restored.size() < m_capacity) {
+		std::size_t length = getU32(buffer + offset);
+		if(length > size - offset - 4) break;
+
+		Node message;
+		if(NodeSerializer::deserialize(buffer + offset + 4, length, message) != length) break;
+
+		restored.push_back(std::move(message));
+		offset += 4 + length;
+	}
+
+	while(!m_queue.empty() && restored.size() < m_capacity) {
+		restored.push_back(std::move(m_queue.front()));
+		m_queue.pop_front();
+	}
+
+	m_queue.swap(restored);
+	renumber();
+	xSemaphoreGive(m_mutex);
+}
+
+bool DF_DurableQueue::flush()
+{
+	xSemaphoreTake(m_mutex, portMAX_DELAY);
+	bool status = write();
+	xSemaphoreGive(m_mutex);
+
+	return status;
+}
+
+std::size_t DF_DurableQueue::size() const
+{
+	xSemaphoreTake(m_mutex, portMAX_DELAY);
+	std::size_t size = m_queue.size();
+	xSemaphoreGive(m_mutex);
+
+	return size;
+}
+
+std::size_t DF_DurableQueue::dropped() const noexcept
+{
+	return m_dropped;
+}
+
+void DF_DurableQueue::push(const Node& message)
+{
+	m_queue.push_back(message);
+	m_ids.push_back(m_sequence++);
+	journal(RECORD_PUSH, &m_queue.back());
+}
+
+void DF_DurableQueue::pop()
+{
+	if(m_queue.empty()) return;
+
+	m_queue.pop_front();
+	m_ids.pop_front();
+	journal(RECORD_POP, nullptr);
+}
+
+void DF_DurableQueue::deliver()
+{
+	while(!m_inflight) {
+		xSemaphoreTake(m_mutex, portMAX_DELAY);
+
+		if(m_queue.empty()) {
+			xSemaphoreGive(m_mutex);
+			return;
+		}
+
+		// Sending a copy of the head with its sequence id, sharing the children of the message
+		Node message = m_queue.front();
+		message[SEQUENCE] = (double) m_ids.front();
+
+		// Trying again later when the receiver is busy, the flow must not block on it
+		if(!m_ports["out"].send(message, 0)) {
+			xSemaphoreGive(m_mutex);
+			if(!m_retryTimer.active()) startRetry();
+			return;
+		}
+
+		// Keeping the head until it is acknowledged, or removing it right away
+		if(m_ports["ack"].isConnected()) {
+			m_inflight = true;
+			startRetry();
+		}
+		else pop();
+
+		xSemaphoreGive(m_mutex);
+	}
+}
+
+void DF_DurableQueue::renumber()
+{
+	m_ids.clear();
+	for(std::size_t i = 0; i < m_queue.size(); i++) m_ids.push_back(m_sequence++);
+}
+
+void DF_DurableQueue::startRetry()
+{
+	// The stopped Timer is not used by the timer service, so its message can be replaced
+	stopRetry();
+
+	Node message("retry");
+	message = m_generation;
+	m_retryTimer.setTarget(m_ports["timer"], message);
+
+	m_retryTimer.start(m_retry);
+}
+
+void DF_DurableQueue::stopRetry()
+{
+	// The expirations sent before stopping have the previous generation
+	m_retryTimer.stop();
+	m_generation++;
+}
+
+void DF_DurableQueue::journal(uint8_t type, const Node* message)
+{
+	if(m_path.empty()) return;
+
+	// Encoding the record after the pending ones
+	std::size_t length = (message != nullptr) ? NodeSerializer::serializedSize(*message) : 0;
+	std::size_t offset = m_changes.size();
+	m_changes.resize(offset + RECORD_HEADER + length);
+
+	uint8_t* record = m_changes.data() + offset;
+	if(message != nullptr) NodeSerializer::serialize(*message, record + RECORD_HEADER, length);
+
+	record[0] = type;
+	putU32(record + 1, length);
+	putU32(record + 5, SnapshotStorage::checksum(record + RECORD_HEADER, length));
+
+	// Writing full batches, the first change of a batch starts its deadline
+	if(++m_pending >= m_batch) {
+		m_flushTimer.stop();
+		write();
+	}
+	else if(m_pending == 1) m_flushTimer.start(m_flush);
+}
+
+bool DF_DurableQueue::write()
+{
+	// Appending after the replayed records only, they would be overwritten otherwise
+	if(m_path.empty() || m_pending == 0) return true;
+	if(!m_loaded) return false;
+
+	// An emptied queue needs no journal at all
+	if(m_queue.empty()) {
+		std::remove(m_path.c_str());
+		m_changes.clear();
+		m_pending = 0;
+		m_records = 0;
+		return true;
+	}
+
+	// Rewriting a journal grown much longer than the queue
+	if(m_records + m_pending > 2 * m_capacity) return compact();
+
+	FILE* file = fopen(m_path.c_str(), "ab");
+	bool status = (file != nullptr) && (fwrite(m_changes.data(), 1, m_changes.size(), file) == m_changes.size());
+	if(file != nullptr && fclose(file) != 0) status = false;
+
+	// Keeping the changes for the next attempt on failure
+	if(!status) {
+		ESP_LOGE("DATAFLOW", "Failed to append %u records to journal %s.", (unsigned) m_pending, m_path.c_str());
+		return false;
+	}
+
+	m_records += m_pending;
+	m_changes.clear();
+	m_pending = 0;
+	return true;
+}
+
+bool DF_DurableQueue::compact()
+{
+	// Encoding a PUSH record of each message queued
+	std::vector<uint8_t> data;
+	for(const Node& message : m_queue) {
+		std::size_t length = NodeSerializer::serializedSize(message);
+		std::size_t offset = data.size();
+		data.resize(offset + RECORD_HEADER + length);
+
+		uint8_t* record = data.data() + offset;
+		NodeSerializer::serialize(message, record + RECORD_HEADER, length);
+		record[0] = RECORD_PUSH;
+		putU32(record + 1, length);
+		putU32(record + 5, SnapshotStorage::checksum(record + RECORD_HEADER, length));
+	}
+
+	// Writing a new journal beside the old one, so a power loss leaves one of them intact
+	std::string temporary = m_path + ".tmp";
+	FILE* file = fopen(temporary.c_str(), "wb");
+	bool status = (file != nullptr) && (fwrite(data.data(), 1, data.size(), file) == data.size());
+	if(file != nullptr && fclose(file) != 0) status = false;
+
+	// Replacing the old journal, FAT can not rename over an existing file
+	if(status) {
+		std::remove(m_path.c_str());
+		status = std::rename(temporary.c_str(), m_path.c_str()) == 0;
+	}
+
+	if(!status) {
+		ESP_LOGE("DATAFLOW", "Failed to compact journal %s.", m_path.c_str());
+		std::remove(temporary.c_str());
+		return false;
+	}
+
+	m_records = m_queue.size();
+	m_changes.clear();
+	m_pending = 0;
+	return true;
+}
+
+void DF_DurableQueue::replay()
+{
+	// Falling back to the new journal of an interrupted compaction
+	std::string temporary = m_path + ".tmp";
+	FILE* file = fopen(m_path.c_str(), "rb");
+	if(file == nullptr && std::rename(temporary.c_str(), m_path.c_str()) == 0) file = fopen(m_path.c_str(), "rb");
+	else std::remove(temporary.c_str());
+
+	if(file == nullptr) return;
+
+	// Reading the whole journal at once, it is at most a few times the queue
+	std::vector<uint8_t> data;
+	uint8_t chunk[256];
+	std::size_t count;
+	while((count = fread(chunk, 1, sizeof(chunk), file)) > 0) data.insert(data.end(), chunk, chunk + count);
+	fclose(file);
+
+	// Applying the records up to the first one torn by a power loss
+	std::size_t offset = 0;
+	std::size_t records = 0;
+
+	while(offset + RECORD_HEADER <= data.size()) {
+		const uint8_t* record = data.data() + offset;
+		std::size_t length = getU32(record + 1);
+
+		if(length > data.size() - offset - RECORD_HEADER) break;
+		if(getU32(record + 5) != SnapshotStorage::checksum(record + RECORD_HEADER, length)) break;
+
+		if(record[0] == RECORD_PUSH) {
+			Node message;
+			if(NodeSerializer::deserialize(record + RECORD_HEADER, length, message) != length) break;
+			m_queue.push_back(std::move(message));
+		}
+		else if(record[0] == RECORD_POP) {
+			if(!m_queue.empty()) m_queue.pop_front();
+		}
+		else break;
+
+		offset += RECORD_HEADER + length;
+		records++;
+	}
+
+	// Keeping the newest messages of a queue shrunk since the journal was written
+	bool trimmed = m_queue.size() > m_capacity;
+	while(m_queue.size() > m_capacity) m_queue.pop_front();
+	renumber();
+
+	m_records = records;
+	ESP_LOGI("DATAFLOW", "Replayed %u messages from journal %s.", (unsigned) m_queue.size(), m_path.c_str());
+
+	// Dropping a torn tail, the records appended after it would be unreachable
+	if(offset < data.size() || trimmed) compact();
+}
@@ -0,0 +1,200 @@
+#pragma once
+#ifndef DATAFLOW_COMPONENTS_DF_DURABLE_QUEUE_H_INCLUDED
+#define DATAFLOW_COMPONENTS_DF_DURABLE_QUEUE_H_INCLUDED
+
+// Standard includes
+#include <deque>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// FreeRTOS includes
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+// Project includes
+#include "dataflow.h"
+#include "timer.h"
+
+
+/**
+ * This class implements a store-and-forward queue, whose messages survive deep
+ * sleep and reboots and are replayed on wake, eg. to keep the ThingSpeak updates
+ * failed while the WiFi was down, or queued when the deep sleep started. The
+ * messages are stored in the binary Node encoding (see NodeSerializer) by one of
+ * the following backends:
+ *
+ * - RTC memory (empty path): the queue is saved into the snapshot of the flow
+ *   (see Dataflow::saveSnapshot()), so it survives deep sleep, but not power loss.
+ *   This suits a few small messages, as the whole snapshot is DATAFLOW_SNAPSHOT_SIZE.
+ *
+ * - File (path on SPIFFS or SD card): the changes of the queue are appended to a
+ *   journal file, which survives power loss too. The changes are batched: they are
+ *   written when the batch is full, when the flush time passed since the first
+ *   change, or when the snapshot is saved before deep sleep. The journal is read
+ *   once when the component starts (the file system must be mounted by then) and
+ *   is compacted when it grows past twice the capacity of the queue.
+ *
+ * The head of the queue is sent without blocking. When the "ack" port is connected,
+ * the head is only removed when it is sent back as an acknowledgement (eg. by
+ * DF_ThingspeakWrite after a successful update), and it is sent again after the
+ * retry time otherwise, so each message is delivered at least once. The messages
+ * sent carry their sequence id in a "queue_sequence" child, which identifies the
+ * acknowledgements, so equal messages queued after each other and the duplicates
+ * sent by a retry are told apart. The sequence ids are assigned when the messages
+ * are queued or restored, they are not saved with the messages. Without the
+ * "ack" port messages are removed as soon as they are sent. When the queue is full
+ * new messages are dropped and counted, like the messages nested too deep for the
+ * NodeSerializer.
+ *
+ * Ports:
+ *
+ * [input] "in"    - Used to receive the messages to queue.
+ *
+ * [input] "ack"   - Used to receive the messages delivered back as acknowledgements,
+ *                   which must keep their "queue_sequence" id.
+ *
+ * [input] "timer" - Internal port receiving the expirations of the Timers of the
+ *                   component, it is not meant to be connected.
+ *
+ * [output] "out"  - Used to send the messages of the queue, one at a time, with
+ *                   their "queue_sequence" id.
+ */
+class DF_DurableQueue : public CooperativeComponent {
+public:
+
+	/**
+	 * Constructs a DF_DurableQueue.
+	 * @param path     [in] The path of the journal file, empty to keep the queue in RTC memory.
+	 * @param capacity [in] The maximum number of messages queued.
+	 * @param batch    [in] The number of changes written to the journal at once.
+	 * @param flush_ms [in] The longest time a change waits for its batch in milliseconds.
+	 * @param retry_ms [in] The time to wait for an acknowledgement before sending again in milliseconds.
+	 */
+	DF_DurableQueue(const std::string& path, std::size_t capacity = 16, std::size_t batch = 8,
+			uint32_t flush_ms = 1000, uint32_t retry_ms = 20000);
+
+	/**
+	 * Destroys the DF_DurableQueue, writing the pending changes to the journal.
+	 */
+	~DF_DurableQueue();
+
+	virtual void process() override;
+
+	/**
+	 * Saves the queue into the snapshot in RTC mode, and writes the pending changes
+	 * to the journal in file mode (the file is the persistent state then).
+	 */
+	virtual std::size_t saveState(uint8_t* buffer, std::size_t size) override;
+
+	/**
+	 * Restores the queue saved in RTC mode.
+	 */
+	virtual void restoreState(const uint8_t* buffer, std::size_t size) override;
+
+	/**
+	 * Writes the pending changes of the queue to the journal file.
+	 * @return True when the journal is up to date (always true in RTC mode).
+	 */
+	bool flush();
+
+	/**
+	 * Queries the number of messages queued.
+	 * @return The number of messages waiting for delivery.
+	 */
+	std::size_t size() const;
+
+	/**
+	 * Queries the number of messages dropped because the queue was full.
+	 * @return The number of messages dropped.
+	 */
+	std::size_t dropped() const noexcept;
+
+private:
+
+	// The types of the journal records
+	static const uint8_t RECORD_PUSH = 1; /**< A message appended to the queue.  */
+	static const uint8_t RECORD_POP  = 2; /**< The head of the queue removed.    */
+
+	// The helpers below expect the mutex to be held, except deliver()
+
+	/**
+	 * Appends a message to the queue and journals it.
+	 * @param message [in] The message to append.
+	 */
+	void push(const Node& message);
+
+	/**
+	 * Removes the head of the queue and journals it.
+	 */
+	void pop();
+
+	/**
+	 * Sends the messages of the queue until one is waiting for an acknowledgement.
+	 */
+	void deliver();
+
+	/**
+	 * Assigns new sequence ids to the messages of the queue, eg. after restoring it.
+	 */
+	void renumber();
+
+	/**
+	 * Starts the retry Timer, or restarts it when it is active already. The
+	 * expirations are tagged with a new generation, so the ones queued before
+	 * are ignored.
+	 */
+	void startRetry();
+
+	/**
+	 * Stops the retry Timer, ignoring the expirations queued already.
+	 */
+	void stopRetry();
+
+	/**
+	 * Appends a record to the changes not written yet, flushing a full batch.
+	 * @param type    [in] The type of the record.
+	 * @param message [in] The message of PUSH records, nullptr for POP records.
+	 */
+	void journal(uint8_t type, const Node* message);
+
+	/**
+	 * Writes the pending changes to the journal file.
+	 * @return True when the journal is up to date.
+	 */
+	bool write();
+
+	/**
+	 * Rewrites the journal with the messages of the queue only.
+	 * @return True when the journal is rewritten.
+	 */
+	bool compact();
+
+	/**
+	 * Rebuilds the queue from the journal file.
+	 */
+	void replay();
+
+	std::string          m_path;       /**< The path of the journal file, empty in RTC mode.    */
+	std::size_t          m_capacity;   /**< The maximum number of messages queued.              */
+	std::size_t          m_batch;      /**< The number of changes written at once.              */
+	TickType_t           m_flush;      /**< The longest time a change waits for its batch.      */
+	TickType_t           m_retry;      /**< The time to wait for an acknowledgement.            */
+	std::deque<Node>     m_queue;      /**< The messages waiting for delivery.                  */
+	std::deque<uint32_t> m_ids;        /**< The sequence ids of the messages queued.            */
+	uint32_t             m_sequence;   /**< The sequence id of the next message queued.         */
+	uint32_t             m_generation; /**< The generation of the current retry Timer start.    */
+	std::vector<uint8_t> m_changes;    /**< The encoded records not written to the journal yet. */
+	std::size_t          m_pending;    /**< The number of records not written yet.              */
+	std::size_t          m_records;    /**< The number of records in the journal file.          */
+	std::size_t          m_dropped;    /**< The number of messages dropped.                     */
+	bool                 m_loaded;     /**< Whether the journal is replayed.                    */
+	bool                 m_inflight;   /**< Whether the head is waiting for an acknowledgement. */
+	Timer                m_flushTimer; /**< The Timer writing the batch not filled in time.     */
+	Timer                m_retryTimer; /**< The Timer sending the head again.                   */
+	SemaphoreHandle_t    m_mutex;      /**< The mutex guarding the queue against snapshots.     */
+	Node                 m_message;    /**< The message being received.                         */
+};
+
+#endif // DATAFLOW_COMPONENTS_DF_DURABLE_QUEUE_H_INCLUDED
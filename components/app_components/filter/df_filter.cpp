@@ -0,0 +1,100 @@
+#include "df_filter.h"
+
+// DF_Filter
+
+DF_Filter::DF_Filter(const std::vector<std::string>& fields, const FilterKernel& kernel)
+	: m_fields(fields)
+{
+	// Adding input & output ports
+	m_ports.addInputPort("in");
+	m_ports.addOutputPort("out");
+
+	// Creating the filter state of each field
+	for(std::size_t i = 0; i < m_fields.size(); i++) m_kernels.emplace_back(kernel.clone());
+}
+
+void DF_Filter::process()
+{
+	if(!m_ports["in"].receive(m_message, 0)) return;
+	m_progressed = true;
+
+	bool consumed = false, produced = false;
+
+	// Filtering the fields present
+	for(std::size_t i = 0; i < m_fields.size(); i++) {
+		if(!m_message.has_child(m_fields[i])) continue;
+
+		int samples = filter(m_fields[i], *m_kernels[i]);
+		if(samples >= 0) consumed = true;
+		if(samples > 0) produced = true;
+	}
+
+	// Holding back messages with all their samples consumed by decimation
+	if(consumed && !produced) return;
+
+	m_ports["out"].send(m_message);
+}
+
+int DF_Filter::filter(const std::string& name, FilterKernel& kernel)
+{
+	Node& field = m_message[name];
+	double value = 0;
+
+	// Collecting the samples, a single number or the numbers of an array
+	m_input.clear();
+	if(field.child_count() == 0) {
+		if(field.get_number(value)) m_input.push_back(value);
+	}
+	else {
+		for(const Node* element = field.first_child(); element != nullptr; element = element->next_sibling()) {
+			if(element->get_number(value)) m_input.push_back(value);
+		}
+	}
+
+	if(m_input.empty()) return -1;
+
+	// Filtering the samples as a single block
+	bool single = field.child_count() == 0;
+	m_output.resize(m_input.size());
+	std::size_t produced = kernel.process(m_input.data(), m_output.data(), m_input.size());
+
+	// Replacing the field with the filtered samples
+	if(produced == 0) m_message.remove(name);
+	else if(single) field = (double) m_output[0];
+	else {
+		field.clear();
+		for(std::size_t i = 0; i < produced; i++) field.add((double) m_output[i]);
+	}
+
+	return produced;
+}
+
+// DF_EMA
+
+DF_EMA::DF_EMA(const std::vector<std::string>& fields, float alpha)
+	: DF_Filter(fields, EmaKernel(alpha))
+{}
+
+// DF_Median
+
+DF_Median::DF_Median(const std::vector<std::string>& fields, std::size_t window)
+	: DF_Filter(fields, MedianKernel(window))
+{}
+
+// DF_Kalman
+
+DF_Kalman::DF_Kalman(const std::vector<std::string>& fields, float processNoise, float measurementNoise)
+	: DF_Filter(fields, KalmanKernel(processNoise, measurementNoise))
+{}
+
+// DF_FIR
+
+DF_FIR::DF_FIR(const std::vector<std::string>& fields, const std::vector<float>& taps, std::size_t decimation)
+	: DF_Filter(fields, FirKernel(taps, decimation))
+{}
+
+// DF_IIR
+
+DF_IIR::DF_IIR(const std::vector<std::string>& fields, const std::vector<float>& coefficients, std::size_t decimation)
+	: DF_Filter(fields, IirKernel(coefficients, decimation))
+{}
@@ -0,0 +1,137 @@
+#pragma once
+#ifndef DATAFLOW_COMPONENTS_DF_FILTER_H_INCLUDED
+#define DATAFLOW_COMPONENTS_DF_FILTER_H_INCLUDED
+
+// Standard includes
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+// Project includes
+#include "dataflow.h"
+#include "filter_kernels.h"
+
+
+/**
+ * This class implements the common part of the filter components, which smooth the
+ * numeric fields of the messages, eg. sensor readings before display and upload.
+ * Each field has its own filter state. A field holding a single number is filtered
+ * as one sample, a field holding an array of numbers as a batch of samples, which is
+ * replaced by the array of filtered samples. Fields consumed by a decimating filter
+ * without producing a sample are removed, and messages left without any of their
+ * filtered fields are not sent. The components are cooperative and run on a shared
+ * executor task of the Dataflow.
+ *
+ * Ports:
+ *
+ * [input] "in"   - Used to receive the messages to filter.
+ *
+ * [output] "out" - Used to send the messages with the filtered fields.
+ */
+class DF_Filter : public CooperativeComponent {
+public:
+
+	virtual void process() override;
+
+protected:
+
+	/**
+	 * Constructs a DF_Filter.
+	 * @param fields [in] The names of the fields to filter.
+	 * @param kernel [in] The kernel to clone for each field.
+	 */
+	DF_Filter(const std::vector<std::string>& fields, const FilterKernel& kernel);
+
+private:
+
+	/**
+	 * Filters a field of the message in place, removing it when no sample is produced.
+	 * @param  name   [in] The name of the field to filter.
+	 * @param  kernel [in] The kernel of the field.
+	 * @return The number of samples produced, or -1 when the field holds no numbers.
+	 */
+	int filter(const std::string& name, FilterKernel& kernel);
+
+	std::vector<std::string>                   m_fields;  /**< The names of the filtered fields.  */
+	std::vector<std::unique_ptr<FilterKernel>> m_kernels; /**< The kernel of each field.          */
+	std::vector<float>                         m_input;   /**< The samples of the field filtered. */
+	std::vector<float>                         m_output;  /**< The filtered samples.              */
+	Node                                       m_message; /**< The message being filtered.        */
+};
+
+/**
+ * This class smooths the fields by exponential moving average.
+ */
+class DF_EMA : public DF_Filter {
+public:
+
+	/**
+	 * Constructs a DF_EMA.
+	 * @param fields [in] The names of the fields to filter.
+	 * @param alpha  [in] The weight of the new samples between 0 and 1.
+	 */
+	DF_EMA(const std::vector<std::string>& fields, float alpha);
+};
+
+/**
+ * This class replaces the fields by the median of their last samples, which removes
+ * spikes without smoothing edges.
+ */
+class DF_Median : public DF_Filter {
+public:
+
+	/**
+	 * Constructs a DF_Median.
+	 * @param fields [in] The names of the fields to filter.
+	 * @param window [in] The number of samples to take the median of.
+	 */
+	DF_Median(const std::vector<std::string>& fields, std::size_t window);
+};
+
+/**
+ * This class estimates the fields by a one-dimensional Kalman filter.
+ */
+class DF_Kalman : public DF_Filter {
+public:
+
+	/**
+	 * Constructs a DF_Kalman.
+	 * @param fields           [in] The names of the fields to filter.
+	 * @param processNoise     [in] The variance of the change of the signal between samples.
+	 * @param measurementNoise [in] The variance of the noise of the samples.
+	 */
+	DF_Kalman(const std::vector<std::string>& fields, float processNoise, float measurementNoise);
+};
+
+/**
+ * This class filters the fields by a decimating FIR filter.
+ */
+class DF_FIR : public DF_Filter {
+public:
+
+	/**
+	 * Constructs a DF_FIR.
+	 * @param fields     [in] The names of the fields to filter.
+	 * @param taps       [in] The coefficients of the filter, taps[0] weights the newest sample.
+	 * @param decimation [in] The number of samples consumed per sample produced.
+	 */
+	DF_FIR(const std::vector<std::string>& fields, const std::vector<float>& taps, std::size_t decimation = 1);
+};
+
+/**
+ * This class filters the fields by a decimating IIR filter of biquad sections.
+ */
+class DF_IIR : public DF_Filter {
+public:
+
+	/**
+	 * Constructs a DF_IIR.
+	 * @param fields       [in] The names of the fields to filter.
+	 * @param coefficients [in] The coefficients {b0, b1, b2, a1, a2} of each section.
+	 * @param decimation   [in] The number of samples consumed per sample produced.
+	 */
+	DF_IIR(const std::vector<std::string>& fields, const std::vector<float>& coefficients, std::size_t decimation = 1);
+};
+
+#endif // DATAFLOW_COMPONENTS_DF_FILTER_H_INCLUDED
@@ -0,0 +1,233 @@
+#include "filter_kernels.h"
+
+// Standard includes
+#include <cmath>
+#include <algorithm>
+
+// EmaKernel
+
+EmaKernel::EmaKernel(float alpha)
+	: m_alpha(alpha), m_average(0), m_started(false)
+{}
+
+FilterKernel* EmaKernel::clone() const
+{
+	return new EmaKernel(m_alpha);
+}
+
+std::size_t EmaKernel::process(const float* input, float* output, std::size_t count)
+{
+	if(count == 0) return 0;
+
+	// Starting the average from the first sample
+	if(!m_started) {
+		m_average = input[0];
+		m_started = true;
+	}
+
+	// Keeping the average in a register for the whole block
+	float average = m_average;
+	for(std::size_t i = 0; i < count; i++) {
+		average += m_alpha * (input[i] - average);
+		output[i] = average;
+	}
+
+	m_average = average;
+	return count;
+}
+
+// MedianKernel
+
+MedianKernel::MedianKernel(std::size_t window)
+	: m_window(window > 0 ? window : 1), m_oldest(0)
+{
+	m_ring.reserve(m_window);
+	m_sorted.reserve(m_window);
+}
+
+FilterKernel* MedianKernel::clone() const
+{
+	return new MedianKernel(m_window);
+}
+
+std::size_t MedianKernel::process(const float* input, float* output, std::size_t count)
+{
+	for(std::size_t i = 0; i < count; i++) {
+		float sample = input[i];
+
+		// Skipping NaN samples, which have no place in the sorted window
+		if(!std::isnan(sample)) {
+
+			// Replacing the oldest sample of a full window, growing the window otherwise
+			if(m_ring.size() == m_window) {
+				m_sorted.erase(std::lower_bound(m_sorted.begin(), m_sorted.end(), m_ring[m_oldest]));
+				m_ring[m_oldest] = sample;
+				m_oldest = (m_oldest + 1) % m_window;
+			}
+			else m_ring.push_back(sample);
+
+			m_sorted.insert(std::upper_bound(m_sorted.begin(), m_sorted.end(), sample), sample);
+		}
+
+		// Passing the NaN samples arriving before the first number
+		if(m_sorted.empty()) {
+			output[i] = sample;
+			continue;
+		}
+
+		// Taking the middle sample, or the average of the middle two
+		std::size_t middle = m_sorted.size() / 2;
+		output[i] = (m_sorted.size() % 2) ? m_sorted[middle] : (m_sorted[middle - 1] + m_sorted[middle]) * 0.5f;
+	}
+
+	return count;
+}
+
+// KalmanKernel
+
+KalmanKernel::KalmanKernel(float processNoise, float measurementNoise)
+	: m_processNoise(processNoise), m_measurementNoise(measurementNoise), m_estimate(0), m_error(0), m_started(false)
+{}
+
+FilterKernel* KalmanKernel::clone() const
+{
+	return new KalmanKernel(m_processNoise, m_measurementNoise);
+}
+
+std::size_t KalmanKernel::process(const float* input, float* output, std::size_t count)
+{
+	if(count == 0) return 0;
+
+	// Starting the estimate from the first sample, as uncertain as a measurement
+	if(!m_started) {
+		m_estimate = input[0];
+		m_error = m_measurementNoise;
+		m_started = true;
+	}
+
+	// Keeping the state in registers for the whole block
+	float estimate = m_estimate;
+	float error = m_error;
+
+	for(std::size_t i = 0; i < count; i++) {
+
+		// Predicting, then correcting the estimate by the sample
+		error += m_processNoise;
+		float gain = error / (error + m_measurementNoise);
+		estimate += gain * (input[i] - estimate);
+		error *= 1.0f - gain;
+
+		output[i] = estimate;
+	}
+
+	m_estimate = estimate;
+	m_error = error;
+	return count;
+}
+
+// FirKernel
+
+FirKernel::FirKernel(const std::vector<float>& taps, std::size_t decimation)
+	: m_taps(taps.rbegin(), taps.rend()), m_decimation(decimation > 0 ? decimation : 1), m_phase(m_decimation)
+{
+	// A filter needs at least one tap, the history starts at zero
+	if(m_taps.empty()) m_taps.push_back(1.0f);
+	m_buffer.assign(m_taps.size() - 1, 0.0f);
+}
+
+FilterKernel* FirKernel::clone() const
+{
+	return new FirKernel(std::vector<float>(m_taps.rbegin(), m_taps.rend()), m_decimation);
+}
+
+std::size_t FirKernel::process(const float* input, float* output, std::size_t count)
+{
+	const std::size_t taps = m_taps.size();
+	std::size_t produced = 0;
+
+	// Appending the block to the history, so every window is contiguous
+	m_buffer.insert(m_buffer.end(), input, input + count);
+
+	const float* __restrict coefficients = m_taps.data();
+	for(std::size_t i = 0; i < count; i++) {
+
+		// Skipping the outputs dropped by the decimation
+		if(--m_phase != 0) continue;
+		m_phase = m_decimation;
+
+		// Computing the dot product of the window ending at the sample, with
+		// independent partial sums to keep the FPU pipeline busy
+		const float* __restrict window = m_buffer.data() + i;
+		float sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+		std::size_t k = 0;
+
+		for(; k + 4 <= taps; k += 4) {
+			sum0 += coefficients[k] * window[k];
+			sum1 += coefficients[k + 1] * window[k + 1];
+			sum2 += coefficients[k + 2] * window[k + 2];
+			sum3 += coefficients[k + 3] * window[k + 3];
+		}
+		for(; k < taps; k++) sum0 += coefficients[k] * window[k];
+
+		output[produced++] = (sum0 + sum1) + (sum2 + sum3);
+	}
+
+	// Keeping the last samples as the history of the next block
+	m_buffer.erase(m_buffer.begin(), m_buffer.begin() + count);
+	return produced;
+}
+
+// IirKernel
+
+IirKernel::IirKernel(const std::vector<float>& coefficients, std::size_t decimation)
+	: m_decimation(decimation > 0 ? decimation : 1), m_phase(m_decimation)
+{
+	// Creating a section from each five coefficients, the incomplete rest is ignored
+	for(std::size_t i = 0; i + 5 <= coefficients.size(); i += 5) {
+		m_sections.push_back({ coefficients[i], coefficients[i + 1], coefficients[i + 2], coefficients[i + 3], coefficients[i + 4], 0, 0 });
+	}
+}
+
+FilterKernel* IirKernel::clone() const
+{
+	// Collecting the coefficients, the clone starts from zero state
+	std::vector<float> coefficients;
+	for(const Section& section : m_sections) {
+		coefficients.insert(coefficients.end(), { section.m_b0, section.m_b1, section.m_b2, section.m_a1, section.m_a2 });
+	}
+
+	return new IirKernel(coefficients, m_decimation);
+}
+
+std::size_t IirKernel::process(const float* input, float* output, std::size_t count)
+{
+	m_block.assign(input, input + count);
+	float* __restrict block = m_block.data();
+
+	// Filtering the whole block by each section in turn
+	for(Section& section : m_sections) {
+		const float b0 = section.m_b0, b1 = section.m_b1, b2 = section.m_b2, a1 = section.m_a1, a2 = section.m_a2;
+		float z1 = section.m_z1, z2 = section.m_z2;
+
+		for(std::size_t i = 0; i < count; i++) {
+			float x = block[i];
+			float y = b0 * x + z1;
+			z1 = b1 * x - a1 * y + z2;
+			z2 = b2 * x - a2 * y;
+			block[i] = y;
+		}
+
+		section.m_z1 = z1;
+		section.m_z2 = z2;
+	}
+
+	// Keeping every decimation-th sample, the state needs all of them
+	std::size_t produced = 0;
+	for(std::size_t i = 0; i < count; i++) {
+		if(--m_phase != 0) continue;
+		m_phase = m_decimation;
+		output[produced++] = block[i];
+	}
+
+	return produced;
+}
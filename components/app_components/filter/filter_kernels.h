@@ -0,0 +1,174 @@
+#pragma once
+#ifndef DATAFLOW_COMPONENTS_FILTER_KERNELS_H_INCLUDED
+#define DATAFLOW_COMPONENTS_FILTER_KERNELS_H_INCLUDED
+
+// Standard includes
+#include <vector>
+#include <cstddef>
+
+
+/**
+ * The FilterKernel class is the interface of the streaming filters used by the
+ * filter components. A kernel keeps the state of a single signal and processes a
+ * block of samples at a time, so the state is loaded once per block instead of once
+ * per sample. The samples are single precision floats, as the FPU of the ESP32 only
+ * supports single precision (double arithmetic is emulated in software).
+ */
+class FilterKernel {
+public:
+
+	virtual ~FilterKernel() = default;
+
+	/**
+	 * Creates a kernel with the same parameters and an initial state.
+	 * @return Pointer to the new kernel, owned by the caller.
+	 */
+	virtual FilterKernel* clone() const = 0;
+
+	/**
+	 * Filters a block of samples. Decimating kernels produce fewer samples than
+	 * they consume, the others produce one sample for each sample consumed.
+	 * @param  input  [in]  The samples to filter.
+	 * @param  output [out] The filtered samples, room for count samples is required.
+	 * @param  count  [in]  The number of samples to filter.
+	 * @return The number of samples written to the output.
+	 */
+	virtual std::size_t process(const float* input, float* output, std::size_t count) = 0;
+};
+
+/**
+ * Exponential moving average: y[n] = y[n-1] + alpha * (x[n] - y[n-1]), started
+ * from the first sample.
+ */
+class EmaKernel : public FilterKernel {
+public:
+
+	/**
+	 * Constructs an EmaKernel.
+	 * @param alpha [in] The weight of the new samples between 0 and 1, larger values follow faster.
+	 */
+	explicit EmaKernel(float alpha);
+
+	virtual FilterKernel* clone() const override;
+	virtual std::size_t process(const float* input, float* output, std::size_t count) override;
+
+private:
+	float m_alpha;   /**< The weight of the new samples.    */
+	float m_average; /**< The current average.              */
+	bool  m_started; /**< Whether the first sample is seen. */
+};
+
+/**
+ * Running median of the last samples. The samples of the window are kept both in
+ * arrival order (to find the oldest one) and sorted (to find the median), so a new
+ * sample costs a binary search and a short move instead of sorting the window.
+ * Until the window fills up the median of the samples seen is produced. NaN samples
+ * are skipped and produce the median of the window (NaN until the first number).
+ */
+class MedianKernel : public FilterKernel {
+public:
+
+	/**
+	 * Constructs a MedianKernel.
+	 * @param window [in] The number of samples to take the median of.
+	 */
+	explicit MedianKernel(std::size_t window);
+
+	virtual FilterKernel* clone() const override;
+	virtual std::size_t process(const float* input, float* output, std::size_t count) override;
+
+private:
+	std::vector<float> m_ring;   /**< The samples of the window in arrival order. */
+	std::vector<float> m_sorted; /**< The samples of the window sorted.           */
+	std::size_t        m_window; /**< The number of samples in a full window.     */
+	std::size_t        m_oldest; /**< The index of the oldest sample of the ring. */
+};
+
+/**
+ * One-dimensional Kalman filter of a constant signal with random walk: the process
+ * noise is added to the error of the estimate before each sample, which is then
+ * corrected by the sample weighted by the Kalman gain. Started from the first sample.
+ */
+class KalmanKernel : public FilterKernel {
+public:
+
+	/**
+	 * Constructs a KalmanKernel.
+	 * @param processNoise     [in] The variance of the change of the signal between samples.
+	 * @param measurementNoise [in] The variance of the noise of the samples.
+	 */
+	KalmanKernel(float processNoise, float measurementNoise);
+
+	virtual FilterKernel* clone() const override;
+	virtual std::size_t process(const float* input, float* output, std::size_t count) override;
+
+private:
+	float m_processNoise;     /**< The variance of the change of the signal. */
+	float m_measurementNoise; /**< The variance of the noise of the samples. */
+	float m_estimate;         /**< The current estimate of the signal.       */
+	float m_error;            /**< The variance of the estimate.             */
+	bool  m_started;          /**< Whether the first sample is seen.         */
+};
+
+/**
+ * Decimating FIR filter. The history of the filter and the new samples are kept in
+ * a single contiguous buffer and the taps are stored reversed, so each output is a
+ * plain dot product of two contiguous arrays, which the compiler can unroll (and
+ * vectorize on targets with SIMD). Only every decimation-th output is computed.
+ */
+class FirKernel : public FilterKernel {
+public:
+
+	/**
+	 * Constructs a FirKernel.
+	 * @param taps       [in] The coefficients of the filter, taps[0] weights the newest sample.
+	 * @param decimation [in] The number of samples consumed per sample produced.
+	 */
+	FirKernel(const std::vector<float>& taps, std::size_t decimation = 1);
+
+	virtual FilterKernel* clone() const override;
+	virtual std::size_t process(const float* input, float* output, std::size_t count) override;
+
+private:
+	std::vector<float> m_taps;       /**< The coefficients in reversed order.                 */
+	std::vector<float> m_buffer;     /**< The last taps - 1 samples, followed by the block.   */
+	std::size_t        m_decimation; /**< The number of samples consumed per sample produced. */
+	std::size_t        m_phase;      /**< The samples to consume until the next output.       */
+};
+
+/**
+ * Decimating IIR filter of cascaded biquad sections in transposed direct form II.
+ * Blocks are filtered section by section, so the coefficients and the state of a
+ * section stay in registers for the whole block. Each section is given by the
+ * coefficients {b0, b1, b2, a1, a2}, with a0 normalized to 1.
+ */
+class IirKernel : public FilterKernel {
+public:
+
+	/**
+	 * Constructs an IirKernel.
+	 * @param coefficients [in] The coefficients of the sections, five for each section.
+	 * @param decimation   [in] The number of samples consumed per sample produced.
+	 */
+	IirKernel(const std::vector<float>& coefficients, std::size_t decimation = 1);
+
+	virtual FilterKernel* clone() const override;
+	virtual std::size_t process(const float* input, float* output, std::size_t count) override;
+
+private:
+
+	/**
+	 * The Section structure stores the coefficients and the state of a biquad.
+	 */
+	struct Section {
+		float m_b0, m_b1, m_b2, m_a1, m_a2; /**< The coefficients of the section. */
+		float m_z1, m_z2;                   /**< The state of the section.        */
+	};
+
+	std::vector<Section> m_sections;   /**< The cascaded sections.                              */
+	std::vector<float>   m_block;      /**< The block being filtered.                           */
+	std::size_t          m_decimation; /**< The number of samples consumed per sample produced. */
+	std::size_t          m_phase;      /**< The samples to consume until the next output.       */
+};
+
+#endif // DATAFLOW_COMPONENTS_FILTER_KERNELS_H_INCLUDED
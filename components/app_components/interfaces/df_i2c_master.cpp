@@ -11,6 +11,6 @@ void DF_I2C_Master::process()
 	// Creating message to contain a pointer to this interface
 	m_ports["interface"].send(Node("root", (DriverInterface*) this));
 
-	// Suspending this task indefinitely
-	vTaskSuspend(xTaskGetCurrentTaskHandle());
+	// Finishing the component, which returns the stack of its task
+	finish();
 }
@@ -14,6 +14,6 @@ void DF_SDSPI::process()
 	// Creating message to contain a pointer to this interface
 	if(mounted) m_ports["interface"].send(Node("root", (DriverInterface*) this));
 
-	// Suspending this task indefinitely
-	vTaskSuspend(xTaskGetCurrentTaskHandle());
+	// Finishing the component, which returns the stack of its task
+	finish();
 }
@@ -0,0 +1,168 @@
+#include "df_rate.h"
+
+// DF_RateControl
+
+DF_RateControl::DF_RateControl(uint32_t window_ms)
+	: m_window(pdMS_TO_TICKS(window_ms) > 0 ? pdMS_TO_TICKS(window_ms) : 1), m_holding(false), m_dropped(0), m_generation(0)
+{
+	// Adding input & output ports, the timer port only needs room for a few expirations
+	m_ports.addInputPort("in");
+	m_ports.addInputPort("timer", 2);
+	m_ports.addOutputPort("out");
+
+	m_ports["timer"].setInternal(true);
+}
+
+void DF_RateControl::process()
+{
+	// Handling the expirations first, so they are not delayed by a burst of messages
+	if(m_ports["timer"].receive(m_message, 0)) {
+		m_progressed = true;
+
+		// Ignoring the expirations of the previous starts of the Timer
+		const uint32_t* generation = m_message.get<uint32_t>();
+		if(generation != nullptr && *generation == m_generation) expire();
+	}
+
+	if(m_ports["in"].receive(m_message, 0)) {
+		m_progressed = true;
+		accept(m_message);
+	}
+}
+
+std::size_t DF_RateControl::dropped() const noexcept
+{
+	return m_dropped;
+}
+
+void DF_RateControl::startTimer(TickType_t delay, TickType_t period)
+{
+	// The stopped Timer is not used by the timer service, so its message can be replaced
+	stopTimer();
+
+	Node message("timer");
+	message = m_generation;
+	m_timer.setTarget(m_ports["timer"], message);
+
+	m_timer.start(delay, period);
+}
+
+void DF_RateControl::stopTimer()
+{
+	// The expirations sent before stopping have the previous generation
+	m_timer.stop();
+	m_generation++;
+}
+
+// DF_TrailingDebounce
+
+DF_TrailingDebounce::DF_TrailingDebounce(uint32_t window_ms)
+	: DF_RateControl(window_ms)
+{}
+
+void DF_TrailingDebounce::accept(const Node& message)
+{
+	// Replacing the pending message and restarting the quiet time
+	if(m_holding) m_dropped++;
+	m_pending = message;
+	m_holding = true;
+
+	startTimer(m_window);
+}
+
+void DF_TrailingDebounce::expire()
+{
+	// Forwarding the last message of the burst
+	if(!m_holding) return;
+
+	m_holding = false;
+	m_ports["out"].send(m_pending);
+}
+
+// DF_Throttle
+
+DF_Throttle::DF_Throttle(uint32_t window_ms)
+	: DF_RateControl(window_ms), m_throttling(false)
+{}
+
+void DF_Throttle::accept(const Node& message)
+{
+	// Coalescing the messages of a running window into the latest one
+	if(m_throttling) {
+		if(m_holding) m_dropped++;
+		m_pending = message;
+		m_holding = true;
+		return;
+	}
+
+	// Passing the first message and starting the window
+	m_ports["out"].send(message);
+	m_throttling = true;
+	startTimer(m_window);
+}
+
+void DF_Throttle::expire()
+{
+	// Ending the window of a quiet input
+	if(!m_holding) {
+		m_throttling = false;
+		return;
+	}
+
+	// Sending the latest message of the window, which starts a new window
+	m_holding = false;
+	m_ports["out"].send(m_pending);
+	startTimer(m_window);
+}
+
+// DF_RateLimit
+
+DF_RateLimit::DF_RateLimit(uint32_t interval_ms, uint32_t burst)
+	: DF_RateControl(interval_ms), m_tokens(burst > 0 ? burst : 1), m_burst(burst > 0 ? burst : 1)
+{}
+
+void DF_RateLimit::accept(const Node& message)
+{
+	// Dropping the messages arriving at an empty bucket
+	if(m_tokens == 0) {
+		m_dropped++;
+		return;
+	}
+
+	// Refilling the bucket periodically while it is not full
+	if(m_tokens-- == m_burst) startTimer(m_window, m_window);
+
+	m_ports["out"].send(message);
+}
+
+void DF_RateLimit::expire()
+{
+	// Stopping the refill when the bucket is full
+	if(m_tokens < m_burst) m_tokens++;
+	if(m_tokens == m_burst) stopTimer();
+}
+
+// DF_SampleHold
+
+DF_SampleHold::DF_SampleHold(uint32_t period_ms)
+	: DF_RateControl(period_ms), m_fresh(false)
+{}
+
+void DF_SampleHold::accept(const Node& message)
+{
+	// Sampling the periodic output from the first message on
+	if(!m_holding) startTimer(m_window, m_window);
+
+	// Messages replaced before being sent once are counted as dropped
+	if(m_fresh) m_dropped++;
+	m_pending = message;
+	m_holding = true;
+	m_fresh = true;
+}
+
+void DF_SampleHold::expire()
+{
+	// Sending the held message again, until a new one is received
+	m_fresh = false;
+	m_ports["out"].send(m_pending);
+}
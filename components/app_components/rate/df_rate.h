@@ -0,0 +1,174 @@
+#pragma once
+#ifndef DATAFLOW_COMPONENTS_DF_RATE_H_INCLUDED
+#define DATAFLOW_COMPONENTS_DF_RATE_H_INCLUDED
+
+// Standard includes
+#include <cstdint>
+#include <cstddef>
+
+// Project includes
+#include "dataflow.h"
+#include "timer.h"
+
+
+/**
+ * This class implements the common part of the components controlling the rate of
+ * a stream of messages, eg. to protect slow sinks (like ThingSpeak, which accepts an
+ * update every 15 seconds) from bursts. The timing is done by a Timer of the dataflow
+ * timer service instead of polling the tick count, and the components are cooperative
+ * and run on a shared executor task of the Dataflow. The expirations carry the
+ * generation of the Timer start, so an expiration queued just before restarting or
+ * stopping the Timer is not mistaken for the end of the new window.
+ *
+ * Ports:
+ *
+ * [input] "in"    - Used to receive the messages.
+ *
+ * [input] "timer" - Internal port receiving the expirations of the Timer of the
+ *                   component, it is not meant to be connected.
+ *
+ * [output] "out"  - Used to send the messages passed by the component.
+ */
+class DF_RateControl : public CooperativeComponent {
+public:
+
+	virtual void process() override;
+
+	/**
+	 * Queries the number of messages dropped or replaced by newer ones.
+	 * @return The number of messages not sent.
+	 */
+	std::size_t dropped() const noexcept;
+
+protected:
+
+	/**
+	 * Constructs a DF_RateControl.
+	 * @param window_ms [in] The time window of the component in milliseconds.
+	 */
+	DF_RateControl(uint32_t window_ms);
+
+	/**
+	 * Handles a message received on the input.
+	 * @param message [in] The message received.
+	 */
+	virtual void accept(const Node& message) = 0;
+
+	/**
+	 * Handles an expiration of the Timer.
+	 */
+	virtual void expire() = 0;
+
+	/**
+	 * Starts the Timer, or restarts it when it is active already. The expirations
+	 * are tagged with a new generation, so the ones queued before are ignored.
+	 * @param delay  [in] The ticks until the first expiry.
+	 * @param period [in] The ticks between the following expirations, zero for a one-shot Timer.
+	 */
+	void startTimer(TickType_t delay, TickType_t period = 0);
+
+	/**
+	 * Stops the Timer, ignoring the expirations queued already.
+	 */
+	void stopTimer();
+
+	Timer       m_timer;   /**< The Timer of the component.                */
+	TickType_t  m_window;  /**< The time window of the component in ticks. */
+	Node        m_pending; /**< The message waiting to be sent.            */
+	bool        m_holding; /**< Whether there is a pending message.        */
+	std::size_t m_dropped; /**< The number of messages dropped or replaced. */
+
+private:
+	Node     m_message;    /**< The message being received.                */
+	uint32_t m_generation; /**< The generation of the current Timer start. */
+};
+
+/**
+ * This class implements a trailing-edge debounce: a message is only forwarded after
+ * the input has been quiet for the window, and only the last message of a burst is
+ * forwarded (unlike DF_Debounce, which forwards the first one).
+ */
+class DF_TrailingDebounce : public DF_RateControl {
+public:
+
+	/**
+	 * Constructs a DF_TrailingDebounce.
+	 * @param window_ms [in] The quiet time required before forwarding in milliseconds.
+	 */
+	DF_TrailingDebounce(uint32_t window_ms);
+
+protected:
+	virtual void accept(const Node& message) override;
+	virtual void expire() override;
+};
+
+/**
+ * This class forwards at most one message per window, coalescing the messages of a
+ * window into the latest one. The first message of a quiet input passes immediately,
+ * the latest message received during the window is sent at the end of the window.
+ */
+class DF_Throttle : public DF_RateControl {
+public:
+
+	/**
+	 * Constructs a DF_Throttle.
+	 * @param window_ms [in] The shortest time between the messages sent in milliseconds.
+	 */
+	DF_Throttle(uint32_t window_ms);
+
+protected:
+	virtual void accept(const Node& message) override;
+	virtual void expire() override;
+
+private:
+	bool m_throttling; /**< Whether a window is running. */
+};
+
+/**
+ * This class implements token bucket rate limiting: every message sent takes a token
+ * from the bucket, which is refilled by one token per interval up to the burst size.
+ * Messages arriving at an empty bucket are dropped. This allows short bursts while
+ * limiting the long term rate.
+ */
+class DF_RateLimit : public DF_RateControl {
+public:
+
+	/**
+	 * Constructs a DF_RateLimit with a full bucket.
+	 * @param interval_ms [in] The time to refill a token in milliseconds.
+	 * @param burst       [in] The capacity of the bucket.
+	 */
+	DF_RateLimit(uint32_t interval_ms, uint32_t burst = 1);
+
+protected:
+	virtual void accept(const Node& message) override;
+	virtual void expire() override;
+
+private:
+	uint32_t m_tokens; /**< The tokens in the bucket.   */
+	uint32_t m_burst;  /**< The capacity of the bucket. */
+};
+
+/**
+ * This class implements sample-and-hold: the latest message received is held and
+ * sent at a fixed rate, no matter how fast or slow the input is, starting with
+ * the first message received.
+ */
+class DF_SampleHold : public DF_RateControl {
+public:
+
+	/**
+	 * Constructs a DF_SampleHold.
+	 * @param period_ms [in] The period of the messages sent in milliseconds.
+	 */
+	DF_SampleHold(uint32_t period_ms);
+
+protected:
+	virtual void accept(const Node& message) override;
+	virtual void expire() override;
+
+private:
+	bool m_fresh; /**< Whether the held message was not sent yet. */
+};
+
+#endif // DATAFLOW_COMPONENTS_DF_RATE_H_INCLUDED
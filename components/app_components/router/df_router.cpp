@@ -0,0 +1,220 @@
+#include "df_router.h"
+
+// Standard includes
+#include <algorithm>
+
+// ESP-IDF includes
+#include "esp_log.h"
+
+// DF_Router::Rule
+
+DF_Router::Rule::Rule(const std::string& output)
+	: m_output(output)
+{}
+
+DF_Router::Rule& DF_Router::Rule::has(const std::string& child)
+{
+	m_predicates.push_back({ Predicate::HAS, child, Type::NONE, 0, 0 });
+	return *this;
+}
+
+DF_Router::Rule& DF_Router::Rule::type(Type type)
+{
+	m_predicates.push_back({ Predicate::TYPE, std::string(), type, 0, 0 });
+	return *this;
+}
+
+DF_Router::Rule& DF_Router::Rule::type(const std::string& child, Type type)
+{
+	m_predicates.push_back({ Predicate::TYPE, child, type, 0, 0 });
+	return *this;
+}
+
+DF_Router::Rule& DF_Router::Rule::range(const std::string& child, double min, double max)
+{
+	m_predicates.push_back({ Predicate::RANGE, child, Type::NUMBER, min, max });
+	return *this;
+}
+
+bool DF_Router::Rule::Predicate::operator==(const Predicate& other) const noexcept
+{
+	return m_kind == other.m_kind && m_child == other.m_child && m_type == other.m_type &&
+			m_min == other.m_min && m_max == other.m_max;
+}
+
+// DF_Router
+
+DF_Router::DF_Router()
+	: m_compiled(false), m_unmatched(0)
+{
+	// Adding input & output ports
+	m_ports.addInputPort("in");
+	m_ports.addOutputPort("unmatched");
+}
+
+DF_Router::Rule& DF_Router::route(const std::string& output)
+{
+	// Sharing the output port between the rules of the same output
+	m_ports.addOutputPort(output);
+	m_compiled = false;
+
+	m_rules.push_back(Rule(output));
+	return m_rules.back();
+}
+
+DF_Router::Rule& DF_Router::route(const Node& description)
+{
+	// Mapping the type names of the description to types
+	auto type = [](const Node& name) {
+		const char* data = name.string_data();
+		std::string string = (data != nullptr) ? data : "";
+
+		if(string == "bool")   return Type::BOOL;
+		if(string == "int")    return Type::INT;
+		if(string == "number") return Type::NUMBER;
+		if(string == "string") return Type::STRING;
+		return Type::NONE;
+	};
+
+	const char* output = description.has_child("output") ? description["output"].string_data() : nullptr;
+	Rule& rule = route((output != nullptr) ? output : "unmatched");
+
+	// Adding the predicates of the description
+	if(description.has_child("has")) {
+		for(const Node* child = description["has"].first_child(); child != nullptr; child = child->next_sibling()) {
+			const char* name = child->string_data();
+			if(name != nullptr) rule.has(name);
+		}
+	}
+
+	if(description.has_child("type")) rule.type(type(description["type"]));
+
+	if(description.has_child("types")) {
+		for(const Node* child = description["types"].first_child(); child != nullptr; child = child->next_sibling()) {
+			rule.type(child->name(), type(*child));
+		}
+	}
+
+	if(description.has_child("ranges")) {
+		for(const Node* child = description["ranges"].first_child(); child != nullptr; child = child->next_sibling()) {
+			double min = 0, max = 0;
+			if(child->child_count() == 2 && (*child)[0].get_number(min) && (*child)[1].get_number(max)) rule.range(child->name(), min, max);
+		}
+	}
+
+	return rule;
+}
+
+void DF_Router::process()
+{
+	// Compiling the routing table before the first message
+	if(!m_compiled) compile();
+
+	if(!m_ports["in"].receive(m_message, 0)) return;
+	m_progressed = true;
+
+	// Evaluating the predicates on the payload
+	uint64_t satisfied = 0;
+	for(uint8_t index : m_payload) {
+		if(evaluate(m_predicates[index], m_message)) satisfied |= 1ull << index;
+	}
+
+	// Evaluating the predicates on the children in a single pass over them
+	if(!m_children.empty()) {
+		for(const Node* child = m_message.first_child(); child != nullptr; child = child->next_sibling()) {
+			auto entry = m_children.find(child->name());
+			if(entry == m_children.end()) continue;
+
+			for(uint8_t index : entry->second) {
+				if(evaluate(m_predicates[index], *child)) satisfied |= 1ull << index;
+			}
+		}
+	}
+
+	// Forwarding to the first rule with all its predicates satisfied
+	for(std::size_t i = 0; i < m_masks.size(); i++) {
+		if(m_outputs[i] != nullptr && (m_masks[i] & ~satisfied) == 0) {
+			m_outputs[i]->send(m_message);
+			return;
+		}
+	}
+
+	m_unmatched++;
+	m_ports["unmatched"].send(m_message);
+}
+
+std::size_t DF_Router::unmatched() const noexcept
+{
+	return m_unmatched;
+}
+
+void DF_Router::compile()
+{
+	m_predicates.clear();
+	m_payload.clear();
+	m_children.clear();
+	m_masks.clear();
+	m_outputs.clear();
+
+	for(const Rule& rule : m_rules) {
+		uint64_t mask = 0;
+		bool valid = true;
+
+		for(const Rule::Predicate& predicate : rule.m_predicates) {
+
+			// Looking up the predicate among the ones of the previous rules
+			std::size_t index = std::find(m_predicates.begin(), m_predicates.end(), predicate) - m_predicates.begin();
+
+			if(index == m_predicates.size()) {
+
+				// Rules with too many distinct predicates can not be represented by a mask
+				if(index == MAX_PREDICATES) {
+					valid = false;
+					break;
+				}
+
+				// Indexing the new predicate by the child it examines
+				m_predicates.push_back(predicate);
+				if(predicate.m_child.empty()) m_payload.push_back(index);
+				else m_children[predicate.m_child].push_back(index);
+			}
+
+			mask |= 1ull << index;
+		}
+
+		if(!valid) ESP_LOGE("DATAFLOW", "Routing table exceeds %u predicates, rule of \"%s\" disabled.", (unsigned) MAX_PREDICATES, rule.m_output.c_str());
+
+		m_masks.push_back(mask);
+		m_outputs.push_back(valid ? &m_ports[rule.m_output] : nullptr);
+	}
+
+	m_compiled = true;
+}
+
+bool DF_Router::evaluate(const Rule::Predicate& predicate, const Node& node) noexcept
+{
+	double value = 0;
+
+	switch(predicate.m_kind) {
+		case Rule::Predicate::HAS:   return true;
+		case Rule::Predicate::TYPE:  return matches(node, predicate.m_type);
+		case Rule::Predicate::RANGE: return node.get_number(value) && value >= predicate.m_min && value <= predicate.m_max;
+	}
+
+	return false;
+}
+
+bool DF_Router::matches(const Node& node, Type type) noexcept
+{
+	double value = 0;
+
+	switch(type) {
+		case Type::NONE:   return !node.has_value();
+		case Type::BOOL:   return node.get<bool>() != nullptr;
+		case Type::INT:    return node.get<int>() != nullptr;
+		case Type::NUMBER: return node.get_number(value);
+		case Type::STRING: return node.string_data() != nullptr;
+	}
+
+	return false;
+}
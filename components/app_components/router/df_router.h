@@ -0,0 +1,193 @@
+#pragma once
+#ifndef DATAFLOW_COMPONENTS_DF_ROUTER_H_INCLUDED
+#define DATAFLOW_COMPONENTS_DF_ROUTER_H_INCLUDED
+
+// Standard includes
+#include <deque>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+
+// Project includes
+#include "dataflow.h"
+
+
+/**
+ * This class forwards each message to the output of the first matching rule of a
+ * routing table, so the components downstream handle a single shape of messages,
+ * instead of probing each message for every shape they know (like DF_Display does
+ * with has_child() and hasType() calls in sequence). The rules are conjunctions of
+ * predicates on the children and the payload of the messages. Before the first
+ * message the table is compiled: the predicates shared by the rules are evaluated
+ * only once, the predicates on children are indexed by the name of the child, and
+ * each rule becomes a bitmask of the predicates it requires. Routing a message then
+ * takes a single pass over its children and a mask test per rule. The component is
+ * cooperative and runs on a shared executor task of the Dataflow.
+ *
+ * Ports:
+ *
+ * [input] "in"         - Used to receive the messages to route.
+ *
+ * [output] <outputs>   - An output port for each output named by the rules.
+ *
+ * [output] "unmatched" - Used to send the messages not matching any of the rules.
+ */
+class DF_Router : public CooperativeComponent {
+public:
+
+	/**
+	 * The types of payload the rules can require.
+	 */
+	enum class Type {
+		NONE,   /**< No payload, eg. a message with children only. */
+		BOOL,   /**< A bool payload.                               */
+		INT,    /**< An int payload.                               */
+		NUMBER, /**< A payload of any arithmetic type but bool.    */
+		STRING  /**< A payload of any of the string types.         */
+	};
+
+	/**
+	 * The Rule class describes the messages routed to an output, a message matches
+	 * when it satisfies all the predicates of the Rule (a Rule without predicates
+	 * matches all messages). The predicates are added by chaining the calls, eg.
+	 * router.route("weather").has("temperature").range("humidity", 0, 100).
+	 */
+	class Rule {
+	public:
+
+		/**
+		 * Requires a child.
+		 * @param  child [in] The name of the child.
+		 * @return Reference to the Rule.
+		 */
+		Rule& has(const std::string& child);
+
+		/**
+		 * Requires the type of the payload of the message.
+		 * @param  type [in] The type required.
+		 * @return Reference to the Rule.
+		 */
+		Rule& type(Type type);
+
+		/**
+		 * Requires a child with the specified type of payload.
+		 * @param  child [in] The name of the child.
+		 * @param  type  [in] The type required.
+		 * @return Reference to the Rule.
+		 */
+		Rule& type(const std::string& child, Type type);
+
+		/**
+		 * Requires a child holding a number in the specified closed range.
+		 * @param  child [in] The name of the child.
+		 * @param  min   [in] The lowest value accepted.
+		 * @param  max   [in] The highest value accepted.
+		 * @return Reference to the Rule.
+		 */
+		Rule& range(const std::string& child, double min, double max);
+
+	private:
+
+		// The router compiles the predicates of the Rules
+		friend class DF_Router;
+
+		/**
+		 * The Predicate structure describes a single condition of a Rule.
+		 */
+		struct Predicate {
+			enum Kind { HAS, TYPE, RANGE };
+
+			Kind        m_kind;  /**< The kind of the condition.                      */
+			std::string m_child; /**< The name of the child, empty for the payload.   */
+			Type        m_type;  /**< The type required by TYPE conditions.           */
+			double      m_min;   /**< The lowest value accepted by RANGE conditions.  */
+			double      m_max;   /**< The highest value accepted by RANGE conditions. */
+
+			bool operator==(const Predicate& other) const noexcept;
+		};
+
+		/**
+		 * Constructs a Rule without predicates.
+		 * @param output [in] The name of the output of the Rule.
+		 */
+		explicit Rule(const std::string& output);
+
+		std::string            m_output;     /**< The name of the output of the Rule. */
+		std::vector<Predicate> m_predicates; /**< The conditions of the Rule.         */
+	};
+
+	/**
+	 * The largest number of distinct predicates in a routing table.
+	 */
+	static const std::size_t MAX_PREDICATES = 64;
+
+	/**
+	 * Constructs a DF_Router without rules, forwarding all messages to "unmatched".
+	 */
+	DF_Router();
+
+	/**
+	 * Appends a rule to the routing table, adding its output port when it does not
+	 * exist yet. The rules are evaluated in the order they are added, and must be set
+	 * up before the Dataflow is started.
+	 * @param  output [in] The name of the output to forward the matching messages to.
+	 * @return Reference to the new Rule, to add its predicates to.
+	 */
+	Rule& route(const std::string& output);
+
+	/**
+	 * Appends a rule described by a Node to the routing table (see route()). The
+	 * description has the string child "output", and optionally the children "has"
+	 * (an array of child names), "type" (the name of the payload type: "none", "bool",
+	 * "int", "number" or "string"), "types" (child names mapped to type names) and
+	 * "ranges" (child names mapped to [min, max] arrays).
+	 * @param  description [in] The description of the rule.
+	 * @return Reference to the new Rule.
+	 */
+	Rule& route(const Node& description);
+
+	virtual void process() override;
+
+	/**
+	 * Queries the number of messages not matching any of the rules.
+	 * @return The number of messages sent to "unmatched".
+	 */
+	std::size_t unmatched() const noexcept;
+
+private:
+
+	/**
+	 * Compiles the rules into predicate masks, deduplicating the predicates.
+	 */
+	void compile();
+
+	/**
+	 * Evaluates a predicate on a Node.
+	 * @param  predicate [in] The predicate to evaluate.
+	 * @param  node      [in] The message for payload predicates, the child otherwise.
+	 * @return True when the predicate holds.
+	 */
+	static bool evaluate(const Rule::Predicate& predicate, const Node& node) noexcept;
+
+	/**
+	 * Queries whether the payload of a Node has the specified type.
+	 * @param  node [in] The Node to check.
+	 * @param  type [in] The type required.
+	 * @return True when the payload has the type.
+	 */
+	static bool matches(const Node& node, Type type) noexcept;
+
+	std::deque<Rule>                                      m_rules;      /**< The routing table (references stay valid).  */
+	bool                                                  m_compiled;   /**< Whether the compiled table is up to date.   */
+	std::vector<Rule::Predicate>                          m_predicates; /**< The distinct predicates of the rules.       */
+	std::vector<uint8_t>                                  m_payload;    /**< The predicates on the payload.              */
+	std::unordered_map<std::string, std::vector<uint8_t>> m_children;   /**< The predicates on each child by child name. */
+	std::vector<uint64_t>                                 m_masks;      /**< The predicates required by each rule.       */
+	std::vector<Port*>                                    m_outputs;    /**< The output port of each rule.               */
+	std::size_t                                           m_unmatched;  /**< The number of messages not matching.        */
+	Node                                                  m_message;    /**< The message being routed.                   */
+};
+
+#endif // DATAFLOW_COMPONENTS_DF_ROUTER_H_INCLUDED
@@ -1,5 +1,8 @@
 #include "df_thingspeak_read.h"
 
+// Project includes
+#include "node_json.h"
+
 DF_ThingspeakRead::DF_ThingspeakRead(uint64_t channelID, uint8_t fieldID, const std::string& readKey)
 	: m_channelID(channelID), m_fieldID(fieldID), m_client(readKey)
 {
@@ -23,8 +26,9 @@ void DF_ThingspeakRead::process()
 		// Creating new message
 		message.clear();
 
-		// Writing query to the output
-		message["query"] = query;
+		// Writing query to the output, as structured data when the field contains JSON
+		// (other bodies are shared, so forwarding the message does not copy them)
+		if(!NodeJson::parse(query, message["query"])) message["query"] = SharedString(query);
 		m_ports["out"].send(message);
 	}
 }
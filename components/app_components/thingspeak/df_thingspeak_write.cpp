@@ -4,6 +4,7 @@ DF_ThingspeakWrite::DF_ThingspeakWrite(const std::string& writeKey)
 	: m_client("", writeKey)
 {
 	m_ports.addInputPort("in");
+	m_ports.addOutputPort("out");
 }
 
 void DF_ThingspeakWrite::process()
@@ -22,7 +23,9 @@ void DF_ThingspeakWrite::process()
 			update.setField(i + 1, message["update"][i]);
 		}
 
-		// Sending the update
-		m_client.writeChannel(update);
+		// Sending the update, forwarding the message when it is accepted (eg. as an acknowledgement)
+		if(m_client.writeChannel(update) && m_ports["out"].hasSubscribers()) {
+			m_ports["out"].send(message);
+		}
 	}
 }
@@ -5,6 +5,17 @@
 #include "dataflow.h"
 #include "thingspeak.h"
 
+/**
+ * This class writes the "update" array of the received messages to the fields of
+ * a ThingSpeak channel.
+ *
+ * Ports:
+ *
+ * [input] "in"   - Used to receive the updates to write.
+ *
+ * [output] "out" - Used to send the messages written successfully, eg. to acknowledge
+ *                  them to a DF_DurableQueue.
+ */
 class DF_ThingspeakWrite : public Component {
 public:
 
@@ -16,4 +27,4 @@ private:
 	ThingSpeakClient m_client;
 };
 
-#endif // DATAFLOW_COMPONENTS_DF_THINGSPEAK_READ_H_INCLUDED
+#endif // DATAFLOW_COMPONENTS_DF_THINGSPEAK_WRITE_H_INCLUDED
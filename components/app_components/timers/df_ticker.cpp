@@ -0,0 +1,60 @@
+#include "df_ticker.h"
+
+DF_Ticker::DF_Ticker(uint32_t period_ms, uint32_t phase_ms)
+	: m_message("tick"), m_period_ms(period_ms), m_phase_ms(phase_ms), m_missed(0), m_ticks(0), m_overruns(0), m_maxLate(0), m_totalLate(0)
+{
+	// Adding the output port, and the timer port holding a single expiration, so the
+	// expirations of a delayed ticker are dropped by the timer and counted as overruns
+	m_ports.addOutputPort("out");
+	m_ports.addInputPort("timer", 1);
+
+	m_ports["timer"].setInternal(true);
+	m_timer.setTarget(m_ports["timer"], Node("timer"));
+}
+
+void DF_Ticker::process()
+{
+	// Converting the schedule to RTOS ticks
+	TickType_t period = pdMS_TO_TICKS(m_period_ms);
+	if(period == 0) period = 1;
+	TickType_t phase = pdMS_TO_TICKS(m_phase_ms) % period;
+
+	// Starting on the next tick of the common schedule, so every ticker is aligned to it.
+	// The expirations missed while the flow was stopped are not overruns
+	TickType_t now = xTaskGetTickCount();
+	m_timer.start(period - (now - phase) % period, period);
+	m_missed = m_timer.missed();
+
+	// Ticking until the flow is stopped, which closes the timer port
+	Node expiry;
+	while(!finished() && m_ports["timer"].receive(expiry)) {
+
+		// Counting the ticks skipped while the ticker was delayed for whole periods
+		uint32_t missed = m_timer.missed();
+		m_overruns += missed - m_missed;
+		m_missed = missed;
+
+		// The ticks are aligned to the schedule, so the delay is the time since the last one
+		TickType_t late = (xTaskGetTickCount() - phase) % period;
+
+		// Updating the timing statistics
+		uint32_t sequence = m_ticks++;
+		m_totalLate += late;
+		if(late > m_maxLate) m_maxLate = late;
+
+		// Sending the tick message
+		m_message["sequence"] = (double) sequence;
+		m_message["late_ms"] = (double) (late * portTICK_PERIOD_MS);
+		m_ports["out"].send(m_message);
+	}
+
+	m_timer.stop();
+}
+
+DF_Ticker::Stats DF_Ticker::stats() const noexcept
+{
+	uint32_t ticks = m_ticks;
+	uint32_t average = (ticks > 0) ? m_totalLate * portTICK_PERIOD_MS / ticks : 0;
+
+	return Stats{ ticks, m_overruns.load(), m_maxLate * portTICK_PERIOD_MS, average };
+}
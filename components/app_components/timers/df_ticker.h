@@ -0,0 +1,84 @@
+#pragma once
+#ifndef DATAFLOW_COMPONENTS_DF_TICKER_H_INCLUDED
+#define DATAFLOW_COMPONENTS_DF_TICKER_H_INCLUDED
+
+// Standard includes
+#include <atomic>
+
+// FreeRTOS includes
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Project includes
+#include "dataflow.h"
+#include "timer.h"
+
+
+/**
+ * This class implements a periodic source of tick messages, eg. to trigger the
+ * sampling of sensors. The ticks are scheduled by a periodic Timer of the timer
+ * service on absolute times, so delays of the task or of the receivers do not
+ * accumulate, and the expirations are delivered to the task through an internal
+ * port.
+ *
+ * The schedule of every ticker is aligned to the tick count of the scheduler:
+ * a ticker fires on the ticks where (tick - phase) is a multiple of the period.
+ * Tickers with the same phase and commensurate periods (eg. 1 s sampling and 5 s
+ * display refresh) therefore wake up on the same tick, batching their work into
+ * the same wake window, while different phases spread the work deliberately.
+ *
+ * Ports:
+ *
+ * [output] "out" - Used to send the tick messages, which contain the "sequence"
+ *                  number of the tick and the "late_ms" time the tick was sent
+ *                  after its scheduled time.
+ *
+ * Ticks later than a whole period (eg. when the receivers block the ticker) are
+ * skipped to keep the schedule, and counted as overruns (see stats()). Stopping
+ * the flow closes the internal port, which wakes up the ticker right away.
+ */
+class DF_Ticker : public Component {
+public:
+
+	/**
+	 * The Stats structure stores the timing statistics of the ticker.
+	 */
+	struct Stats {
+		uint32_t m_ticks;     /**< The number of ticks sent.                          */
+		uint32_t m_overruns;  /**< The number of ticks skipped.                       */
+		uint32_t m_maxLateMs; /**< The longest delay of a tick after its schedule.    */
+		uint32_t m_avgLateMs; /**< The average delay of the ticks after their schedule. */
+	};
+
+	/**
+	 * Constructs a DF_Ticker.
+	 * @param period_ms [in] The period of the ticks in milliseconds.
+	 * @param phase_ms  [in] The offset of the ticks from the common schedule in milliseconds.
+	 */
+	DF_Ticker(uint32_t period_ms, uint32_t phase_ms = 0);
+
+	/**
+	 * Sends the tick messages on schedule.
+	 */
+	virtual void process() override;
+
+	/**
+	 * Queries the timing statistics of the ticker, which show the jitter of the
+	 * ticks caused by higher priority tasks or blocking receivers.
+	 * @return The statistics of the ticks sent so far.
+	 */
+	Stats stats() const noexcept;
+
+private:
+	Node                  m_message;   /**< The tick message, kept off the stack of the task. */
+	uint32_t              m_period_ms;
+	uint32_t              m_phase_ms;
+	Timer                 m_timer;     /**< The periodic timer scheduling the ticks.   */
+	uint32_t              m_missed;    /**< The missed expirations already counted.    */
+	std::atomic<uint32_t> m_ticks;     /**< The number of ticks sent.                  */
+	std::atomic<uint32_t> m_overruns;  /**< The number of ticks skipped.               */
+	std::atomic<uint32_t> m_maxLate;   /**< The longest delay of a tick in RTOS ticks. */
+	std::atomic<uint32_t> m_totalLate; /**< The sum of the delays in RTOS ticks.       */
+};
+
+#endif // DATAFLOW_COMPONENTS_DF_TICKER_H_INCLUDED
@@ -2,9 +2,8 @@
 #ifndef DATAFLOW_COMPONENTS_DF_WATCHDOG_H_INCLUDED
 #define DATAFLOW_COMPONENTS_DF_WATCHDOG_H_INCLUDED
 
-#include "freertos/FreeRTOS.h"
-#include "freertos/timers.h"
 #include "dataflow.h"
+#include "timer.h"
 
 class DF_Watchdog : public Component {
 public:
@@ -14,10 +13,8 @@ public:
 	virtual void process() override;
 
 private:
-	uint64_t      m_period_ms;
-	TimerHandle_t m_timerHandle;
-
-	static void watchdog_callback(TimerHandle_t timer);
+	uint64_t m_period_ms;
+	Timer    m_timer;
 };
 
 #endif // DATAFLOW_COMPONENTS_DF_WATCHDOG_H_INCLUDED
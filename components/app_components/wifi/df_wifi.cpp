@@ -22,6 +22,6 @@ void DF_WifiConnect::process()
 	// Sending output message indicating success or failure
 	m_ports["out"].send(Node("connected", successful));
 
-	// Suspending execution indifinitely
-	vTaskSuspend(xTaskGetCurrentTaskHandle());
+	// Finishing the component, which returns the stack of its task
+	finish();
 }
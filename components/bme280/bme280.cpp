@@ -14,6 +14,13 @@ void BME280::setDriverInterface(DriverInterface* interface)
 }
 
 void BME280::initialize()
+{
+	// Reading the calibration constants, then setting up the device
+	readCalibration();
+	configure();
+}
+
+void BME280::readCalibration()
 {
 	// Reading calibration data
 	uint8_t calibDataLow[BME280_CALIBRATION_REGS_LOW_COUNT];
@@ -44,7 +51,10 @@ void BME280::initialize()
 	m_calibration.dig_H4 = (int16_t) (calibDataHigh[4] | 0x0F) | (int16_t) calibDataHigh[3] << 4;
 	m_calibration.dig_H5 = (int16_t) (calibDataHigh[4] | 0xF0) | (int16_t) calibDataHigh[5] << 4;
 	m_calibration.dig_H6 = (int8_t)   calibDataHigh[6];
+}
 
+void BME280::configure()
+{
 	// Performing software reset
 	reset();
 
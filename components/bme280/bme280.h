@@ -270,6 +270,16 @@ public:
 	 */
 	void initialize();
 
+	/**
+	 * Reads the calibration constants of the device.
+	 */
+	void readCalibration();
+
+	/**
+	 * Resets the device and enables all of the measurements, keeping the calibration constants.
+	 */
+	void configure();
+
 	/**
 	 * Resets the device to the factory default state.
 	 */
@@ -385,23 +395,7 @@ public:
 	 */
 	HumidityOversampling get_humidity_oversampling();
 
-private:
-
-	/**
-	 * Reads the specified number of register values (address auto-incremented).
-	 * @param registerAddress [in]  The starting register address.
-	 * @param buffer          [out] The buffer where register values are stored.
-	 * @param byteCount	      [in]  The number of registers to read.
-	 */
-	void register_read(uint8_t registerAddress, uint8_t buffer[], uint8_t byteCount);
-
-	/**
-	 * Writes the specified number of register values (address auto-incremented).
-	 * @param registerAddress [in] The starting register address.
-	 * @param buffer          [in] The values to write into the registers.
-	 * @param byteCount       [in] The number of values to write.
-	 */
-	void register_write(uint8_t registerAddress, const uint8_t buffer[], uint8_t byteCount);
+protected:
 
 	/**
 	 * This structure holds the calibration constants for the different measurements.
@@ -428,8 +422,27 @@ private:
 		int32_t  t_fine; /**< Holds the fine temperature compensation value.     */
 	};
 
-	DriverInterface*  m_interface;   /**< Communication interface. */
 	CalibrationStruct m_calibration; /**< Calibration constants    */
+
+private:
+
+	/**
+	 * Reads the specified number of register values (address auto-incremented).
+	 * @param registerAddress [in]  The starting register address.
+	 * @param buffer          [out] The buffer where register values are stored.
+	 * @param byteCount	      [in]  The number of registers to read.
+	 */
+	void register_read(uint8_t registerAddress, uint8_t buffer[], uint8_t byteCount);
+
+	/**
+	 * Writes the specified number of register values (address auto-incremented).
+	 * @param registerAddress [in] The starting register address.
+	 * @param buffer          [in] The values to write into the registers.
+	 * @param byteCount       [in] The number of values to write.
+	 */
+	void register_write(uint8_t registerAddress, const uint8_t buffer[], uint8_t byteCount);
+
+	DriverInterface*  m_interface;   /**< Communication interface. */
 };
 
 #endif // BME280_BME280_H_INCLUDED
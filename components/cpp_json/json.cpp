@@ -1,5 +1,8 @@
 #include "json.h"
 
+// Standard includes
+#include <utility>
+
 /**
  * Parses the provided string and constructs a JsonObject from it.
  * @param  json [in] The JSON object in string format.
@@ -310,6 +313,24 @@ const JsonObject JsonObject::operator[](std::size_t index) const
 	return JsonObject(cJSON_GetArrayItem(m_object, index), false);
 }
 
+/**
+ * Queries the number of items in an array or object.
+ * @return The number of items, or zero for other types.
+ */
+std::size_t JsonObject::size() const
+{
+	return (isArray() || isObject()) ? cJSON_GetArraySize(m_object) : 0;
+}
+
+/**
+ * Queries the name of this object when it is a member of another object.
+ * @return The name of this object, or an empty string for unnamed and NULL objects.
+ */
+std::string JsonObject::name() const
+{
+	return ((m_object != nullptr) && (m_object->string != nullptr)) ? std::string(m_object->string) : std::string();
+}
+
 // Getting data from JSON objects
 
 /**
@@ -373,6 +394,15 @@ JsonObject::JsonObject(const JsonObject& other)
 	: m_object(cJSON_Duplicate(other.m_object, true)), m_isRoot(other.m_isRoot)
 {}
 
+JsonObject& JsonObject::operator=(JsonObject other) noexcept
+{
+	// Taking over the copy, the previous item is released with the parameter
+	std::swap(m_object, other.m_object);
+	std::swap(m_isRoot, other.m_isRoot);
+
+	return *this;
+}
+
 JsonObject::~JsonObject()
 {
 	//if(m_isRoot) cJSON_Delete(m_object);
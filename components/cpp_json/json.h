@@ -84,6 +84,15 @@ public:
 	 */
 	JsonObject(const JsonObject& other);
 
+	/**
+	 * Assigns a deep copy of the other object to this object (copy-and-swap). The
+	 * copy is made when the parameter is constructed, so temporaries (eg. the result
+	 * of operator[]) are taken over without copying them.
+	 * @param  other [in] The other JSON object to assign.
+	 * @return Reference to this object.
+	 */
+	JsonObject& operator=(JsonObject other) noexcept;
+
 	// Type-checking for objects
 
 	/**
@@ -226,6 +235,18 @@ public:
 	 */
 	const JsonObject operator[](std::size_t index) const;
 
+	/**
+	 * Queries the number of items in an array or object.
+	 * @return The number of items, or zero for other types.
+	 */
+	std::size_t size() const;
+
+	/**
+	 * Queries the name of this object when it is a member of another object.
+	 * @return The name of this object, or an empty string for unnamed and NULL objects.
+	 */
+	std::string name() const;
+
 	// Getting data from JSON objects
 
 	/**
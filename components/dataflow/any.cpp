@@ -1,27 +1,32 @@
 #include "any.hpp"
 
-any::any() noexcept : m_object(nullptr), m_vtable(nullptr) {}
+// Standard includes
+#include <cstring>
 
-any::any(const any& other) : m_object(nullptr), m_vtable(other.m_vtable)
+any::any() noexcept : m_vtable(nullptr), m_object(nullptr) {}
+
+any::any(const any& other) : m_vtable(other.m_vtable), m_object(nullptr)
 {
     // Checking if there is a value to copy without Small-Buffer-Optimalization
-    if(other.m_vtable && m_vtable->m_size > sizeof(void*)) {
+    if(other.m_vtable && !m_vtable->m_inline) {
         m_vtable->m_cloneFunction(this, other.m_object);
     }
 
     // Checking if there is a value to copy with Small-Buffer-Optimalization
-    else if(other.m_vtable && m_vtable->m_size <= sizeof(void*)) {
+    else if(other.m_vtable && m_vtable->m_inline) {
         m_vtable->m_cloneFunction(this, &other.m_object);
     }
 }
 
-any::any(any&& other) noexcept : m_object(other.m_object), m_vtable(other.m_vtable)
+any::any(any&& other) noexcept : m_vtable(other.m_vtable), m_object(nullptr)
 {
-    other.m_object = nullptr;
+    // Moving the value from the other any object
+    if(m_vtable) m_vtable->m_moveFunction(this, &other);
+
     other.m_vtable = nullptr;
 }
 
-any::any(const char* string) : any((std::string) string) {}
+any::any(const char* string) : any(SmallString(string)) {}
 
 any& any::operator=(const any& other)
 {
@@ -29,12 +34,12 @@ any& any::operator=(const any& other)
     if(&other == this) return *this;
 
     // Checking if there is a value to delete without Small-Buffer-Optimalization
-    if(m_vtable && m_vtable->m_size > sizeof(void*)) {
+    if(m_vtable && !m_vtable->m_inline) {
         m_vtable->m_deleteFunction(m_object);
     }
 
     // Checking if there is a value to copy with Small-Buffer-Optimalization
-    else if(m_vtable && m_vtable->m_size <= sizeof(void*)) {
+    else if(m_vtable && m_vtable->m_inline) {
         m_vtable->m_deleteFunction(&m_object);
     }
 
@@ -42,12 +47,12 @@ any& any::operator=(const any& other)
     m_vtable = other.m_vtable;
 
     // Checking if there is a value to copy without Small-Buffer-Optimalization
-    if(other.m_vtable && m_vtable->m_size > sizeof(void*)) {
+    if(other.m_vtable && !m_vtable->m_inline) {
         m_vtable->m_cloneFunction(this, other.m_object);
     }
 
     // Checking if there is a value to copy with Small-Buffer-Optimalization
-    else if(other.m_vtable && m_vtable->m_size <= sizeof(void*)) {
+    else if(other.m_vtable && m_vtable->m_inline) {
         m_vtable->m_cloneFunction(this, &other.m_object);
     }
 
@@ -60,19 +65,12 @@ any& any::operator=(any&& other) noexcept
     // Checking self-assignment
     if(&other == this) return *this;
 
-    // Checking if there is a value to delete without Small-Buffer-Optimalization
-    if(m_vtable && m_vtable->m_size > sizeof(void*)) {
-        m_vtable->m_deleteFunction(m_object);
-    }
-
-    // Checking if there is a value to copy with Small-Buffer-Optimalization
-    else if(m_vtable && m_vtable->m_size <= sizeof(void*)) {
-        m_vtable->m_deleteFunction(&m_object);
-    }
+    // Deleting the currently stored value
+    reset();
 
-    // Moving data from the other any object
+    // Moving the value from the other any object
     m_vtable = other.m_vtable;
-    m_object = other.m_object;
+    if(m_vtable) m_vtable->m_moveFunction(this, &other);
 
     // Clearing the other any object
     other.m_vtable = nullptr;
@@ -83,8 +81,8 @@ any& any::operator=(any&& other) noexcept
 
 any& any::operator=(const char* value)
 {
-    // Delegating to the std::string specialized assignment
-    return operator=((std::string) value);
+    // Delegating to the SmallString specialized assignment
+    return operator=(SmallString(value));
 }
 
 any::~any()
@@ -95,10 +93,10 @@ any::~any()
 void any::reset() noexcept
 {
     // Deleting the stored value with Small-Buffer-Optimalization
-    if(m_vtable && m_vtable->m_size <= sizeof(void*)) m_vtable->m_deleteFunction(&m_object);
+    if(m_vtable && m_vtable->m_inline) m_vtable->m_deleteFunction(&m_object);
 
     // Deleting the stored value without Small-Buffer-Optimalization
-    else if(m_vtable && m_vtable->m_size > sizeof(void*)) m_vtable->m_deleteFunction(m_object);
+    else if(m_vtable && !m_vtable->m_inline) m_vtable->m_deleteFunction(m_object);
 
     // Resetting object and VTABLE pointers
     m_vtable = nullptr;
@@ -110,6 +108,90 @@ bool any::has_value() const noexcept
     return (m_vtable != nullptr);
 }
 
+const char* any::string_data(std::size_t* size) const noexcept
+{
+    const char* data = nullptr;
+    std::size_t length = 0;
+
+    // Checking the string types one by one
+    if(const std::string* value = get<std::string>())       { data = value->c_str(); length = value->size(); }
+    else if(const SmallString* value = get<SmallString>())   { data = value->c_str(); length = value->size(); }
+    else if(const SharedString* value = get<SharedString>()) { data = value->c_str(); length = value->size(); }
+
+    if(size != nullptr) *size = length;
+    return data;
+}
+
+bool any::get_number(double& value) const noexcept
+{
+    // Checking the arithmetic types one by one, the most common ones first
+    if(const double* number = get<double>())                              value = *number;
+    else if(const float* number = get<float>())                           value = *number;
+    else if(const int* number = get<int>())                               value = *number;
+    else if(const unsigned* number = get<unsigned>())                     value = *number;
+    else if(const long* number = get<long>())                             value = *number;
+    else if(const unsigned long* number = get<unsigned long>())           value = *number;
+    else if(const long long* number = get<long long>())                   value = *number;
+    else if(const unsigned long long* number = get<unsigned long long>()) value = *number;
+    else if(const short* number = get<short>())                           value = *number;
+    else if(const unsigned short* number = get<unsigned short>())         value = *number;
+    else return false;
+
+    return true;
+}
+
+any::operator std::string()
+{
+    std::size_t size = 0;
+    const char* data = string_data(&size);
+
+#if defined(EXCEPTIONS_ENABLED)
+
+    // Values of other types can not be converted
+    if(data == nullptr) throw std::bad_cast();
+
+#endif
+
+    return (data != nullptr) ? std::string(data, size) : std::string();
+}
+
+bool any::equals(const any& other) const noexcept
+{
+    // Values of different types are never equal, except for the string types
+    if(m_vtable != other.m_vtable) {
+        std::size_t size = 0, otherSize = 0;
+        const char* data = string_data(&size);
+        const char* otherData = other.string_data(&otherSize);
+
+        return data != nullptr && otherData != nullptr && size == otherSize && memcmp(data, otherData, size) == 0;
+    }
+
+    // Empty objects are equal, others are compared by the type specific comparator
+    return (m_vtable == nullptr) || m_vtable->m_equalFunction(this, &other);
+}
+
+uint32_t any::hash() const noexcept
+{
+    // Empty objects have the hash of the empty data
+    if(m_vtable == nullptr) return hashBytes(nullptr, 0);
+
+    // Delegating the hashing to the type specific hasher
+    return m_vtable->m_hashFunction(this);
+}
+
+uint32_t any::hashBytes(const void* data, std::size_t size, uint32_t hash) noexcept
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+    // Hashing the bytes one by one
+    for(std::size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
 #if defined(RTTI_ENABLED)
 
 const std::type_info& any::type() const noexcept
@@ -121,14 +203,14 @@ const std::type_info& any::type() const noexcept
     return *m_vtable->m_typeInfo;
 }
 
-any::VTable::VTable(deleteFunction fpDelete, cloneFunction fpClone, printFunction fpPrint, std::size_t size, typeInfo* typeInfo)
-    : m_deleteFunction(fpDelete), m_cloneFunction(fpClone), m_printFunction(fpPrint), m_size(size), m_typeInfo(typeInfo)
+any::VTable::VTable(deleteFunction fpDelete, cloneFunction fpClone, moveFunction fpMove, printFunction fpPrint, equalFunction fpEqual, hashFunction fpHash, std::size_t size, bool isInline, typeInfo* typeInfo)
+    : m_deleteFunction(fpDelete), m_cloneFunction(fpClone), m_moveFunction(fpMove), m_printFunction(fpPrint), m_equalFunction(fpEqual), m_hashFunction(fpHash), m_size(size), m_inline(isInline), m_typeInfo(typeInfo)
 {}
 
 #else
 
-any::VTable::VTable(deleteFunction fpDelete, cloneFunction fpClone, printFunction fpPrint, std::size_t size)
-    : m_deleteFunction(fpDelete), m_cloneFunction(fpClone), m_printFunction(fpPrint), m_size(size)
+any::VTable::VTable(deleteFunction fpDelete, cloneFunction fpClone, moveFunction fpMove, printFunction fpPrint, equalFunction fpEqual, hashFunction fpHash, std::size_t size, bool isInline)
+    : m_deleteFunction(fpDelete), m_cloneFunction(fpClone), m_moveFunction(fpMove), m_printFunction(fpPrint), m_equalFunction(fpEqual), m_hashFunction(fpHash), m_size(size), m_inline(isInline)
 {}
 
 #endif
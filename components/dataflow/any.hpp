@@ -34,6 +34,21 @@
 #include <typeinfo>
 #include <iostream>
 #include <string>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <new>
+
+// Project includes
+#include "small_string.hpp"
+#include "heap.h"
+
+// Size of the inline storage of any objects, smaller values are stored without
+// allocation (by default fitting SmallString, double and 64-bit integers)
+#ifndef DATAFLOW_ANY_INLINE_SIZE
+#define DATAFLOW_ANY_INLINE_SIZE (SmallString::SIZE)
+#endif
 
 
 /**
@@ -52,6 +67,22 @@ struct is_printable: std::false_type {};
 template<typename T>
 struct is_printable<T, decltype(std::cout << std::declval<T>(), void())> : std::true_type {};
 
+/**
+ * @brief The is_equality_comparable traits class is used to determine if values
+ *        of a specific type are comparable with operator==. This class serves
+ *        as the base type for incomparable types.
+ */
+template<typename T, typename = void>
+struct is_equality_comparable: std::false_type {};
+
+/**
+ * @brief This template specialization of the is_equality_comparable traits class
+ *        implements the compile-time logic to decide if a specific type is
+ *        comparable with operator==.
+ */
+template<typename T>
+struct is_equality_comparable<T, decltype(std::declval<const T&>() == std::declval<const T&>(), void())> : std::true_type {};
+
 
 /**
  * @brief The any class implements a type-safe generic storage class which is
@@ -87,14 +118,15 @@ public:
      * @param value [in] The value to store in the constructed any object.
      */
     template <class Type>
-    explicit any(Type&& value) : m_object(nullptr), m_vtable(nullptr)
+    explicit any(Type&& value) : m_vtable(nullptr), m_object(nullptr)
     {
         // Making a copy of the supplied value (reference and CV qualifiers removed)
         helper<typename std::decay<Type>::type>(value, Action::SET);
     }
 
     /**
-     * @brief Constructs an any object from a C-string by using std::string.
+     * @brief Constructs an any object from a C-string by using SmallString, so
+     *        short strings are stored without allocation.
      * @param string [in] The C-string to construct the any object from.
      */
     any(const char* string);
@@ -127,7 +159,7 @@ public:
     }
 
     /**
-     * @brief  Assigns a new C-string to this any object.
+     * @brief  Assigns a new C-string to this any object (stored as SmallString).
      * @param  value [in] The string to store in this object.
      * @return Reference to this object for chaining assignments.
      */
@@ -182,6 +214,64 @@ public:
 
 #endif
 
+    /**
+     * @brief  Queries the stored value without copying it, when it has the specified type.
+     *         Unlike the conversion operator, this does not throw on mismatching types.
+     * @return Pointer to the stored value, or nullptr when the type is not matching.
+     */
+    template <class Type>
+    const Type* get() const noexcept
+    {
+        using type = typename std::decay<Type>::type;
+
+        // Checking if the types are matching by comparing VTABLE pointers
+        if(m_vtable == nullptr || m_vtable != vtableOf<type>()) return nullptr;
+
+        // Returning the stored object (Small-Object-Optimalization)
+        if(is_inline<type>::value) return reinterpret_cast<const type*>(&m_object);
+
+        // Returning the the stored object (No optimalization)
+        return static_cast<const type*>(m_object);
+    }
+
+    /**
+     * @brief  Queries the characters of the stored string, which may be of any of
+     *         the string types: std::string, SmallString and SharedString.
+     * @param  size [out] The length of the string, when not nullptr.
+     * @return Pointer to the null-terminated characters, or nullptr when no string is stored.
+     */
+    const char* string_data(std::size_t* size = nullptr) const noexcept;
+
+    /**
+     * @brief  Queries the stored value as a double, which may be of any of the
+     *         arithmetic types except bool and the character types.
+     * @param  value [out] The stored value converted to double.
+     * @return True when a number is stored, false leaves value unchanged.
+     */
+    bool get_number(double& value) const noexcept;
+
+    /**
+     * @brief Converts the stored string of any of the string types to std::string,
+     *        or throws an exception when the stored value is not a string.
+     */
+    explicit operator std::string();
+
+    /**
+     * @brief  Compares the value stored in this object to the value of another object.
+     * @param  other [in] The other any object to compare to.
+     * @return True when both objects are empty, or store equal values of the same
+     *         type. Values of types without operator== are never equal.
+     */
+    bool equals(const any& other) const noexcept;
+
+    /**
+     * @brief  Calculates a hash of the stored value, equal values have equal hashes.
+     *         Arithmetic, enumeration, pointer and std::string values are hashed,
+     *         values of other types are not (they hash like empty objects).
+     * @return The 32-bit FNV-1a hash of the stored value.
+     */
+    uint32_t hash() const noexcept;
+
     /**
      * @brief Converts this any object to the specified type when applicable,
      *        or throws an exception on invalid type conversions.
@@ -193,8 +283,40 @@ public:
         return helper<typename std::decay<Type>::type>(Type{}, Action::GET);
     }
 
+protected:
+
+    /**
+     * @brief  Continues a 32-bit FNV-1a hash with the specified bytes.
+     * @param  data [in] Pointer to the bytes to hash.
+     * @param  size [in] The number of bytes to hash.
+     * @param  hash [in] The hash of the preceding data (the offset basis to start).
+     * @return The hash including the bytes.
+     */
+    static uint32_t hashBytes(const void* data, std::size_t size, uint32_t hash = 2166136261u) noexcept;
+
 private:
 
+    // Size and alignment of the storage of in-place values
+    static const std::size_t INLINE_SIZE = (DATAFLOW_ANY_INLINE_SIZE > sizeof(void*)) ? DATAFLOW_ANY_INLINE_SIZE : sizeof(void*);
+    static const std::size_t INLINE_ALIGNMENT = (alignof(double) > alignof(void*)) ? alignof(double) : alignof(void*);
+
+    /**
+     * @brief The is_inline traits class decides whether values of a type are stored
+     *        in-place (Small-Buffer-Optimalization): they have to fit the storage,
+     *        and moving them must not throw, as moving any objects does not throw.
+     */
+    template <class Type>
+    struct is_inline : std::integral_constant<bool, sizeof(Type) <= INLINE_SIZE && alignof(Type) <= INLINE_ALIGNMENT &&
+                                                    std::is_nothrow_move_constructible<Type>::value> {};
+
+    /**
+     * @brief The is_string traits class decides whether a type is one of the string types.
+     */
+    template <class Type>
+    struct is_string : std::integral_constant<bool, std::is_same<Type, std::string>::value ||
+                                                    std::is_same<Type, SmallString>::value ||
+                                                    std::is_same<Type, SharedString>::value> {};
+
     /**
      * @brief The Action enum defines the possible operations on the stored values.
      */
@@ -208,7 +330,7 @@ private:
     static void deleteFunction(void* object)
     {
         // Checking if the value was stored with Small-Buffer-Optimalization
-        if (sizeof(Type) <= sizeof(void*)) {
+        if (is_inline<Type>::value) {
 
             // Invoking the destructor of the value for manual cleanup,
             // no memory deallocation needs to take place
@@ -219,7 +341,8 @@ private:
         else {
 
             // Calling the destructor and releasing memory of the value
-            delete static_cast<Type*>(object);
+            static_cast<Type*>(object)->~Type();
+            Allocator::deallocate(object);
         }
     }
 
@@ -229,10 +352,22 @@ private:
      * @param  value  [in] Pointer to the value, type safety is maintained via the VTABLE.
      */
     template <class Type>
-    static auto cloneFunction(any* object, const void* value) -> typename std::enable_if<(sizeof(Type) > sizeof(void*)), void>::type
+    static auto cloneFunction(any* object, const void* value) -> typename std::enable_if<!is_inline<Type>::value, void>::type
     {
-        // Making a dynamically allocated copy (not using Small-Object-Optimalization)
-        object->m_object = new Type(*static_cast<const Type*>(value));
+        // Making a dynamically allocated copy (not using Small-Object-Optimalization),
+        // the memory is obtained through the Allocator for the heap telemetry
+        void* memory = Allocator::allocate(sizeof(Type));
+
+#if defined(EXCEPTIONS_ENABLED)
+
+        try { object->m_object = new (memory) Type(*static_cast<const Type*>(value)); }
+        catch(...) { Allocator::deallocate(memory); throw; }
+
+#else
+
+        object->m_object = new (memory) Type(*static_cast<const Type*>(value));
+
+#endif
     }
 
     /**
@@ -241,12 +376,39 @@ private:
      * @param  value  [in] Pointer to the value, type safety is maintained via the VTABLE.
      */
     template <class Type>
-    static auto cloneFunction(any* object, const void* value) -> typename std::enable_if<(sizeof(Type) <= sizeof(void*)), void>::type
+    static auto cloneFunction(any* object, const void* value) -> typename std::enable_if<is_inline<Type>::value, void>::type
     {
         // Making an in-place copy of the value stored instead of the m_object pointer
         new (&(object->m_object)) Type(*static_cast<const Type*>(value));
     }
 
+    /**
+     * @brief  Moves the dynamically allocated value of an any object to another one.
+     * @param  object [in] Pointer to the empty any object, to move the value to.
+     * @param  other  [in] Pointer to the any object, to move the value from.
+     */
+    template <class Type>
+    static auto moveFunction(any* object, any* other) noexcept -> typename std::enable_if<!is_inline<Type>::value, void>::type
+    {
+        // Taking over the pointer of the value
+        object->m_object = other->m_object;
+        other->m_object = nullptr;
+    }
+
+    /**
+     * @brief  Moves the in-place value of an any object to another one.
+     * @param  object [in] Pointer to the empty any object, to move the value to.
+     * @param  other  [in] Pointer to the any object, to move the value from.
+     */
+    template <class Type>
+    static auto moveFunction(any* object, any* other) noexcept -> typename std::enable_if<is_inline<Type>::value, void>::type
+    {
+        // Move constructing the value in-place, then destroying the moved-from value
+        Type* value = reinterpret_cast<Type*>(&(other->m_object));
+        new (&(object->m_object)) Type(std::move(*value));
+        value->~Type();
+    }
+
     /**
      * @brief  Prints the value stored in the any object to the specified std::ostream.
      * @param  stream [in] The stream to print the value to.
@@ -256,7 +418,7 @@ private:
     template <class Type>
     static auto printFunction(std::ostream& stream, const any* object) -> typename std::enable_if<is_printable<Type>::value, std::ostream&>::type
     {
-        if(sizeof(Type) <= sizeof(void*)) return stream << *reinterpret_cast<const Type*>(&(object->m_object));
+        if(is_inline<Type>::value) return stream << *reinterpret_cast<const Type*>(&(object->m_object));
 
         return stream << *static_cast<Type*>(object->m_object);
     }
@@ -277,6 +439,75 @@ private:
         (void)(object);
     }
 
+    /**
+     * @brief  Compares the values stored in two any objects of the same type.
+     * @param  left  [in] Pointer to the first any object.
+     * @param  right [in] Pointer to the second any object.
+     * @return True when the values are equal.
+     */
+    template <class Type>
+    static auto equalFunction(const any* left, const any* right) -> typename std::enable_if<is_equality_comparable<Type>::value, bool>::type
+    {
+        return *left->get<Type>() == *right->get<Type>();
+    }
+
+    /**
+     * @brief  Compares the values stored in two any objects (used only for incomparable value types).
+     * @param  left  [in] Pointer to the first any object.
+     * @param  right [in] Pointer to the second any object.
+     * @return False, the values can not be compared.
+     */
+    template <class Type>
+    static auto equalFunction(const any* left, const any* right) -> typename std::enable_if<!is_equality_comparable<Type>::value, bool>::type
+    {
+        // Suppress compiler warning for unused variables
+        (void)(left);
+        (void)(right);
+
+        return false;
+    }
+
+    /**
+     * @brief  Hashes the value stored in the any object (used for scalar value types).
+     * @param  object [in] Pointer to the any object to hash.
+     * @return The hash of the value.
+     */
+    template <class Type>
+    static auto hashFunction(const any* object) -> typename std::enable_if<std::is_arithmetic<Type>::value || std::is_enum<Type>::value || std::is_pointer<Type>::value, uint32_t>::type
+    {
+        // Normalizing negative zero, which equals to positive zero
+        Type value = *object->get<Type>();
+        if(std::is_floating_point<Type>::value && value == Type{}) value = Type{};
+
+        return hashBytes(&value, sizeof(Type));
+    }
+
+    /**
+     * @brief  Hashes the characters of the string stored in the any object, so
+     *         equal strings have equal hashes regardless of the string type.
+     * @param  object [in] Pointer to the any object to hash.
+     * @return The hash of the value.
+     */
+    template <class Type>
+    static auto hashFunction(const any* object) -> typename std::enable_if<is_string<Type>::value, uint32_t>::type
+    {
+        return hashBytes(object->get<Type>()->data(), object->get<Type>()->size());
+    }
+
+    /**
+     * @brief  Hashes the value stored in the any object (used for other value types).
+     * @param  object [in] Pointer to the any object to hash.
+     * @return The hash of the empty value, the value itself is not hashed.
+     */
+    template <class Type>
+    static auto hashFunction(const any* object) -> typename std::enable_if<!std::is_arithmetic<Type>::value && !std::is_enum<Type>::value && !std::is_pointer<Type>::value && !is_string<Type>::value, uint32_t>::type
+    {
+        // Suppress compiler warning for unused variable
+        (void)(object);
+
+        return hashBytes(nullptr, 0);
+    }
+
     // Friend declaration for printing any objects to an output stream
     friend std::ostream& operator<<(std::ostream&, const any&);
 
@@ -290,10 +521,8 @@ private:
     template <class Type>
     Type helper(Type value, Action action)
     {
-        // Static Virtual Table unique to every type used with any objects.
-        // It stores function pointers for deleting and copying specific types
-        // for the contained values and other type specific information
-        static VTableTyped<Type> vtable;
+        // Static Virtual Table unique to every type used with any objects
+        VTable* vtable = vtableOf<Type>();
 
         switch(action) {
         case Action::GET:
@@ -301,12 +530,12 @@ private:
 #if defined(EXCEPTIONS_ENABLED)
 
             // Check if the types are matching by comparing VTABLE pointers
-            if(m_vtable != &vtable) throw std::bad_cast();
+            if(m_vtable != vtable) throw std::bad_cast();
 
 #endif
 
             // Returning the stored object (Small-Object-Optimalization)
-            if(sizeof(Type) <= sizeof(void*)) return *reinterpret_cast<Type*>(&m_object);
+            if(is_inline<Type>::value) return *reinterpret_cast<Type*>(&m_object);
 
             // Returning the the stored object (No optimalization)
             return *(static_cast<Type*>(m_object));
@@ -314,17 +543,17 @@ private:
         case Action::SET:
 
             // Deleting the currently stored object with Small-Buffer-Optimalization
-            if(m_vtable && m_vtable->m_size <= sizeof(void*)) {
+            if(m_vtable && m_vtable->m_inline) {
                 m_vtable->m_deleteFunction(&m_object);
             }
 
             // Deleting the currently stored object without Small-Buffer-Optimalization
-            if(m_vtable && m_vtable->m_size > sizeof(void*)) {
+            if(m_vtable && !m_vtable->m_inline) {
                 m_vtable->m_deleteFunction(m_object);
             }
 
             // Updating VTABLE to refer to the the new type
-            m_vtable = &vtable;
+            m_vtable = vtable;
 
             // Making a copy of the supplied value
             m_vtable->m_cloneFunction(this, &value);
@@ -353,11 +582,26 @@ private:
          */
         using cloneFunction  = void (*)(any*, const void*);
 
+        /**
+         * Function pointer signature for moving values.
+         */
+        using moveFunction   = void (*)(any*, any*);
+
         /**
          * Function pointer signature for printing values.
          */
         using printFunction  = std::ostream& (*)(std::ostream&, const any*);
 
+        /**
+         * Function pointer signature for comparing values.
+         */
+        using equalFunction  = bool (*)(const any*, const any*);
+
+        /**
+         * Function pointer signature for hashing values.
+         */
+        using hashFunction   = uint32_t (*)(const any*);
+
 #if defined(RTTI_ENABLED)
 
         /**
@@ -371,13 +615,17 @@ private:
          * @param fpClone  [in] Pointer to the function used for copying values.
          * @param typeInfo [in] Pointer to the type information data.
          */
-        VTable(deleteFunction fpDelete, cloneFunction fpClone, printFunction fpPrint,
-               std::size_t size, typeInfo* typeInfo);
+        VTable(deleteFunction fpDelete, cloneFunction fpClone, moveFunction fpMove, printFunction fpPrint,
+               equalFunction fpEqual, hashFunction fpHash, std::size_t size, bool isInline, typeInfo* typeInfo);
 
         deleteFunction  m_deleteFunction; /**< Function pointer for deleting values. */
         cloneFunction   m_cloneFunction;  /**< Function pointer for copying values.  */
+        moveFunction    m_moveFunction;   /**< Function pointer for moving values.   */
         printFunction   m_printFunction;  /**< Function pointer for printing values. */
+        equalFunction   m_equalFunction;  /**< Function pointer for comparing values.*/
+        hashFunction    m_hashFunction;   /**< Function pointer for hashing values.  */
         std::size_t     m_size;           /**< The byte-size of the referenced type. */
+        bool            m_inline;         /**< Whether values are stored in-place.   */
         typeInfo*       m_typeInfo;       /**< Pointer to the type information.      */
 
 #else
@@ -387,13 +635,17 @@ private:
 		 * @param fpDelete [in] Pointer to the function used for deleting values.
 		 * @param fpClone  [in] Pointer to the function used for copying values.
 		 */
-		VTable(deleteFunction fpDelete, cloneFunction fpClone, printFunction fpPrint,
-			   std::size_t size);
+		VTable(deleteFunction fpDelete, cloneFunction fpClone, moveFunction fpMove, printFunction fpPrint,
+			   equalFunction fpEqual, hashFunction fpHash, std::size_t size, bool isInline);
 
 		deleteFunction  m_deleteFunction; /**< Function pointer for deleting values. */
 		cloneFunction   m_cloneFunction;  /**< Function pointer for copying values.  */
+		moveFunction    m_moveFunction;   /**< Function pointer for moving values.   */
 		printFunction   m_printFunction;  /**< Function pointer for printing values. */
+		equalFunction   m_equalFunction;  /**< Function pointer for comparing values.*/
+		hashFunction    m_hashFunction;   /**< Function pointer for hashing values.  */
 		std::size_t     m_size;           /**< The byte-size of the referenced type. */
+		bool            m_inline;         /**< Whether values are stored in-place.   */
 
 #endif
 
@@ -413,18 +665,38 @@ private:
         VTableTyped() : VTable(
             any::deleteFunction<typename std::decay<Type>::type>,
             any::cloneFunction<typename std::decay<Type>::type>,
+            any::moveFunction<typename std::decay<Type>::type>,
             any::printFunction<typename std::decay<Type>::type>,
+            any::equalFunction<typename std::decay<Type>::type>,
+            any::hashFunction<typename std::decay<Type>::type>,
 
 #if defined(RTTI_ENABLED)
-			sizeof(Type), &typeid(Type))
+			sizeof(Type), is_inline<Type>::value, &typeid(Type))
 #else
-    		sizeof(Type))
+    		sizeof(Type), is_inline<Type>::value)
 #endif
         {}
     };
 
-    void*   m_object; /**< Pointer to the actual value stored by the NodeValue. */
+    /**
+     * @brief  Queries the Virtual Table unique to every type used with any objects.
+     *         It stores function pointers for deleting and copying specific types
+     *         for the contained values and other type specific information.
+     * @return Pointer to the Virtual Table of the type.
+     */
+    template <class Type>
+    static VTable* vtableOf() noexcept
+    {
+        static VTableTyped<Type> vtable;
+        return &vtable;
+    }
+
     VTable* m_vtable; /**< Pointer to the virtual table for the current type.   */
+
+    union {
+        void*   m_object;  /**< Pointer to the actual value stored by the NodeValue. */
+        std::aligned_storage<INLINE_SIZE, INLINE_ALIGNMENT>::type m_storage; /**< Storage of the in-place values. */
+    };
 };
 
 /**
@@ -1,39 +1,57 @@
 #include "component.h"
 
+// ESP-IDF includes
+#include "esp_log.h"
+
 
 Component::PortQuery::PortQuery(Component* parent, Port* left)
-	: m_parent(parent), m_left(left), m_right(nullptr)
+	: m_parent(parent), m_left(left), m_right(nullptr), m_lane(0), m_valid(true)
 {}
 
 Component::PortQuery& Component::PortQuery::operator[](const std::string& name)
 {
-	// Assume, that the specified output port does not exist
-	m_right = nullptr;
-
 	// Checking if the parent component has the specified output port
-	if(m_parent->m_ports[name].direction() == Port::Direction::OUTPUT) {
-		m_right = &m_parent->m_ports[name];
+	m_right = m_parent->m_ports.find(name);
+	m_valid = m_right != nullptr && m_right->direction() == Port::Direction::OUTPUT;
+
+	// Invalid queries refuse to connect, instead of connecting the left-hand-side port
+	if(!m_valid) {
+		ESP_LOGE("DATAFLOW", "Port \"%s\" is not an output port.", name.c_str());
+		m_right = nullptr;
 	}
 
 	return *this;
 }
 
-Component::PortQuery Component::PortQuery::operator>>(const PortQuery& other)
+Component::PortQuery& Component::PortQuery::lane(std::size_t lane) noexcept
 {
-	// Checking if the query contains a right-hand-side port and connecting them
-	if(m_right != nullptr && other.m_left->direction() == Port::Direction::INPUT) {
+	m_lane = lane;
+	return *this;
+}
 
-		// Connecting the right-hand-side of this query to the left-hand-side of the other
-		*(m_right) >> *(other.m_left);
-	}
+Component::PortQuery& Component::PortQuery::emit(Port::Emit mode)
+{
+	// Setting the mode of the right-hand-side port, or of the left-hand-side output
+	if(!m_valid) return *this;
+	if(m_right != nullptr) m_right->setEmit(mode);
+	else if(m_left != nullptr && m_left->direction() == Port::Direction::OUTPUT) m_left->setEmit(mode);
 
-	// Otherwise make the connection from the left-hand-side
-	else if(m_left != nullptr && other.m_left->direction() == Port::Direction::INPUT) {
+	return *this;
+}
 
-		// Connecting the left-hand-side of this query to the left-hand-side of the other
-		*(m_left) >> *(other.m_left);
+Component::PortQuery Component::PortQuery::operator>>(const PortQuery& other)
+{
+	// Refusing the connection of an invalid query, so it is reported by Dataflow::finalize()
+	if(!m_valid) {
+		m_left->refuseConnection();
+		return other;
 	}
 
+	// Connecting the right-hand-side of this query, or the left-hand-side when there is none,
+	// to the left-hand-side of the other (ports of the wrong direction are refused)
+	Port* output = (m_right != nullptr) ? m_right : m_left;
+	output->connect(*(other.m_left), other.m_lane);
+
 	return other;
 }
 
@@ -42,20 +60,61 @@ void Component::PortQuery::sendInitialMessage(const Node& message)
 	m_left->send(message);
 }
 
+Component::Component() noexcept
+	: m_running(false), m_task(nullptr), m_stackFree(UINT32_MAX)
+{}
+
 Component::PortQuery Component::operator[](const std::string& name)
 {
 	return PortQuery(this, &m_ports[name]);
 }
 
-bool Component::PortContainer::addInputPort(const std::string& name, std::size_t queueSize)
+std::size_t Component::saveState(uint8_t* buffer, std::size_t size)
+{
+	// Suppressing compiler warnings for unused parameters
+	(void)(buffer);
+	(void)(size);
+
+	// No state is saved by default
+	return 0;
+}
+
+void Component::restoreState(const uint8_t* buffer, std::size_t size)
+{
+	// No state is restored by default, suppressing compiler warnings
+	(void)(buffer);
+	(void)(size);
+}
+
+bool Component::finished() const noexcept
+{
+	return m_ports.finished();
+}
+
+void Component::finish() noexcept
+{
+	m_ports.finish();
+}
+
+HeapAccount& Component::heap() noexcept
+{
+	return m_heap;
+}
+
+Component::PortContainer& Component::ports() noexcept
+{
+	return m_ports;
+}
+
+bool Component::PortContainer::addInputPort(const std::string& name, std::size_t queueSize, std::size_t lanes)
 {
 	// Checking if a port already exists with the same name
 	if(m_ports.count(name) != 0) return false;
 
-	// Adding the input port to the component
-	m_ports.emplace(std::pair<std::string, Port>(std::piecewise_construct,
+	// Adding the input port to the component (constructed in place, as Ports can not be copied)
+	m_ports.emplace(std::piecewise_construct,
 			std::forward_as_tuple(name),
-			std::forward_as_tuple(Port::Direction::INPUT, name, queueSize))
+			std::forward_as_tuple(Port::Direction::INPUT, name, queueSize, lanes)
 	);
 	return true;
 }
@@ -65,18 +124,58 @@ bool Component::PortContainer::addOutputPort(const std::string& name)
 	// Checking if a port already exists with the same name
 	if(m_ports.count(name) != 0) return false;
 
-	// Adding the output port to the component
-	m_ports.emplace(std::pair<std::string, Port>(std::piecewise_construct,
+	// Adding the output port to the component (constructed in place, as Ports can not be copied)
+	m_ports.emplace(std::piecewise_construct,
 			std::forward_as_tuple(name),
-			std::forward_as_tuple(Port::Direction::OUTPUT, name, 0))
+			std::forward_as_tuple(Port::Direction::OUTPUT, name, 0)
 	);
 	return true;
 }
 
+Component::PortContainer::PortContainer() noexcept
+	: m_finished(false)
+{}
+
+void Component::PortContainer::finish() noexcept
+{
+	m_finished = true;
+}
+
+bool Component::PortContainer::finished() const noexcept
+{
+	return m_finished;
+}
+
+void Component::PortContainer::close() noexcept
+{
+	for(auto& port : m_ports) port.second.close();
+}
+
+void Component::PortContainer::open() noexcept
+{
+	for(auto& port : m_ports) port.second.open();
+	m_finished = false;
+}
+
 Port& Component::PortContainer::operator[](const std::string& name)
 {
 	return m_ports.at(name);
 }
 
+Port* Component::PortContainer::find(const std::string& name) noexcept
+{
+	// Searching for the Port with the specified name
+	auto it = m_ports.find(name);
 
+	return (it != m_ports.end()) ? &it->second : nullptr;
+}
+
+std::map<std::string, Port>::iterator Component::PortContainer::begin() noexcept
+{
+	return m_ports.begin();
+}
 
+std::map<std::string, Port>::iterator Component::PortContainer::end() noexcept
+{
+	return m_ports.end();
+}
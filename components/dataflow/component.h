@@ -4,6 +4,9 @@
 
 // Standard includes
 #include <map>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
 
 // FreeRTOS includes
 #include "freertos/FreeRTOS.h"
@@ -11,6 +14,7 @@
 
 // Project includes
 #include "port.h"
+#include "heap.h"
 
 
 /**
@@ -19,9 +23,10 @@
  * member function. Here the components can read/write input/output ports, perform
  * logic on their inputs to create outputs or generate side effects. The dataflow
  * implementation creates a new thread for each component instance and calls the
- * process() method, which is expected not to return for the useful lifetime of
- * the component. Input and output ports should be created and added in the
- * constructor of derived component classes.
+ * process() method repeatedly, until the component finishes (see finish()) or the
+ * flow is stopped, which closes the input ports (see Port::close()). Input and
+ * output ports should be created and added in the constructor of derived
+ * component classes.
  */
 class Component {
 public:
@@ -30,6 +35,15 @@ public:
 	// query and connect named Ports from the Component.
 	class PortQuery;
 
+	// Forward declaration of the PortContainer class which is used
+	// to store the Ports of the Component.
+	class PortContainer;
+
+	/**
+	 * Constructs the dataflow Component.
+	 */
+	Component() noexcept;
+
 	/**
 	 * Destroys the dataflow Component.
 	 */
@@ -43,6 +57,26 @@ public:
 	 */
 	virtual void process() = 0;
 
+	/**
+	 * Saves the state of the Component into a snapshot, which is restored after
+	 * waking up from deep sleep. Components opt into snapshots by overriding this
+	 * method, the state should be small and self-contained (no pointers). It is
+	 * called while the flow is running, right before entering deep sleep, so the
+	 * state must be guarded against the concurrent process() (eg. with a mutex).
+	 * @param  buffer [out] The buffer to write the state into.
+	 * @param  size   [in]  The available size of the buffer in bytes.
+	 * @return The number of bytes written, zero when there is no state to save.
+	 */
+	virtual std::size_t saveState(uint8_t* buffer, std::size_t size);
+
+	/**
+	 * Restores the state of the Component from a snapshot. This is called before
+	 * the flow is started, only with the data saved by saveState() previously.
+	 * @param buffer [in] The buffer containing the saved state.
+	 * @param size   [in] The size of the saved state in bytes.
+	 */
+	virtual void restoreState(const uint8_t* buffer, std::size_t size);
+
 	/**
 	 * Queries the Component for the Port with the specified name.
 	 * @param  name [in] The name of the Port to query from the Component.
@@ -50,6 +84,26 @@ public:
 	 */
 	PortQuery operator[](const std::string& name);
 
+	/**
+	 * Queries whether the Component has finished (see finish()).
+	 * @return True when the Component has finished.
+	 */
+	bool finished() const noexcept;
+
+	/**
+	 * Queries the heap account of the Component, which is charged with the Nodes
+	 * and payloads allocated while the Component is running.
+	 * @return Reference to the heap account of the Component.
+	 */
+	HeapAccount& heap() noexcept;
+
+	/**
+	 * Queries the storage of the Ports of the Component. This is used by the
+	 * dataflow infrastructure to inspect and connect Ports programmatically.
+	 * @return Reference to the Ports of the Component.
+	 */
+	PortContainer& ports() noexcept;
+
 	/**
 	 * The PortQuery class represents the result of a named query for a
 	 * Port of the component. The query object can be used to connect to
@@ -71,15 +125,32 @@ public:
 		/**
 		 * Queries the parent Component for another port, to support chaining
 		 * syntax. The query will contain at most two Port references, the one
-		 * which it was created with and the last user-indexed Port.
+		 * which it was created with and the last user-indexed Port. Querying a
+		 * Port which is not an OUTPUT Port makes connecting the query fail.
 		 * @param  name [in] The name of the OUTPUT port to query next.
 		 * @return Reference to this object after the query is performed.
 		 */
 		PortQuery& operator[](const std::string& name);
 
+		/**
+		 * Selects the priority lane of the INPUT Port referenced by this query,
+		 * which is used when an OUTPUT Port is connected to this query.
+		 * @param  lane [in] The priority lane to connect to (higher is more urgent).
+		 * @return Reference to this object after the selection is made.
+		 */
+		PortQuery& lane(std::size_t lane) noexcept;
+
+		/**
+		 * Sets the emit mode of the OUTPUT Port referenced by this query, eg. to
+		 * suppress unchanged messages before connecting it.
+		 * @param  mode [in] The emit mode of the OUTPUT Port.
+		 * @return Reference to this object after the mode is set.
+		 */
+		PortQuery& emit(Port::Emit mode);
+
 		/**
 		 * Connects the OUTPUT Port referenced by this query to the INPUT Port
-		 * referenced by the other query.
+		 * referenced by the other query (to its selected priority lane).
 		 * @param  other [in] The other query referencing an INPUT Port.
 		 * @return A copy of the other query for chaining connections.
 		 */
@@ -92,9 +163,11 @@ public:
 		void sendInitialMessage(const Node& message);
 
 	private:
-		Component* m_parent; /**< Pointer to the parent component of the referenced Port(s). */
-		Port*      m_left;   /**< Pointer to the left-side Port when making connections.     */
-		Port*      m_right;  /**< Pointer to the right-side Port when making connections.    */
+		Component*  m_parent; /**< Pointer to the parent component of the referenced Port(s). */
+		Port*       m_left;   /**< Pointer to the left-side Port when making connections.     */
+		Port*       m_right;  /**< Pointer to the right-side Port when making connections.    */
+		std::size_t m_lane;   /**< The priority lane of the left-side Port for connections.   */
+		bool        m_valid;  /**< Whether the last Port queried is an OUTPUT Port.            */
 	};
 
 	/**
@@ -106,13 +179,45 @@ public:
 	class PortContainer {
 	public:
 
+		/**
+		 * Constructs an empty PortContainer of a running Component.
+		 */
+		PortContainer() noexcept;
+
+		/**
+		 * Finishes the Component owning the Ports: process() is not called again
+		 * after it returns, the task of the Component is deleted (returning its
+		 * stack) and its input Ports are closed. One-shot components (eg. ones
+		 * connecting to WiFi or providing driver interfaces) call this after their
+		 * work is done, instead of suspending their tasks forever.
+		 */
+		void finish() noexcept;
+
+		/**
+		 * Queries whether the Component owning the Ports has finished.
+		 * @return True when the Component has finished.
+		 */
+		bool finished() const noexcept;
+
+		/**
+		 * Closes all of the input Ports (see Port::close()).
+		 */
+		void close() noexcept;
+
+		/**
+		 * Opens all of the input Ports again, and clears the finished state, eg.
+		 * when restarting the flow.
+		 */
+		void open() noexcept;
+
 		/**
 		 * Adds a named input Port to the Component with the specified message queue size.
 		 * @param  name      [in] The name of the new Port to add to the Component.
-		 * @param  queueSize [in] The size of the message queue for this Port.
+		 * @param  queueSize [in] The size of the message queue for this Port (per lane).
+		 * @param  lanes     [in] The number of priority lanes of this Port.
 		 * @return True when the Port has been added successfully.
 		 */
-		bool addInputPort(const std::string& name, std::size_t queueSize = 10);
+		bool addInputPort(const std::string& name, std::size_t queueSize = 10, std::size_t lanes = 1);
 
 		/**
 		 * Adds a named output Port to the Component.
@@ -129,12 +234,48 @@ public:
 		 */
 		Port& operator[](const std::string& name);
 
+		/**
+		 * Queries the Port with the specified name without throwing exceptions.
+		 * @param  name [in] The name of the Port to query.
+		 * @return Pointer to the Port, or nullptr when the Port does not exist.
+		 */
+		Port* find(const std::string& name) noexcept;
+
+		/**
+		 * Queries an iterator to the first (name, Port) pair of the Component.
+		 * @return The iterator referencing the first Port.
+		 */
+		std::map<std::string, Port>::iterator begin() noexcept;
+
+		/**
+		 * Queries the past-the-end iterator of the Ports of the Component.
+		 * @return The past-the-end iterator for terminating traversal.
+		 */
+		std::map<std::string, Port>::iterator end() noexcept;
+
 	private:
-		std::map<std::string, Port> m_ports; /**< The internal storage implementation. */
+		std::map<std::string, Port> m_ports;    /**< The internal storage implementation.       */
+		std::atomic<bool>           m_finished; /**< Whether the owning Component has finished. */
 	};
 
 protected:
+
+	/**
+	 * Finishes the Component after process() returns (see PortContainer::finish()).
+	 */
+	void finish() noexcept;
+
 	PortContainer m_ports; /**< The internal storage for storing Ports of the Component. */
+	HeapAccount   m_heap;  /**< The allocation statistics of the Component.              */
+
+private:
+
+	// The Dataflow tracks the tasks of the Components
+	friend class Dataflow;
+
+	std::atomic<bool> m_running;   /**< Whether the task of the Component is running.            */
+	TaskHandle_t      m_task;      /**< The task of the Component, nullptr once it exited.        */
+	uint32_t          m_stackFree; /**< The least free stack of the last task exited, in bytes. */
 };
 
 #endif // DATAFLOW_COMPONENT_H_INCLUDED
@@ -0,0 +1,26 @@
+#include "cooperative.h"
+
+CooperativeComponent::CooperativeComponent() noexcept
+	: m_resumePoint(0), m_progressed(false)
+{}
+
+bool CooperativeComponent::resume()
+{
+	// Running the coroutine until the next suspension point, charging its allocations
+	HeapAccount* previous = HeapAccount::select(&m_heap);
+	m_progressed = false;
+	process();
+	HeapAccount::select(previous);
+
+	return m_progressed;
+}
+
+void CooperativeComponent::attach(TaskHandle_t executor)
+{
+	// Registering the executor for notifications on all input ports
+	for(auto& port : m_ports) {
+		if(port.second.direction() == Port::Direction::INPUT) {
+			port.second.setListener(executor);
+		}
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+#ifndef DATAFLOW_COOPERATIVE_H_INCLUDED
+#define DATAFLOW_COOPERATIVE_H_INCLUDED
+
+// FreeRTOS includes
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Project includes
+#include "component.h"
+
+
+/**
+ * Marks the start of the coroutine body inside the process() method of a
+ * CooperativeComponent. Execution continues from the last suspension point.
+ */
+#define CO_BEGIN() switch(m_resumePoint) { case 0:
+
+/**
+ * Suspends the coroutine until a message is available on the specified input
+ * Port, then receives it into the specified Node. The executor task is free to
+ * run other components while this component is suspended.
+ */
+#define CO_AWAIT_RECEIVE(port, message)                 \
+	do {                                                \
+		m_resumePoint = __LINE__;                       \
+		__attribute__((fallthrough)); case __LINE__:    \
+		if(!(port).receive((message), 0)) return;       \
+		m_progressed = true;                            \
+	} while(0)
+
+/**
+ * Suspends the coroutine and lets the executor run the other components, the
+ * coroutine continues from this point on the next pass of the executor.
+ */
+#define CO_YIELD()                                      \
+	do {                                                \
+		m_resumePoint = __LINE__; m_progressed = true;  \
+		return; case __LINE__:;                         \
+	} while(0)
+
+/**
+ * Marks the end of the coroutine body, the next resume starts from CO_BEGIN().
+ */
+#define CO_END() } m_resumePoint = 0;
+
+
+/**
+ * The CooperativeComponent class provides a base class for dataflow components
+ * which do not own a task. Instead of blocking inside process(), these components
+ * implement it as a stackless coroutine using the CO_BEGIN(), CO_AWAIT_RECEIVE(),
+ * CO_YIELD() and CO_END() macros, and are multiplexed onto a shared executor task
+ * by the Dataflow. The executor resumes the component whenever a message arrives
+ * on any of its input ports.
+ *
+ * Since the stack is not preserved between suspensions, state that has to survive
+ * a suspension point (including the received messages) must be stored in member
+ * variables, and only one suspension point may be placed on a single source line.
+ * Cooperative components can be freely connected to the regular, blocking ones.
+ * Note that sending to a full input queue blocks the whole executor, so input
+ * ports fed by cooperative components should be sized accordingly.
+ */
+class CooperativeComponent : public Component {
+public:
+
+	/**
+	 * Constructs a CooperativeComponent starting at the beginning of its coroutine.
+	 */
+	CooperativeComponent() noexcept;
+
+	/**
+	 * Resumes the coroutine of the Component until it is suspended again.
+	 * @return True when the Component received a message or yielded.
+	 */
+	bool resume();
+
+	/**
+	 * Attaches the Component to the specified executor task, so the executor is
+	 * notified about the messages arriving to the input ports of the Component.
+	 * @param executor [in] The handle of the executor task.
+	 */
+	void attach(TaskHandle_t executor);
+
+protected:
+	int  m_resumePoint; /**< The source line of the last suspension point.        */
+	bool m_progressed;  /**< Flag to indicate progress since the last resumption. */
+};
+
+#endif // DATAFLOW_COOPERATIVE_H_INCLUDED
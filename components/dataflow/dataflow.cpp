@@ -1,18 +1,574 @@
 #include "dataflow.h"
 
+// Standard includes
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+
+// ESP-IDF includes
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+
+// Project includes
+#include "snapshot.h"
+#include "stack_profile.h"
+
+// Value identifying the format of the snapshots
+static const uint32_t SNAPSHOT_FORMAT = 0x44460001;
+
+// Value identifying the format of the stack profiles
+static const uint32_t STACK_PROFILE_FORMAT = 0x44460101;
+
+Dataflow::Dataflow(std::size_t executorCount)
+	: m_executors(executorCount > 0 ? executorCount : 1), m_executorStacks(m_executors.size(), DATAFLOW_STACK_SIZE),
+	  m_nextExecutor(0), m_calibrating(false), m_state(State::STOPPED), m_topologyValid(false), m_finalized(false)
+{}
+
 void Dataflow::addComponent(Component* component)
 {
-	m_components.push_back(component);
+	m_components.push_back(Entry{ component, false, DATAFLOW_STACK_SIZE, std::to_string(m_components.size()) });
+	m_topologyValid = false;
+	m_finalized = false;
 }
 
-void Dataflow::startFlow()
+void Dataflow::addComponent(CooperativeComponent* component)
 {
-	for(Component* component : m_components) {
-		xTaskCreatePinnedToCore(componentTaskFunction, "", 4096, component, 10, nullptr, 0);
+	m_components.push_back(Entry{ component, true, 0, std::to_string(m_components.size()) });
+	m_topologyValid = false;
+	m_finalized = false;
+
+	// Distributing the cooperative components evenly among the executors
+	m_executors[m_nextExecutor].addComponent(component);
+	m_nextExecutor = (m_nextExecutor + 1) % m_executors.size();
+}
+
+void Dataflow::setName(Component* component, const std::string& name)
+{
+	for(Entry& entry : m_components) {
+		if(entry.m_component == component) entry.m_name = name;
+	}
+
+	m_topologyValid = false;
+}
+
+const Topology& Dataflow::topology()
+{
+	if(m_topologyValid) return m_topology;
+
+	m_topology.m_vertices.clear();
+	m_topology.m_edges.clear();
+
+	// Creating the vertices, and indexing the ports by the component owning them
+	std::unordered_map<const Port*, std::size_t> owners;
+
+	for(std::size_t i = 0; i < m_components.size(); i++) {
+		const Entry& entry = m_components[i];
+		m_topology.m_vertices.push_back(Topology::Vertex{ entry.m_name, entry.m_component, entry.m_cooperative, {}, {} });
+
+		for(auto& port : entry.m_component->ports()) owners[&port.second] = i;
+	}
+
+	// Creating an edge for each connection of the output ports
+	auto owner = [&owners](const Port* port) {
+		auto found = owners.find(port);
+		return (found != owners.end()) ? found->second : Topology::EXTERNAL;
+	};
+
+	for(std::size_t i = 0; i < m_components.size(); i++) {
+		for(auto& port : m_components[i].m_component->ports()) {
+			for(const Port::Connection& connection : port.second.connections()) {
+				std::size_t target = owner(connection.m_target);
+				std::size_t index = m_topology.m_edges.size();
+
+				m_topology.m_edges.push_back(Topology::Edge{ i, &port.second, target, connection.m_target, connection.m_lane });
+				m_topology.m_vertices[i].m_outgoing.push_back(index);
+				if(target != Topology::EXTERNAL) m_topology.m_vertices[target].m_incoming.push_back(index);
+			}
+		}
+	}
+
+	m_topologyValid = true;
+	return m_topology;
+}
+
+bool Dataflow::finalize()
+{
+	// Rebuilding the topology, including the connections made since
+	m_topologyValid = false;
+	const Topology& graph = topology();
+
+	bool valid = true;
+	std::size_t dead = 0;
+
+	for(const Topology::Vertex& vertex : graph.m_vertices) {
+		for(auto& entry : vertex.m_component->ports()) {
+			const Port& port = entry.second;
+			const char* component = vertex.m_name.c_str();
+
+			// Reporting the connections refused from the port
+			if(port.invalidConnections() > 0) {
+				ESP_LOGE("DATAFLOW", "Component \"%s\": %u connections refused from port \"%s\".",
+						component, (unsigned) port.invalidConnections(), port.name().c_str());
+				valid = false;
+			}
+
+			// Reporting the unconnected input ports, which only receive initial messages
+			if(port.direction() == Port::Direction::INPUT && !port.isConnected() && !port.isInternal()) {
+				ESP_LOGW("DATAFLOW", "Component \"%s\": input port \"%s\" is not connected.", component, port.name().c_str());
+			}
+
+			// Reporting the dead output ports, their messages are not built by components checking for subscribers
+			if(port.direction() == Port::Direction::OUTPUT && !port.hasSubscribers()) {
+				ESP_LOGW("DATAFLOW", "Component \"%s\": output port \"%s\" is dead.", component, port.name().c_str());
+				dead++;
+			}
+		}
+	}
+
+	// Reporting the connections leaving the flow, eg. to components not added to it
+	for(const Topology::Edge& edge : graph.m_edges) {
+		if(edge.m_target != Topology::EXTERNAL) continue;
+
+		ESP_LOGW("DATAFLOW", "Component \"%s\": output port \"%s\" is connected to port \"%s\" outside of the flow.",
+				graph.m_vertices[edge.m_source].m_name.c_str(), edge.m_output->name().c_str(), edge.m_input->name().c_str());
+	}
+
+	ESP_LOGI("DATAFLOW", "Graph of %u components and %u connections finalized, %u dead outputs.",
+			(unsigned) graph.m_vertices.size(), (unsigned) graph.m_edges.size(), (unsigned) dead);
+
+	m_finalized = true;
+	return valid;
+}
+
+bool Dataflow::startFlow()
+{
+	if(m_state != State::STOPPED) return true;
+
+	// Validating the graph on the first start
+	if(!m_finalized) finalize();
+
+	// Rebuilding the topology on demand, including the connections made since
+	m_topologyValid = false;
+
+	// Reopening the ports closed by stopping the flow previously
+	for(Entry& entry : m_components) entry.m_component->ports().open();
+
+	// Reducing the calibration stacks when all of them do not fit the share of the free heap
+	uint32_t calibrationStack = DATAFLOW_CALIBRATION_STACK_SIZE;
+	if(m_calibrating) {
+		std::size_t tasks = 0;
+		for(const Entry& entry : m_components) if(!entry.m_cooperative) tasks++;
+		for(const Executor& executor : m_executors) if(!executor.empty()) tasks++;
+
+		std::size_t available = heap_caps_get_free_size(MALLOC_CAP_8BIT) / 100 * DATAFLOW_CALIBRATION_HEAP_SHARE;
+		if(tasks > 0 && available / tasks < calibrationStack) {
+			calibrationStack = std::max<uint32_t>(available / tasks, DATAFLOW_STACK_SIZE);
+			ESP_LOGW("DATAFLOW", "Calibrating %u tasks with %u bytes of stack to fit the free heap.", (unsigned) tasks, (unsigned) calibrationStack);
+		}
+	}
+
+	// Starting the tasks, a task not created fails the start
+	bool started = true;
+
+	for(Entry& entry : m_components) {
+		if(entry.m_cooperative || !started) continue;
+
+		if(m_calibrating) entry.m_stackSize = calibrationStack;
+
+		// The task clears the running flag when it exits (see componentTaskFunction)
+		entry.m_component->m_running = true;
+		if(xTaskCreatePinnedToCore(componentTaskFunction, "", entry.m_stackSize, entry.m_component, 10, &entry.m_component->m_task, 0) != pdPASS) {
+			ESP_LOGE("DATAFLOW", "Failed to create task with %u bytes of stack.", (unsigned) entry.m_stackSize);
+			entry.m_component->m_running = false;
+			entry.m_component->m_task = nullptr;
+			started = false;
+		}
+	}
+
+	for(std::size_t i = 0; i < m_executors.size() && started; i++) {
+		if(m_executors[i].empty()) continue;
+
+		uint32_t stackSize = m_calibrating ? calibrationStack : m_executorStacks[i];
+		if(!m_executors[i].start(stackSize, 10, 0)) {
+			ESP_LOGE("DATAFLOW", "Failed to create executor task with %u bytes of stack.", (unsigned) stackSize);
+			started = false;
+		}
+	}
+
+	m_state = State::RUNNING;
+
+	// Stopping the tasks already started, a partial graph would stall on the missing components
+	if(!started) {
+		stop();
+		return false;
+	}
+
+	return true;
+}
+
+bool Dataflow::stop(TickType_t timeout)
+{
+	if(m_state == State::STOPPED) return true;
+	if(m_state == State::PAUSED) resume();
+
+	// Finishing the components and closing their ports, which wakes up the blocked tasks
+	for(Entry& entry : m_components) {
+		entry.m_component->ports().finish();
+		entry.m_component->ports().close();
+	}
+
+	for(Executor& executor : m_executors) executor.stop();
+
+	// Waiting for the tasks to exit by themselves
+	auto running = [this]() -> bool {
+		for(const Entry& entry : m_components) if(entry.m_component->m_running) return true;
+		for(const Executor& executor : m_executors) if(executor.running()) return true;
+		return false;
+	};
+
+	TickType_t start = xTaskGetTickCount();
+	while(running() && xTaskGetTickCount() - start < timeout) vTaskDelay(1);
+
+	// Deleting the tasks which did not exit, unless they are deleting themselves right now
+	bool clean = true;
+	xSemaphoreTake(taskMutex(), portMAX_DELAY);
+
+	for(Entry& entry : m_components) {
+		Component* component = entry.m_component;
+
+		if(component->m_running.exchange(false)) {
+			component->m_stackFree = uxTaskGetStackHighWaterMark(component->m_task);
+			vTaskDelete(component->m_task);
+			clean = false;
+		}
+
+		component->m_task = nullptr;
+	}
+
+	xSemaphoreGive(taskMutex());
+
+	for(Executor& executor : m_executors) clean &= !executor.kill();
+
+	if(!clean) ESP_LOGW("DATAFLOW", "Tasks did not exit in time, they were deleted.");
+
+	m_state = State::STOPPED;
+	return clean;
+}
+
+void Dataflow::pause()
+{
+	if(m_state != State::RUNNING) return;
+
+	// Suspending the tasks still running, none of them can exit meanwhile
+	xSemaphoreTake(taskMutex(), portMAX_DELAY);
+	for(Entry& entry : m_components) {
+		if(entry.m_component->m_task != nullptr) vTaskSuspend(entry.m_component->m_task);
+	}
+	xSemaphoreGive(taskMutex());
+
+	for(Executor& executor : m_executors) {
+		if(executor.running()) vTaskSuspend(executor.task());
+	}
+
+	m_state = State::PAUSED;
+}
+
+void Dataflow::resume()
+{
+	if(m_state != State::PAUSED) return;
+
+	xSemaphoreTake(taskMutex(), portMAX_DELAY);
+	for(Entry& entry : m_components) {
+		if(entry.m_component->m_task != nullptr) vTaskResume(entry.m_component->m_task);
+	}
+	xSemaphoreGive(taskMutex());
+
+	for(Executor& executor : m_executors) {
+		if(executor.running()) vTaskResume(executor.task());
+	}
+
+	m_state = State::RUNNING;
+}
+
+void Dataflow::teardown()
+{
+	stop();
+
+	// Deleting the queues of the ports along with the messages still queued
+	for(Entry& entry : m_components) {
+		for(auto& port : entry.m_component->ports()) port.second.release();
+	}
+
+	// Removing the components from the flow
+	for(Executor& executor : m_executors) executor.clear();
+	m_components.clear();
+	m_nextExecutor = 0;
+	m_topologyValid = false;
+	m_finalized = false;
+}
+
+Dataflow::State Dataflow::state() const noexcept
+{
+	return m_state;
+}
+
+void Dataflow::setStackCalibration(bool enabled) noexcept
+{
+	m_calibrating = enabled;
+}
+
+bool Dataflow::loadStackProfile(uint32_t margin)
+{
+	// Reading the stored profile, the checksum is validated by the storage
+	std::vector<uint32_t> profile;
+	if(!StackProfileStorage::read(profile)) return false;
+
+	// Checking if the profile belongs to this graph
+	if(profile.size() != 3 + m_components.size() + m_executors.size() || profile[0] != STACK_PROFILE_FORMAT
+			|| profile[1] != m_components.size() || profile[2] != m_executors.size()) {
+		ESP_LOGW("DATAFLOW", "Stack profile does not match the graph, ignoring it.");
+		return false;
+	}
+
+	// Calculating the stack sizes from the measured usage with the margin, aligned to 16 bytes
+	auto stackSize = [margin](uint32_t usage, uint32_t current) -> uint32_t {
+		if(usage == 0) return current;
+
+		uint32_t size = (usage + usage * margin / 100 + 15) & ~15u;
+		return (size > DATAFLOW_MIN_STACK_SIZE) ? size : DATAFLOW_MIN_STACK_SIZE;
+	};
+
+	for(std::size_t i = 0; i < m_components.size(); i++) {
+		if(!m_components[i].m_cooperative) m_components[i].m_stackSize = stackSize(profile[3 + i], m_components[i].m_stackSize);
+	}
+
+	for(std::size_t i = 0; i < m_executors.size(); i++) {
+		m_executorStacks[i] = stackSize(profile[3 + m_components.size() + i], m_executorStacks[i]);
+	}
+
+	return true;
+}
+
+bool Dataflow::saveStackProfile()
+{
+	// The profile starts with the format and the shape of the graph
+	std::vector<uint32_t> profile = { STACK_PROFILE_FORMAT, (uint32_t) m_components.size(), (uint32_t) m_executors.size() };
+
+	// Measuring the stack usage of the component and executor tasks
+	for(const Entry& entry : m_components) {
+		profile.push_back(stackUsage(entry));
+	}
+
+	for(const Executor& executor : m_executors) {
+		profile.push_back(stackUsage(executor.task(), executor.stackSize()));
+	}
+
+	// Keeping the highest usage recorded previously by this graph
+	std::vector<uint32_t> previous;
+	bool stored = StackProfileStorage::read(previous) && previous.size() == profile.size()
+			&& std::equal(profile.begin(), profile.begin() + 3, previous.begin());
+
+	if(stored) {
+		bool changed = false;
+
+		for(std::size_t i = 3; i < profile.size(); i++) {
+			changed |= profile[i] > previous[i];
+			profile[i] = std::max(profile[i], previous[i]);
+		}
+
+		// Sparing the flash from writing an unchanged profile
+		if(!changed) return true;
+	}
+
+	// Storing the profile
+	if(!StackProfileStorage::write(profile)) {
+		ESP_LOGE("DATAFLOW", "Failed to store the stack profile.");
+		return false;
+	}
+
+	return true;
+}
+
+bool Dataflow::saveSnapshot()
+{
+	// The snapshot starts with the format and the number of components in the graph
+	std::vector<uint8_t> buffer(DATAFLOW_SNAPSHOT_SIZE);
+	uint32_t header[2] = { SNAPSHOT_FORMAT, (uint32_t) m_components.size() };
+	memcpy(buffer.data(), header, sizeof(header));
+	std::size_t offset = sizeof(header);
+
+	// Appending a record of index, size and state for each component with state
+	const std::size_t recordHeader = 2 * sizeof(uint16_t);
+	for(std::size_t i = 0; i < m_components.size(); i++) {
+		if(offset + recordHeader > buffer.size()) break;
+
+		std::size_t size = m_components[i].m_component->saveState(buffer.data() + offset + recordHeader,
+		                                                          buffer.size() - offset - recordHeader);
+		if(size == 0) continue;
+
+		uint16_t record[2] = { (uint16_t) i, (uint16_t) size };
+		memcpy(buffer.data() + offset, record, sizeof(record));
+		offset += recordHeader + size;
+	}
+
+	// Storing the snapshot
+	if(!SnapshotStorage::write(buffer.data(), offset)) {
+		ESP_LOGE("DATAFLOW", "Failed to store snapshot of %u bytes.", (unsigned) offset);
+		return false;
+	}
+
+	return true;
+}
+
+bool Dataflow::restoreSnapshot()
+{
+	// Reading the stored snapshot, the checksum is validated by the storage
+	std::vector<uint8_t> buffer(DATAFLOW_SNAPSHOT_SIZE);
+	std::size_t length = SnapshotStorage::read(buffer.data());
+	if(length == 0) return false;
+
+	// The snapshot is consumed, so it is not restored again after a reset
+	SnapshotStorage::invalidate();
+
+	// Checking if the snapshot belongs to this graph
+	uint32_t header[2] = { 0, 0 };
+	if(length < sizeof(header)) return false;
+	memcpy(header, buffer.data(), sizeof(header));
+
+	if(header[0] != SNAPSHOT_FORMAT || header[1] != m_components.size()) {
+		ESP_LOGW("DATAFLOW", "Snapshot does not match the graph, ignoring it.");
+		return false;
+	}
+
+	// Validating all of the records before restoring anything
+	const std::size_t recordHeader = 2 * sizeof(uint16_t);
+	for(std::size_t offset = sizeof(header); offset < length; ) {
+		uint16_t record[2];
+		if(offset + recordHeader > length) return false;
+		memcpy(record, buffer.data() + offset, sizeof(record));
+
+		if(record[0] >= m_components.size() || offset + recordHeader + record[1] > length) return false;
+		offset += recordHeader + record[1];
+	}
+
+	// Restoring the state of the components
+	for(std::size_t offset = sizeof(header); offset < length; ) {
+		uint16_t record[2];
+		memcpy(record, buffer.data() + offset, sizeof(record));
+
+		m_components[record[0]].m_component->restoreState(buffer.data() + offset + recordHeader, record[1]);
+		offset += recordHeader + record[1];
+	}
+
+	return true;
+}
+
+void Dataflow::metrics(Node& snapshot) const
+{
+	snapshot.clear();
+
+	// Writing the state of the heap
+	Node& heap = snapshot["heap"];
+	heap["free"] = Allocator::freeBytes();
+	heap["minimum_free"] = Allocator::minimumFreeBytes();
+	heap["largest_free_block"] = Allocator::largestFreeBlock();
+
+	writeHeapStats(HeapAccount::unattributed().stats(), snapshot["unattributed"]);
+
+	// Writing the statistics of the components
+	Node& components = snapshot["components"];
+
+	for(const Entry& entry : m_components) {
+		Node& node = components.add("");
+		HeapStats stats = entry.m_component->heap().stats();
+		writeHeapStats(stats, node);
+
+		// Counting the messages received by the component
+		std::size_t messages = 0;
+		for(auto& port : entry.m_component->ports()) {
+			if(port.second.direction() == Port::Direction::INPUT) messages += port.second.messages();
+		}
+
+		node["messages"] = messages;
+		node["stack_size"] = entry.m_stackSize;
+		node["stack_used"] = stackUsage(entry);
+		node["allocations_per_message"] = (messages > 0) ? (double) stats.m_allocations / messages : 0.0;
 	}
 }
 
 void Dataflow::componentTaskFunction(void* componentPtr)
 {
-	while(true) static_cast<Component*>(componentPtr)->process();
+	Component* component = static_cast<Component*>(componentPtr);
+
+	// Charging the allocations of this task to the component
+	HeapAccount::select(&component->heap());
+
+#if defined(EXCEPTIONS_ENABLED)
+
+	// Running the component until it finishes, or its ports are closed by stopping the flow
+	try {
+		while(!component->finished()) component->process();
+	}
+	catch(const PortClosed&) {}
+
+#else
+
+	while(!component->finished()) component->process();
+
+#endif
+
+	// Closing the ports of the component, deleting the messages it would never receive
+	component->ports().close();
+
+	// Recording the stack usage and dropping the handle, so it is not used after the task exited
+	xSemaphoreTake(taskMutex(), portMAX_DELAY);
+	bool exiting = component->m_running.exchange(false);
+
+	if(exiting) {
+		component->m_stackFree = uxTaskGetStackHighWaterMark(nullptr);
+		component->m_task = nullptr;
+	}
+
+	xSemaphoreGive(taskMutex());
+
+	// Deleting the task, which returns its stack, unless it is being deleted by stop() already
+	if(exiting) vTaskDelete(nullptr);
+	else vTaskSuspend(nullptr);
+}
+
+uint32_t Dataflow::stackUsage(TaskHandle_t task, uint32_t stackSize)
+{
+	if(task == nullptr) return 0;
+
+	// The high-water mark is the least free stack space ever (in bytes on the ESP-IDF)
+	uint32_t free = uxTaskGetStackHighWaterMark(task);
+	return (free < stackSize) ? stackSize - free : 0;
+}
+
+uint32_t Dataflow::stackUsage(const Entry& entry)
+{
+	const Component* component = entry.m_component;
+	uint32_t free = UINT32_MAX;
+
+	// Measuring a running task, or taking the mark recorded when it exited
+	xSemaphoreTake(taskMutex(), portMAX_DELAY);
+	if(component->m_task != nullptr) free = uxTaskGetStackHighWaterMark(component->m_task);
+	else if(!entry.m_cooperative) free = component->m_stackFree;
+	xSemaphoreGive(taskMutex());
+
+	return (free < entry.m_stackSize) ? entry.m_stackSize - free : 0;
+}
+
+SemaphoreHandle_t Dataflow::taskMutex()
+{
+	static SemaphoreHandle_t mutex = xSemaphoreCreateMutex();
+	return mutex;
+}
+
+void Dataflow::writeHeapStats(const HeapStats& stats, Node& node)
+{
+	node["live_bytes"] = stats.m_liveBytes;
+	node["peak_bytes"] = stats.m_peakBytes;
+	node["allocations"] = stats.m_allocations;
+	node["deallocations"] = stats.m_deallocations;
 }
@@ -3,26 +3,308 @@
 #define DATAFLOW_DATAFLOW_H_INCLUDED
 
 // Standard includes
+#include <string>
 #include <vector>
+#include <cstdint>
 
 // FreeRTOS includes
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 
 // Project includes
 #include "component.h"
+#include "cooperative.h"
+#include "executor.h"
 
+// The stack size of the component and executor tasks without a stack profile
+#ifndef DATAFLOW_STACK_SIZE
+#define DATAFLOW_STACK_SIZE (4096)
+#endif
+
+// The stack size of all tasks while calibrating the stack profile
+#ifndef DATAFLOW_CALIBRATION_STACK_SIZE
+#define DATAFLOW_CALIBRATION_STACK_SIZE (8192)
+#endif
+
+// The share of the free heap the stacks of the tasks may take while calibrating, in percents
+#ifndef DATAFLOW_CALIBRATION_HEAP_SHARE
+#define DATAFLOW_CALIBRATION_HEAP_SHARE (50)
+#endif
+
+// The safety margin added to the measured stack usage, in percents
+#ifndef DATAFLOW_STACK_MARGIN
+#define DATAFLOW_STACK_MARGIN (25)
+#endif
+
+// The smallest stack size applied from the stack profile
+#ifndef DATAFLOW_MIN_STACK_SIZE
+#define DATAFLOW_MIN_STACK_SIZE (2048)
+#endif
+
+// The time given to the tasks to exit by themselves when stopping the flow
+#ifndef DATAFLOW_STOP_TIMEOUT
+#define DATAFLOW_STOP_TIMEOUT (pdMS_TO_TICKS(1000))
+#endif
+
+
+/**
+ * The Topology structure is the explicit adjacency model of a dataflow graph: the
+ * components are the vertices and the connections between their ports are the
+ * edges, each vertex listing its incoming and outgoing edges. The graph itself is
+ * only stored by the connections of the output ports, the model is built from them
+ * by Dataflow::topology() for inspecting the graph (eg. see DotExporter).
+ */
+struct Topology {
+
+	// Value of the vertex index of input ports not belonging to a component of the flow
+	static const std::size_t EXTERNAL = SIZE_MAX;
+
+	/**
+	 * The Vertex structure describes a component of the graph.
+	 */
+	struct Vertex {
+		std::string              m_name;        /**< The name of the component.                 */
+		Component*               m_component;   /**< Pointer to the component.                  */
+		bool                     m_cooperative; /**< Whether the component runs on an executor. */
+		std::vector<std::size_t> m_incoming;    /**< The indices of the edges ending here.      */
+		std::vector<std::size_t> m_outgoing;    /**< The indices of the edges starting here.    */
+	};
+
+	/**
+	 * The Edge structure describes a connection from an output port to an input port.
+	 */
+	struct Edge {
+		std::size_t m_source; /**< The index of the vertex of the output port.             */
+		Port*       m_output; /**< The output port.                                        */
+		std::size_t m_target; /**< The index of the vertex of the input port, or EXTERNAL. */
+		Port*       m_input;  /**< The input port.                                         */
+		std::size_t m_lane;   /**< The priority lane of the input port.                    */
+	};
+
+	std::vector<Vertex> m_vertices; /**< The components, in the order of adding. */
+	std::vector<Edge>   m_edges;    /**< The connections between the ports.      */
+};
 
 class Dataflow {
 public:
 
+	/**
+	 * The State enumeration represents the lifecycle of the flow.
+	 */
+	enum class State {
+		STOPPED, /**< No tasks are running, the graph can be started or torn down. */
+		RUNNING, /**< The tasks are running.                                       */
+		PAUSED   /**< The tasks are suspended.                                     */
+	};
+
+	/**
+	 * Constructs a Dataflow with the specified number of executor tasks
+	 * for running the cooperative components.
+	 * @param executorCount [in] The number of executor tasks to use.
+	 */
+	Dataflow(std::size_t executorCount = 1);
+
 	void addComponent(Component* component);
 
-	void startFlow();
+	/**
+	 * Adds a cooperative component, which is assigned to the executors
+	 * in a round-robin fashion instead of running on its own task.
+	 * @param component [in] Pointer to the cooperative component to add.
+	 */
+	void addComponent(CooperativeComponent* component);
+
+	/**
+	 * Sets the name of a component, which identifies it in the topology (eg. in the
+	 * exported graphs). The components are named by their index until named.
+	 * @param component [in] Pointer to the component added to the flow.
+	 * @param name      [in] The name of the component.
+	 */
+	void setName(Component* component, const std::string& name);
+
+	/**
+	 * Queries the adjacency model of the graph, which is built on the first call
+	 * after components are added or the flow is started (so connections made before
+	 * starting are included). This must not be called while adding components.
+	 * @return Reference to the topology of the graph.
+	 */
+	const Topology& topology();
+
+	/**
+	 * Validates the graph once it is built: the connections refused because of ports
+	 * of the wrong direction or not found (see Port::connect() and PortQuery) are
+	 * reported as errors, the input ports not connected (except the internal ones)
+	 * and the output ports nobody consumes are reported as warnings. The outputs
+	 * without subscribers are dead: sending to them returns immediately, and the
+	 * components can skip building their messages (see Port::hasSubscribers()).
+	 * This is called by the first startFlow() after adding components, unless it
+	 * was called already.
+	 * @return True when no connection was refused.
+	 */
+	bool finalize();
+
+	/**
+	 * Starts the tasks of the components and the executors. A stopped flow can be
+	 * started again, the input ports are reopened and the finished components are
+	 * restarted. When a task can not be created (eg. the heap is exhausted), the
+	 * tasks already started are stopped and the flow stays stopped. Nothing happens
+	 * unless the flow is stopped.
+	 * @return True when the flow is started, or it was not stopped.
+	 */
+	bool startFlow();
+
+	/**
+	 * Stops the flow: the input ports are closed and their queued messages are deleted,
+	 * which unwinds the components blocked on receiving (see PortClosed), then the tasks
+	 * delete themselves, returning their stacks. Tasks not exiting within the timeout
+	 * (eg. blocked on something else than a port) are deleted forcibly, leaking the
+	 * objects on their stack.
+	 * @param  timeout [in] The time to wait for the tasks to exit by themselves.
+	 * @return True when all of the tasks exited by themselves.
+	 */
+	bool stop(TickType_t timeout = DATAFLOW_STOP_TIMEOUT);
+
+	/**
+	 * Suspends the running tasks of the flow, messages keep queueing up on the ports.
+	 * Suspended tasks keep the locks they hold (eg. of a bus driver), so the flow should
+	 * only be paused when no other part of the application depends on them.
+	 */
+	void pause();
+
+	/**
+	 * Resumes the tasks of a paused flow.
+	 */
+	void resume();
+
+	/**
+	 * Stops the flow and releases everything allocated for the graph: the queues of
+	 * the ports are deleted and the components are removed from the flow. The
+	 * components can be destroyed afterwards, but must not be used in a flow again.
+	 */
+	void teardown();
+
+	/**
+	 * Queries the lifecycle state of the flow.
+	 * @return The state of the flow.
+	 */
+	State state() const noexcept;
+
+	/**
+	 * Saves the state of the components opting into snapshots, eg. right before
+	 * entering deep sleep. The snapshot is stored in RTC memory on the device.
+	 * @return True when the snapshot is stored successfully.
+	 */
+	bool saveSnapshot();
+
+	/**
+	 * Restores the state of the components from the last valid snapshot. This must
+	 * be called after all of the components are added, but before starting the flow.
+	 * The snapshot is rejected when it is corrupted or was saved by a different graph.
+	 * @return True when a snapshot is restored.
+	 */
+	bool restoreSnapshot();
+
+	/**
+	 * Enables the calibration mode, in which every task is started with a generous
+	 * stack (DATAFLOW_CALIBRATION_STACK_SIZE), so the stack usage can be measured by
+	 * saveStackProfile() after running the graph. The calibration stacks are reduced
+	 * (down to DATAFLOW_STACK_SIZE) when all of them would take more than the
+	 * DATAFLOW_CALIBRATION_HEAP_SHARE of the free heap. This must be called before starting
+	 * the flow, typically when loadStackProfile() found no profile.
+	 * @param enabled [in] Whether to start the tasks in calibration mode.
+	 */
+	void setStackCalibration(bool enabled) noexcept;
+
+	/**
+	 * Applies the stack sizes recorded by a calibration run, adding the safety margin
+	 * to the measured usage. This must be called after all of the components are
+	 * added, but before starting the flow. Tasks without a recorded usage keep the
+	 * default stack size, and the profile is rejected when it was saved by a
+	 * different graph.
+	 * @param  margin [in] The safety margin in percents of the measured usage.
+	 * @return True when a stack profile is applied.
+	 */
+	bool loadStackProfile(uint32_t margin = DATAFLOW_STACK_MARGIN);
+
+	/**
+	 * Measures the stack usage of the running tasks from their high-water marks,
+	 * and records it in the stack profile stored in flash. The recorded usage only
+	 * grows: the highest usage seen by any run is kept, and the profile is only
+	 * written when it changed. Call it after the graph has exercised its heaviest
+	 * paths (eg. right before entering deep sleep).
+	 * @return True when the profile is up to date in the storage.
+	 */
+	bool saveStackProfile();
+
+	/**
+	 * Collects the metrics of the flow into a snapshot, eg. to find the components
+	 * allocating the most per message. The snapshot contains the following Nodes:
+	 *
+	 * "heap"         - "free", "minimum_free" and "largest_free_block" bytes of the heap.
+	 * "unattributed" - The heap statistics of the allocations made outside of components.
+	 * "components"   - The statistics of the components, in the order of adding: the heap
+	 *                  statistics ("live_bytes", "peak_bytes", "allocations" and
+	 *                  "deallocations"), the "messages" received on the input ports,
+	 *                  the "allocations_per_message" made, and the "stack_size" and
+	 *                  "stack_used" bytes of their task (zero for cooperative ones).
+	 *
+	 * @param snapshot [out] The Node to store the metrics into, its content is replaced.
+	 */
+	void metrics(Node& snapshot) const;
 
 private:
 
 	static void componentTaskFunction(void* componentPtr);
 
-	std::vector<Component*> m_components;
+	/**
+	 * Writes the statistics of a heap account into a Node of the metrics snapshot.
+	 * @param stats [in]  The statistics to write.
+	 * @param node  [out] The Node to write the statistics into.
+	 */
+	static void writeHeapStats(const HeapStats& stats, Node& node);
+
+	/**
+	 * The Entry structure stores a component of the flow. The components are kept
+	 * in the order of adding, which identifies them in the snapshots.
+	 */
+	struct Entry {
+		Component*   m_component;   /**< Pointer to the component.                     */
+		bool         m_cooperative; /**< Whether the component runs on an executor.     */
+		uint32_t     m_stackSize;   /**< The stack size of the task of the component.   */
+		std::string  m_name;        /**< The name of the component in the topology.     */
+	};
+
+	/**
+	 * Measures the stack usage of a task from its high-water mark.
+	 * @param  task      [in] The handle of the task, nullptr when it is not started.
+	 * @param  stackSize [in] The stack size the task was created with.
+	 * @return The highest stack usage of the task in bytes, zero when not measurable.
+	 */
+	static uint32_t stackUsage(TaskHandle_t task, uint32_t stackSize);
+
+	/**
+	 * Measures the stack usage of the task of a component, which may have exited
+	 * already (its high-water mark is recorded when it exits then).
+	 * @param  entry [in] The entry of the component.
+	 * @return The highest stack usage of the task in bytes, zero when not measurable.
+	 */
+	static uint32_t stackUsage(const Entry& entry);
+
+	/**
+	 * Queries the mutex serializing the exit of the component tasks with the
+	 * operations using their handles, so no handle is used after its task exited.
+	 * @return The handle of the mutex.
+	 */
+	static SemaphoreHandle_t taskMutex();
+
+	std::vector<Entry>    m_components;
+	std::vector<Executor> m_executors;
+	std::vector<uint32_t> m_executorStacks; /**< The stack sizes of the executor tasks.   */
+	std::size_t           m_nextExecutor;
+	bool                  m_calibrating;    /**< Whether the tasks are started to calibrate. */
+	State                 m_state;          /**< The lifecycle state of the flow.            */
+	Topology              m_topology;       /**< The adjacency model of the graph.           */
+	bool                  m_topologyValid;  /**< Whether the topology is up to date.         */
+	bool                  m_finalized;      /**< Whether the graph is validated.             */
 };
 
 #endif // DATAFLOW_DATAFLOW_H_INCLUDED
@@ -0,0 +1,133 @@
+#include "dot_export.h"
+
+// Standard includes
+#include <cstdio>
+#include <cstdarg>
+#include <algorithm>
+
+DotExporter::DotExporter(Dataflow& flow)
+	: m_flow(flow), m_last(std::chrono::steady_clock::now())
+{}
+
+void DotExporter::write(std::string& dot)
+{
+	const Topology& topology = m_flow.topology();
+
+	// Measuring the time since the previous export
+	auto now = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(now - m_last).count();
+	m_last = now;
+
+	// Starting from zero counters when the graph changed
+	if(m_samples.size() != topology.m_edges.size()) m_samples.assign(topology.m_edges.size(), Sample{ 0, 0, 0, 0 });
+
+	// Calculating the rates first, the widths of the edges are relative to the hottest one
+	m_rates.resize(topology.m_edges.size());
+	double hottest = 0;
+
+	for(std::size_t i = 0; i < topology.m_edges.size(); i++) {
+		std::size_t sent = topology.m_edges[i].m_output->messages();
+		m_rates[i] = (seconds > 0) ? (sent - m_samples[i].m_sent) / seconds : 0.0;
+		hottest = std::max(hottest, m_rates[i]);
+	}
+
+	dot.clear();
+	dot += "digraph dataflow {\n\trankdir=LR;\n\tnode [shape=box, fontsize=10];\n\tedge [fontsize=9];\n";
+
+	// Writing the components, the cooperative ones are rounded
+	for(const Topology::Vertex& vertex : topology.m_vertices) {
+		dot += "\t\"";
+		escape(dot, vertex.m_name);
+		append(dot, "\"%s;\n", vertex.m_cooperative ? " [style=rounded]" : "");
+	}
+
+	// Writing the connections with their statistics
+	for(std::size_t i = 0; i < topology.m_edges.size(); i++) {
+		const Topology::Edge& edge = topology.m_edges[i];
+		Sample& sample = m_samples[i];
+
+		Sample current = { edge.m_output->messages(), edge.m_input->messages(), edge.m_input->latency(), edge.m_input->dropped() };
+		std::size_t received = current.m_received - sample.m_received;
+		double latency = (received > 0) ? (current.m_latency - sample.m_latency) / 1000.0 / received : 0.0;
+
+		std::size_t depth = edge.m_input->depth();
+		std::size_t capacity = edge.m_input->capacity();
+		bool hot = capacity > 0 && depth >= DATAFLOW_DOT_HOT_QUEUE * capacity;
+
+		// Ports outside of the flow are drawn as points
+		dot += "\t\"";
+		escape(dot, topology.m_vertices[edge.m_source].m_name);
+
+		if(edge.m_target == Topology::EXTERNAL) {
+			append(dot, "\" -> \"external %u\"", (unsigned) i);
+		}
+		else {
+			dot += "\" -> \"";
+			escape(dot, topology.m_vertices[edge.m_target].m_name);
+			dot += '"';
+		}
+
+		// Labeling the edge with the rate of the output port
+		dot += " [label=\"";
+		escape(dot, edge.m_output->name());
+		dot += " > ";
+		escape(dot, edge.m_input->name());
+		append(dot, "\\n%.1f msg/s\"", m_rates[i]);
+
+		// Labeling the head with the statistics of the input port, only on the first
+		// edge into it, as the edges into the same input share its queue
+		bool first = true;
+		for(std::size_t j = 0; j < i && first; j++) first = topology.m_edges[j].m_input != edge.m_input;
+
+		if(first) {
+			append(dot, ", headlabel=\"queue %u/%u\\n%.1f ms", (unsigned) depth, (unsigned) capacity, latency);
+			if(current.m_dropped != sample.m_dropped) append(dot, "\\n%u dropped", (unsigned) (current.m_dropped - sample.m_dropped));
+			dot += '"';
+		}
+
+		append(dot, ", penwidth=%.1f%s];\n", (hottest > 0) ? 1.0 + 4.0 * m_rates[i] / hottest : 1.0, hot ? ", color=red" : "");
+
+		// Points of the external ports follow their edges
+		if(edge.m_target == Topology::EXTERNAL) append(dot, "\t\"external %u\" [shape=point];\n", (unsigned) i);
+
+		sample = current;
+	}
+
+	dot += "}\n";
+}
+
+void DotExporter::escape(std::string& dot, const std::string& text)
+{
+	// Escaping the quotes and backslashes, which would end or break the quoted string
+	for(char character : text) {
+		if(character == '"' || character == '\\') dot += '\\';
+		dot += character;
+	}
+}
+
+void DotExporter::append(std::string& dot, const char* format, ...)
+{
+	char buffer[160];
+
+	// Formatting into a buffer on the stack, falling back to the heap for long lines
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(buffer, sizeof(buffer), format, args);
+	va_end(args);
+
+	if(length < 0) return;
+
+	if(static_cast<std::size_t>(length) < sizeof(buffer)) {
+		dot.append(buffer, length);
+		return;
+	}
+
+	std::size_t offset = dot.size();
+	dot.resize(offset + length + 1);
+
+	va_start(args, format);
+	vsnprintf(&dot[offset], length + 1, format, args);
+	va_end(args);
+
+	dot.resize(offset + length);
+}
@@ -0,0 +1,85 @@
+#pragma once
+#ifndef DATAFLOW_DOT_EXPORT_H_INCLUDED
+#define DATAFLOW_DOT_EXPORT_H_INCLUDED
+
+// Standard includes
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Project includes
+#include "dataflow.h"
+
+// The fill ratio of the input queues from which the edges are highlighted
+#ifndef DATAFLOW_DOT_HOT_QUEUE
+#define DATAFLOW_DOT_HOT_QUEUE (0.75)
+#endif
+
+
+/**
+ * The DotExporter class exports the topology of a Dataflow in the Graphviz DOT
+ * format, annotated with the live statistics of the edges: the message rate of
+ * the output port labels the edge, while the depth of the input queue, the mean
+ * queueing latency and the messages dropped label its head. These belong to the
+ * input port, so they are only written on the first edge into an input port shared
+ * by more outputs. The rates and latencies are measured over the time since the
+ * previous export (or since constructing the exporter), the width of the edges is
+ * proportional to their rate, and the edges into queues filling up are drawn red,
+ * so the hot edges and bottlenecks stand out. Exporting only reads the counters of
+ * the ports and reuses the buffers, so it is cheap enough to run periodically on
+ * the device (eg. logging the graph every minute).
+ *
+ * digraph dataflow {
+ *     "sensor" -> "display" [label="out > in\n1.0 msg/s", headlabel="queue 0/10\n0.4 ms"];
+ * }
+ */
+class DotExporter {
+public:
+
+	/**
+	 * Constructs a DotExporter for a Dataflow, which must outlive it.
+	 * @param flow [in] The Dataflow to export.
+	 */
+	explicit DotExporter(Dataflow& flow);
+
+	/**
+	 * Exports the graph with the statistics measured since the previous export.
+	 * @param dot [out] The string to write the DOT description into, its content is replaced.
+	 */
+	void write(std::string& dot);
+
+private:
+
+	/**
+	 * The Sample structure stores the counters of an edge at the previous export.
+	 */
+	struct Sample {
+		std::size_t m_sent;     /**< The messages sent by the output port.         */
+		std::size_t m_received; /**< The messages received by the input port.      */
+		uint64_t    m_latency;  /**< The total queueing latency of the input port. */
+		std::size_t m_dropped;  /**< The messages dropped by the input port.       */
+	};
+
+	/**
+	 * Appends text to the DOT description, escaped to fit into a quoted string.
+	 * @param dot  [in] The string to append to.
+	 * @param text [in] The text to append (eg. the name of a component).
+	 */
+	static void escape(std::string& dot, const std::string& text);
+
+	/**
+	 * Appends formatted text to the DOT description.
+	 * @param dot    [in] The string to append to.
+	 * @param format [in] The printf format of the text.
+	 */
+	static void append(std::string& dot, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+	Dataflow&                             m_flow;    /**< The Dataflow to export.                       */
+	std::vector<Sample>                   m_samples; /**< The counters of the edges at the last export. */
+	std::vector<double>                   m_rates;   /**< The message rates of the edges.               */
+	std::chrono::steady_clock::time_point m_last;    /**< The time of the last export.                  */
+};
+
+#endif // DATAFLOW_DOT_EXPORT_H_INCLUDED
@@ -0,0 +1,114 @@
+#include "executor.h"
+
+Executor::Executor() noexcept
+	: m_task(nullptr), m_stackSize(0), m_stopping(false), m_running(false)
+{}
+
+void Executor::addComponent(CooperativeComponent* component)
+{
+	m_components.push_back(component);
+}
+
+bool Executor::empty() const noexcept
+{
+	return m_components.empty();
+}
+
+bool Executor::start(uint32_t stackDepth, UBaseType_t priority, BaseType_t core)
+{
+	m_stackSize = stackDepth;
+	m_stopping = false;
+	m_running = true;
+
+	if(xTaskCreatePinnedToCore(executorTaskFunction, "executor", stackDepth, this, priority, &m_task, core) != pdPASS) {
+		m_running = false;
+		m_task = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+void Executor::stop() noexcept
+{
+	// Waking up the task to notice the request
+	m_stopping = true;
+	if(m_running && m_task != nullptr) xTaskNotifyGive(m_task);
+}
+
+bool Executor::kill() noexcept
+{
+	// Deleting the task, unless it is deleting itself (see executorTaskFunction)
+	bool killed = m_running.exchange(false);
+	if(killed) vTaskDelete(m_task);
+
+	m_task = nullptr;
+	return killed;
+}
+
+bool Executor::running() const noexcept
+{
+	return m_running;
+}
+
+void Executor::clear() noexcept
+{
+	m_components.clear();
+}
+
+TaskHandle_t Executor::task() const noexcept
+{
+	return m_task;
+}
+
+uint32_t Executor::stackSize() const noexcept
+{
+	return m_stackSize;
+}
+
+void Executor::executorTaskFunction(void* executorPtr)
+{
+	Executor* executor = static_cast<Executor*>(executorPtr);
+
+	// Registering this task for notifications on the input ports of the components
+	for(CooperativeComponent* component : executor->m_components) {
+		component->attach(xTaskGetCurrentTaskHandle());
+	}
+
+	while(!executor->m_stopping) {
+
+		// Resuming the components until all of them are suspended on empty ports
+		bool progressed = true;
+		while(progressed && !executor->m_stopping) {
+			progressed = false;
+			for(CooperativeComponent* component : executor->m_components) {
+				if(component->finished()) continue;
+
+#if defined(EXCEPTIONS_ENABLED)
+
+				// Finishing the components whose ports are closed
+				try { progressed |= component->resume(); }
+				catch(const PortClosed&) {
+					HeapAccount::select(nullptr);
+					component->ports().finish();
+				}
+
+#else
+
+				progressed |= component->resume();
+
+#endif
+
+				// Closing the ports of the finished components, dropping their messages
+				if(component->finished()) component->ports().close();
+			}
+		}
+
+		// Sleeping until a message arrives to any of the components
+		if(!executor->m_stopping) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+	}
+
+	// Deleting the task, unless it is being deleted by kill() already
+	if(executor->m_running.exchange(false)) vTaskDelete(nullptr);
+	else vTaskSuspend(nullptr);
+}
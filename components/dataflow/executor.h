@@ -0,0 +1,102 @@
+#pragma once
+#ifndef DATAFLOW_EXECUTOR_H_INCLUDED
+#define DATAFLOW_EXECUTOR_H_INCLUDED
+
+// Standard includes
+#include <atomic>
+#include <vector>
+
+// FreeRTOS includes
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Project includes
+#include "cooperative.h"
+
+
+/**
+ * The Executor class runs a set of cooperative components on a single task.
+ * The executor sleeps on its task notification, which is given by the input
+ * ports of its components when a message arrives. After waking up, it resumes
+ * the components in turn until none of them is able to make progress.
+ */
+class Executor {
+public:
+
+	/**
+	 * Constructs an Executor without components, which is not started.
+	 */
+	Executor() noexcept;
+
+	/**
+	 * Adds a cooperative component to be run by this executor.
+	 * @param component [in] Pointer to the component to add.
+	 */
+	void addComponent(CooperativeComponent* component);
+
+	/**
+	 * Queries whether the executor has any components to run.
+	 * @return True when there are no components added to the executor.
+	 */
+	bool empty() const noexcept;
+
+	/**
+	 * Creates the task of the executor and starts running the components.
+	 * @param  stackDepth [in] The stack size of the executor task in bytes.
+	 * @param  priority   [in] The priority of the executor task.
+	 * @param  core       [in] The CPU core to pin the executor task to.
+	 * @return True when the task is created.
+	 */
+	bool start(uint32_t stackDepth, UBaseType_t priority, BaseType_t core);
+
+	/**
+	 * Requests the executor task to stop after the current pass over the components.
+	 * The task deletes itself, the input ports of the components are not closed.
+	 */
+	void stop() noexcept;
+
+	/**
+	 * Deletes the executor task immediately, when it did not stop by itself.
+	 * @return True when the task had to be deleted.
+	 */
+	bool kill() noexcept;
+
+	/**
+	 * Queries whether the executor task is running.
+	 * @return True when the task is started and has not stopped yet.
+	 */
+	bool running() const noexcept;
+
+	/**
+	 * Removes all of the components from the executor, which must not be running.
+	 */
+	void clear() noexcept;
+
+	/**
+	 * Queries the task of the executor.
+	 * @return The handle of the executor task, nullptr when it is not started.
+	 */
+	TaskHandle_t task() const noexcept;
+
+	/**
+	 * Queries the stack size the executor task was created with.
+	 * @return The stack size of the executor task in bytes, zero when it is not started.
+	 */
+	uint32_t stackSize() const noexcept;
+
+private:
+
+	/**
+	 * Implements the scheduling loop of the executor task.
+	 * @param executorPtr [in] Pointer to the Executor object.
+	 */
+	static void executorTaskFunction(void* executorPtr);
+
+	std::vector<CooperativeComponent*> m_components; /**< The components run by this executor.  */
+	TaskHandle_t                       m_task;       /**< The handle of the executor task.      */
+	uint32_t                           m_stackSize;  /**< The stack size of the executor task.  */
+	std::atomic<bool>                  m_stopping;   /**< Whether the task is requested to stop. */
+	std::atomic<bool>                  m_running;    /**< Whether the task is running.           */
+};
+
+#endif // DATAFLOW_EXECUTOR_H_INCLUDED
@@ -0,0 +1,217 @@
+#include "graph_loader.h"
+
+// Standard includes
+#include <set>
+#include <cstdio>
+
+// ESP-IDF includes
+#include "esp_log.h"
+
+GraphLoader::GraphLoader(const ComponentRegistry& registry)
+	: m_registry(registry)
+{}
+
+GraphLoader::~GraphLoader()
+{
+	// Deleting the components created by the loader
+	for(auto& instance : m_components) delete instance.second.m_component;
+}
+
+bool GraphLoader::loadFile(const std::string& path, Dataflow& flow)
+{
+	// Opening the description file
+	FILE* fp = fopen(path.c_str(), "r");
+	if(fp == nullptr) return fail("Could not open graph description: " + path);
+
+	// Reading the whole content of the file
+	std::string json;
+	char buffer[128];
+	std::size_t count = 0;
+	while((count = fread(buffer, 1, sizeof(buffer), fp)) > 0) json.append(buffer, count);
+
+	// Closing the file
+	fclose(fp);
+
+	return loadString(json, flow);
+}
+
+bool GraphLoader::loadString(const std::string& json, Dataflow& flow)
+{
+	// Parsing the description
+	JsonObject graph = JsonObject::parse(json);
+	if(!graph.isObject()) return fail("Graph description is not a valid JSON object.");
+
+	return load(graph, flow);
+}
+
+Component* GraphLoader::operator[](const std::string& name) noexcept
+{
+	auto it = m_components.find(name);
+	return (it != m_components.end()) ? it->second.m_component : nullptr;
+}
+
+const std::string& GraphLoader::error() const noexcept
+{
+	return m_error;
+}
+
+bool GraphLoader::load(const JsonObject& graph, Dataflow& flow)
+{
+	// Clearing the error of previous loads
+	m_error.clear();
+
+	// Validating the component declarations before creating anything
+	const JsonObject components = graph["components"];
+	if(!components.isObject()) return fail("Missing \"components\" object.");
+
+	std::set<std::string> declared;
+
+	for(std::size_t i = 0; i < components.size(); i++) {
+		const JsonObject declaration = components[i];
+
+		if(m_components.count(declaration.name()) != 0 || !declared.insert(declaration.name()).second) {
+			return fail("Duplicate component name: " + declaration.name());
+		}
+
+		if(!declaration["type"].isString() || !m_registry.contains(declaration["type"].getString())) {
+			return fail("Unknown type for component: " + declaration.name());
+		}
+	}
+
+	// Creating the components with the registered factories
+	std::vector<std::string> created;
+	bool success = true;
+
+	for(std::size_t i = 0; i < components.size() && success; i++) {
+		const JsonObject declaration = components[i];
+
+		// Converting the parameters of the component
+		Node parameters("params");
+		if(declaration["params"].isObject()) convert(declaration["params"], parameters);
+
+		// Creating the component
+		std::string type = declaration["type"].getString();
+		Component* component = m_registry.create(type, parameters);
+
+		if(component == nullptr) {
+			success = fail("Failed to create component: " + declaration.name());
+			break;
+		}
+
+		m_components[declaration.name()] = Instance{ component, type };
+		created.push_back(declaration.name());
+	}
+
+	// Resolving all of the port bindings before connecting anything
+	std::vector<Binding> connections;
+	const JsonObject bindings = graph["connections"];
+
+	for(std::size_t i = 0; i < bindings.size() && success; i++) {
+		const JsonObject binding = bindings[i];
+
+		// Checking the format of the connection
+		if(!binding.isArray() || binding.size() < 2 || binding.size() > 3 || !binding[0].isString()
+				|| !binding[1].isString() || (binding.size() == 3 && (!binding[2].isNumber() || binding[2].getInteger() < 0))) {
+			success = fail("Connection must be a pair of \"component.port\" strings and an optional lane.");
+			break;
+		}
+
+		// Resolving the ports of the connection
+		Port* output = resolve(binding[0].getString());
+		Port* input  = resolve(binding[1].getString());
+
+		if(output == nullptr || output->direction() != Port::Direction::OUTPUT) {
+			success = fail("Not an output port: " + binding[0].getString());
+		}
+		else if(input == nullptr || input->direction() != Port::Direction::INPUT) {
+			success = fail("Not an input port: " + binding[1].getString());
+		}
+		else if(binding.size() == 3 && (std::size_t) binding[2].getInteger() >= input->lanes()) {
+			success = fail("Lane out of range for input port: " + binding[1].getString());
+		}
+		else {
+			std::size_t lane = (binding.size() == 3) ? binding[2].getInteger() : 0;
+			connections.push_back(Binding{ output, input, lane });
+		}
+	}
+
+	// Resolving the ports receiving initial messages
+	std::vector<Port*> initials;
+	const JsonObject initial = graph["initial"];
+
+	for(std::size_t i = 0; i < initial.size() && success; i++) {
+		Port* port = initial[i].isString() ? resolve(initial[i].getString()) : nullptr;
+
+		if(port == nullptr || port->direction() != Port::Direction::INPUT) {
+			success = fail("Initial message target is not an input port.");
+		}
+		else {
+			initials.push_back(port);
+		}
+	}
+
+	// Releasing the components of this graph on failure
+	if(!success) {
+		for(const std::string& name : created) {
+			delete m_components[name].m_component;
+			m_components.erase(name);
+		}
+
+		return false;
+	}
+
+	// Connecting the ports, the graph is valid at this point
+	for(const Binding& connection : connections) {
+		connection.m_output->connect(*connection.m_input, connection.m_lane);
+	}
+
+	// Sending the initial messages
+	for(Port* port : initials) port->send(Node());
+
+	// Adding the components to the Dataflow
+	for(const std::string& name : created) {
+		m_registry.install(m_components[name].m_type, m_components[name].m_component, flow);
+		flow.setName(m_components[name].m_component, name);
+	}
+
+	return true;
+}
+
+Port* GraphLoader::resolve(const std::string& reference)
+{
+	// Splitting the reference to component and port names
+	std::size_t separator = reference.rfind('.');
+	if(separator == std::string::npos) return nullptr;
+
+	// Searching for the component
+	Component* component = (*this)[reference.substr(0, separator)];
+	if(component == nullptr) return nullptr;
+
+	// Searching for the port of the component
+	return component->ports().find(reference.substr(separator + 1));
+}
+
+void GraphLoader::convert(const JsonObject& json, Node& node)
+{
+	// Converting scalar values
+	if(json.isBool())   node = json.getBool();
+	if(json.isNumber()) node = json.getDouble();
+	if(json.isString()) node = json.getString();
+
+	// Converting arrays into indexed children and objects into named children
+	if(json.isArray() || json.isObject()) {
+		for(std::size_t i = 0; i < json.size(); i++) {
+			const std::string name = json[i].name();
+			convert(json[i], node.add(name));
+		}
+	}
+}
+
+bool GraphLoader::fail(const std::string& message)
+{
+	// Storing and logging the error
+	m_error = message;
+	ESP_LOGE("DATAFLOW", "Graph loading failed: %s", m_error.c_str());
+
+	return false;
+}
@@ -0,0 +1,139 @@
+#pragma once
+#ifndef DATAFLOW_GRAPH_LOADER_H_INCLUDED
+#define DATAFLOW_GRAPH_LOADER_H_INCLUDED
+
+// Standard includes
+#include <map>
+#include <string>
+#include <vector>
+
+// Project includes
+#include "json.h"
+#include "dataflow.h"
+#include "registry.h"
+
+
+/**
+ * The GraphLoader class builds a dataflow graph from a JSON description. The
+ * components are created through a ComponentRegistry, then all of the port
+ * bindings are resolved and validated before anything is connected, so a
+ * faulty description leaves the Dataflow untouched. Once loaded, the graph is
+ * connected exactly as if it was written by hand with the >> operators, so
+ * there is no overhead per message. The loader owns the created components,
+ * and must outlive the Dataflow it loaded them into.
+ *
+ * The description has the following format, where connections are made from
+ * OUTPUT ports to INPUT ports (optionally to the priority lane given as the
+ * third element, which must be below the number of lanes of the port), and the
+ * INPUT ports listed in "initial" receive an empty initial message to kickstart
+ * the flow. Component names must be unique:
+ *
+ * {
+ *     "components": {
+ *         "master": { "type": "DF_I2C_Master", "params": { "port": 1, "scl_pin": 21, ... } },
+ *         "sensor": { "type": "DF_BME280" }
+ *     },
+ *     "connections": [
+ *         [ "master.interface", "sensor.interface" ],
+ *         [ "sensor.out", "display.in", 1 ]
+ *     ],
+ *     "initial": [ "sensor.in" ]
+ * }
+ */
+class GraphLoader {
+public:
+
+	/**
+	 * Constructs a GraphLoader using the specified registry for creating components.
+	 * @param registry [in] The registry of the available component types.
+	 */
+	GraphLoader(const ComponentRegistry& registry);
+
+	/**
+	 * Destroys the GraphLoader and the components created by it.
+	 */
+	~GraphLoader();
+
+	/**
+	 * Loads the graph from a JSON file, eg. from a mounted SPIFFS partition or SD card.
+	 * @param  path [in] The path of the JSON file (eg. "/spiffs/graph.json").
+	 * @param  flow [in] The Dataflow to add the components to.
+	 * @return True when the graph is loaded successfully.
+	 */
+	bool loadFile(const std::string& path, Dataflow& flow);
+
+	/**
+	 * Loads the graph from a JSON string, eg. from a blob embedded into the firmware.
+	 * @param  json [in] The JSON description of the graph.
+	 * @param  flow [in] The Dataflow to add the components to.
+	 * @return True when the graph is loaded successfully.
+	 */
+	bool loadString(const std::string& json, Dataflow& flow);
+
+	/**
+	 * Queries the loaded component with the specified instance name.
+	 * @param  name [in] The instance name of the component in the description.
+	 * @return Pointer to the component, or nullptr when it does not exist.
+	 */
+	Component* operator[](const std::string& name) noexcept;
+
+	/**
+	 * Queries the description of the last error that occurred while loading.
+	 * @return The description of the error, or an empty string.
+	 */
+	const std::string& error() const noexcept;
+
+private:
+
+	/**
+	 * Builds the graph from the parsed JSON description.
+	 * @param  graph [in] The parsed JSON description of the graph.
+	 * @param  flow  [in] The Dataflow to add the components to.
+	 * @return True when the graph is loaded successfully.
+	 */
+	bool load(const JsonObject& graph, Dataflow& flow);
+
+	/**
+	 * Resolves a "component.port" reference to a Port of a loaded component.
+	 * @param  reference [in] The reference to resolve.
+	 * @return Pointer to the Port, or nullptr when it does not exist.
+	 */
+	Port* resolve(const std::string& reference);
+
+	/**
+	 * Converts a JSON value to the equivalent Node representation.
+	 * @param json [in] The JSON value to convert.
+	 * @param node [in] The Node to store the converted value into.
+	 */
+	static void convert(const JsonObject& json, Node& node);
+
+	/**
+	 * Records and logs the description of an error.
+	 * @param  message [in] The description of the error.
+	 * @return Always false, for reporting the failure.
+	 */
+	bool fail(const std::string& message);
+
+	/**
+	 * The Binding structure stores a resolved connection between two Ports.
+	 */
+	struct Binding {
+		Port*       m_output; /**< The OUTPUT Port of the connection.          */
+		Port*       m_input;  /**< The INPUT Port of the connection.           */
+		std::size_t m_lane;   /**< The priority lane of the INPUT Port to use. */
+	};
+
+	/**
+	 * The Instance structure stores a created component and its type name.
+	 */
+	struct Instance {
+		Component*  m_component; /**< Pointer to the created component. */
+		std::string m_type;      /**< The registered type name.         */
+	};
+
+	const ComponentRegistry&        m_registry;   /**< The registry used to create components. */
+	std::map<std::string, Instance> m_components; /**< The components created by the loader.   */
+	std::string                     m_error;      /**< The description of the last error.      */
+};
+
+#endif // DATAFLOW_GRAPH_LOADER_H_INCLUDED
@@ -0,0 +1,221 @@
+#include "heap.h"
+
+// Standard includes
+#include <new>
+#include <cstdlib>
+
+#if defined(ESP_PLATFORM)
+
+// ESP-IDF includes
+#include "esp_heap_caps.h"
+
+#endif
+
+/**
+ * The header preceding the allocations when accounting is enabled, padded to
+ * keep the allocation aligned for any type.
+ */
+union AllocationHeader {
+	struct {
+		uint16_t    m_slot; /**< The slot of the account charged with the allocation. */
+		std::size_t m_size; /**< The size of the allocation in bytes.                 */
+	} m_info;
+	std::max_align_t m_alignment;
+};
+
+// The hooks obtaining and releasing memory
+static Allocator::AllocateFunction   s_allocate   = &malloc;
+static Allocator::DeallocateFunction s_deallocate = &free;
+
+// The account selected by the task, nullptr selects the unattributed account
+static thread_local HeapAccount* s_current = nullptr;
+
+// HeapAccount
+
+HeapAccount::Slot HeapAccount::s_slots[DATAFLOW_HEAP_ACCOUNTS];
+
+HeapAccount::HeapAccount() noexcept
+	: m_slot(acquire())
+{}
+
+HeapAccount::HeapAccount(uint16_t slot) noexcept
+	: m_slot(slot)
+{}
+
+HeapAccount::~HeapAccount()
+{
+	// Keeping the counters of the allocations still referring to the slot
+	if(m_slot != 0) s_slots[m_slot].m_state = SLOT_RETIRED;
+}
+
+HeapStats HeapAccount::stats() const noexcept
+{
+	const Slot& slot = s_slots[m_slot];
+	HeapStats stats = { slot.m_liveBytes.load(), slot.m_peakBytes.load(), slot.m_allocations.load(), slot.m_deallocations.load() };
+
+	// Reporting the allocations of the destroyed accounts as unattributed
+	if(m_slot == 0) {
+		for(std::size_t i = 1; i < DATAFLOW_HEAP_ACCOUNTS; i++) {
+			if(s_slots[i].m_state == SLOT_RETIRED) stats.m_liveBytes += s_slots[i].m_liveBytes.load();
+		}
+
+		if(stats.m_peakBytes < stats.m_liveBytes) stats.m_peakBytes = stats.m_liveBytes;
+	}
+
+	return stats;
+}
+
+void HeapAccount::reset() noexcept
+{
+	Slot& slot = s_slots[m_slot];
+
+	slot.m_peakBytes = slot.m_liveBytes.load();
+	slot.m_allocations = 0;
+	slot.m_deallocations = 0;
+}
+
+HeapAccount* HeapAccount::select(HeapAccount* account) noexcept
+{
+	HeapAccount* previous = s_current;
+	s_current = account;
+
+	return previous;
+}
+
+HeapAccount& HeapAccount::current() noexcept
+{
+	return (s_current != nullptr) ? *s_current : unattributed();
+}
+
+HeapAccount& HeapAccount::unattributed() noexcept
+{
+	static HeapAccount s_unattributed(0);
+	return s_unattributed;
+}
+
+uint16_t HeapAccount::acquire() noexcept
+{
+	for(uint16_t i = 1; i < DATAFLOW_HEAP_ACCOUNTS; i++) {
+		Slot& slot = s_slots[i];
+
+		// Taking a free slot, or a retired one nothing refers to anymore
+		uint8_t state = SLOT_FREE;
+		bool taken = slot.m_state.compare_exchange_strong(state, SLOT_USED);
+
+		if(!taken && state == SLOT_RETIRED && slot.m_liveBytes == 0) {
+			taken = slot.m_state.compare_exchange_strong(state, SLOT_USED);
+		}
+
+		if(!taken) continue;
+
+		slot.m_peakBytes = 0;
+		slot.m_allocations = 0;
+		slot.m_deallocations = 0;
+		return i;
+	}
+
+	// Sharing the unattributed slot when the table is full
+	return 0;
+}
+
+void HeapAccount::charge(uint16_t index, std::size_t size) noexcept
+{
+	Slot& slot = s_slots[index];
+	std::size_t live = (slot.m_liveBytes += size);
+	slot.m_allocations++;
+
+	// Raising the peak, unless another task raised it higher meanwhile
+	std::size_t peak = slot.m_peakBytes.load();
+	while(live > peak && !slot.m_peakBytes.compare_exchange_weak(peak, live)) {}
+}
+
+void HeapAccount::credit(uint16_t index, std::size_t size) noexcept
+{
+	Slot& slot = s_slots[index];
+	slot.m_liveBytes -= size;
+	slot.m_deallocations++;
+}
+
+// Allocator
+
+void Allocator::setHooks(AllocateFunction allocate, DeallocateFunction deallocate) noexcept
+{
+	s_allocate = allocate;
+	s_deallocate = deallocate;
+}
+
+void* Allocator::allocate(std::size_t size)
+{
+#if DATAFLOW_HEAP_TELEMETRY
+
+	// Allocating the header before the memory, recording the account charged
+	AllocationHeader* header = static_cast<AllocationHeader*>(s_allocate(sizeof(AllocationHeader) + size));
+	void* memory = nullptr;
+
+	if(header != nullptr) {
+		header->m_info.m_slot = HeapAccount::current().m_slot;
+		header->m_info.m_size = size;
+		HeapAccount::charge(header->m_info.m_slot, size);
+		memory = header + 1;
+	}
+
+#else
+
+	void* memory = s_allocate(size);
+
+#endif
+
+#if defined(__cpp_exceptions)
+
+	// Reporting the failed allocation like operator new would
+	if(memory == nullptr) throw std::bad_alloc();
+
+#endif
+
+	return memory;
+}
+
+void Allocator::deallocate(void* pointer) noexcept
+{
+	if(pointer == nullptr) return;
+
+#if DATAFLOW_HEAP_TELEMETRY
+
+	// Crediting the account charged with the allocation
+	AllocationHeader* header = static_cast<AllocationHeader*>(pointer) - 1;
+	HeapAccount::credit(header->m_info.m_slot, header->m_info.m_size);
+	s_deallocate(header);
+
+#else
+
+	s_deallocate(pointer);
+
+#endif
+}
+
+std::size_t Allocator::freeBytes() noexcept
+{
+#if defined(ESP_PLATFORM)
+	return heap_caps_get_free_size(MALLOC_CAP_8BIT);
+#else
+	return 0;
+#endif
+}
+
+std::size_t Allocator::minimumFreeBytes() noexcept
+{
+#if defined(ESP_PLATFORM)
+	return heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+#else
+	return 0;
+#endif
+}
+
+std::size_t Allocator::largestFreeBlock() noexcept
+{
+#if defined(ESP_PLATFORM)
+	return heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+#else
+	return 0;
+#endif
+}
@@ -0,0 +1,213 @@
+#pragma once
+#ifndef DATAFLOW_HEAP_H_INCLUDED
+#define DATAFLOW_HEAP_H_INCLUDED
+
+// Standard includes
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// Enables the accounting of the allocations of Nodes and payloads per component,
+// at the cost of a small header (eg. 8 bytes on the ESP32) for each allocation
+#ifndef DATAFLOW_HEAP_TELEMETRY
+#define DATAFLOW_HEAP_TELEMETRY (1)
+#endif
+
+// The number of heap accounts existing at once, including the unattributed one
+#ifndef DATAFLOW_HEAP_ACCOUNTS
+#define DATAFLOW_HEAP_ACCOUNTS (64)
+#endif
+
+
+/**
+ * The HeapStats structure stores the allocation statistics of a HeapAccount.
+ */
+struct HeapStats {
+	std::size_t m_liveBytes;     /**< The number of bytes currently allocated.        */
+	std::size_t m_peakBytes;     /**< The highest number of bytes allocated at once.  */
+	std::size_t m_allocations;   /**< The number of allocations made since the reset. */
+	std::size_t m_deallocations; /**< The number of allocations freed since the reset. */
+};
+
+/**
+ * The HeapAccount class collects the allocation statistics of a part of the
+ * application, typically a Component. Every task has a current account, which
+ * is charged with the allocations made through the Allocator on that task, and
+ * the allocations are credited back to the same account when freed, no matter
+ * which task frees them (eg. messages are freed by the receivers). The Dataflow
+ * selects the account of the Component running on the task.
+ *
+ * The counters of the accounts are kept in a static table, and the allocations
+ * refer to their slot of the table, so messages may outlive the Component which
+ * built them (eg. stored by another Component). When an account is destroyed its
+ * slot is retired: the bytes still allocated are reported as unattributed, and the
+ * slot is reused once they are all freed. When all DATAFLOW_HEAP_ACCOUNTS slots
+ * are taken, new accounts share the unattributed slot.
+ */
+class HeapAccount {
+public:
+
+	/**
+	 * Constructs a HeapAccount with no allocations.
+	 */
+	HeapAccount() noexcept;
+
+	/**
+	 * Destroys the HeapAccount, retiring its slot (see above).
+	 */
+	~HeapAccount();
+
+	HeapAccount(const HeapAccount&) = delete;
+	HeapAccount& operator=(const HeapAccount&) = delete;
+
+	/**
+	 * Queries the statistics of the allocations charged to this account.
+	 * @return The statistics of the account.
+	 */
+	HeapStats stats() const noexcept;
+
+	/**
+	 * Restarts the peak usage from the current usage and clears the counters
+	 * of allocations, eg. after the initialization of the application.
+	 */
+	void reset() noexcept;
+
+	/**
+	 * Selects the account charged with the allocations of the calling task.
+	 * @param  account [in] The account to select, nullptr for the unattributed account.
+	 * @return The previously selected account of the task, to restore it later.
+	 */
+	static HeapAccount* select(HeapAccount* account) noexcept;
+
+	/**
+	 * Queries the account charged with the allocations of the calling task.
+	 * @return Reference to the selected account of the task.
+	 */
+	static HeapAccount& current() noexcept;
+
+	/**
+	 * Queries the account charged with the allocations made outside of the
+	 * components (eg. while building the graph or sending initial messages).
+	 * @return Reference to the unattributed account.
+	 */
+	static HeapAccount& unattributed() noexcept;
+
+private:
+
+	// The Allocator charges and credits the accounts
+	friend class Allocator;
+
+	// The states of the slots of the table
+	static const uint8_t SLOT_FREE    = 0; /**< The slot is not used.                              */
+	static const uint8_t SLOT_USED    = 1; /**< The slot belongs to an account.                    */
+	static const uint8_t SLOT_RETIRED = 2; /**< The account is destroyed, allocations still exist. */
+
+	/**
+	 * The Slot structure stores the counters of an account in the static table.
+	 */
+	struct Slot {
+		std::atomic<uint8_t>     m_state;         /**< The state of the slot.                         */
+		std::atomic<std::size_t> m_liveBytes;     /**< The number of bytes currently allocated.       */
+		std::atomic<std::size_t> m_peakBytes;     /**< The highest number of bytes allocated at once. */
+		std::atomic<std::size_t> m_allocations;   /**< The number of allocations made.                */
+		std::atomic<std::size_t> m_deallocations; /**< The number of allocations freed.               */
+	};
+
+	/**
+	 * Constructs the HeapAccount of a given slot (used for the unattributed account).
+	 * @param slot [in] The index of the slot.
+	 */
+	explicit HeapAccount(uint16_t slot) noexcept;
+
+	/**
+	 * Takes a free slot, or a retired slot without allocations left.
+	 * @return The index of the slot, zero (unattributed) when all slots are taken.
+	 */
+	static uint16_t acquire() noexcept;
+
+	/**
+	 * Charges a slot with an allocation.
+	 * @param index [in] The index of the slot.
+	 * @param size  [in] The size of the allocation in bytes.
+	 */
+	static void charge(uint16_t index, std::size_t size) noexcept;
+
+	/**
+	 * Credits a slot with a deallocation.
+	 * @param index [in] The index of the slot.
+	 * @param size  [in] The size of the allocation in bytes.
+	 */
+	static void credit(uint16_t index, std::size_t size) noexcept;
+
+	static Slot s_slots[DATAFLOW_HEAP_ACCOUNTS]; /**< The counters of the accounts. */
+
+	uint16_t m_slot; /**< The index of the slot of the account. */
+};
+
+/**
+ * The Allocator class implements the allocation of Nodes and of the payloads of
+ * any objects stored on the heap. The memory is obtained through pluggable hooks
+ * (malloc and free by default), so the messages can be placed eg. into a memory
+ * pool or external RAM, and the allocations are charged to the HeapAccount of
+ * the calling task when DATAFLOW_HEAP_TELEMETRY is enabled.
+ */
+class Allocator {
+public:
+
+	/**
+	 * Function signature of the hook allocating memory.
+	 * @param  size [in] The number of bytes to allocate.
+	 * @return Pointer to the memory aligned for any type, or nullptr when out of memory.
+	 */
+	typedef void* (*AllocateFunction)(std::size_t size);
+
+	/**
+	 * Function signature of the hook freeing memory.
+	 * @param pointer [in] Pointer to the memory returned by the allocating hook.
+	 */
+	typedef void (*DeallocateFunction)(void* pointer);
+
+	/**
+	 * Sets the hooks used to obtain and release memory. As the memory allocated
+	 * by the previous hooks is released by the new ones, this has to be called
+	 * before anything is allocated (eg. at the beginning of app_main).
+	 * @param allocate   [in] The hook allocating memory.
+	 * @param deallocate [in] The hook freeing memory.
+	 */
+	static void setHooks(AllocateFunction allocate, DeallocateFunction deallocate) noexcept;
+
+	/**
+	 * Allocates memory charged to the current HeapAccount of the task.
+	 * @param  size [in] The number of bytes to allocate.
+	 * @return Pointer to the memory aligned for any type, throws std::bad_alloc
+	 *         when out of memory (or returns nullptr when exceptions are disabled).
+	 */
+	static void* allocate(std::size_t size);
+
+	/**
+	 * Frees memory returned by allocate(), crediting the account charged with it.
+	 * @param pointer [in] Pointer to the memory to free, nullptr is ignored.
+	 */
+	static void deallocate(void* pointer) noexcept;
+
+	/**
+	 * Queries the number of free bytes of the heap.
+	 * @return The free bytes of the heap, zero when not running on the device.
+	 */
+	static std::size_t freeBytes() noexcept;
+
+	/**
+	 * Queries the lowest number of free bytes of the heap since the boot.
+	 * @return The minimum free bytes of the heap, zero when not running on the device.
+	 */
+	static std::size_t minimumFreeBytes() noexcept;
+
+	/**
+	 * Queries the size of the largest free block of the heap, which is the largest
+	 * possible allocation. Compared to the free bytes it shows the fragmentation.
+	 * @return The largest free block in bytes, zero when not running on the device.
+	 */
+	static std::size_t largestFreeBlock() noexcept;
+};
+
+#endif // DATAFLOW_HEAP_H_INCLUDED
@@ -1,5 +1,33 @@
 #include "node.hpp"
 
+// Standard includes
+#include <atomic>
+#include <vector>
+
+/**
+ * @brief The Node::Children structure stores the list of child Nodes, shared
+ *        between the copies of a Node. Shared lists are never modified.
+ */
+struct Node::Children {
+    std::atomic<std::size_t> m_references; /**< The number of Nodes sharing the list. */
+    Node*                    m_first;      /**< Pointer to the first child Node.      */
+    Node*                    m_last;       /**< Pointer to the last child Node.       */
+
+    // Allocating the lists through the Allocator like the Nodes
+    static void* operator new(std::size_t size) { return Allocator::allocate(size); }
+    static void operator delete(void* pointer) noexcept { Allocator::deallocate(pointer); }
+};
+
+void* Node::operator new(std::size_t size)
+{
+    return Allocator::allocate(size);
+}
+
+void Node::operator delete(void* pointer) noexcept
+{
+    Allocator::deallocate(pointer);
+}
+
 Node::Node(Node* parent) noexcept
     : m_name(""), m_parent(parent), m_children(nullptr), m_next(nullptr)
 {
@@ -14,96 +42,55 @@ Node::Node(const std::string& name, Node* parent)
 
 Node::Node(const Node& other, Node* parent)
     : any(static_cast<const any&>(other)),
-      m_name(other.m_name), m_parent(parent), m_children(nullptr), m_next(nullptr)
+      m_name(other.m_name), m_parent(parent), m_children(other.m_children), m_next(nullptr)
 {
-#if defined(EXCEPTIONS_ENABLED)
-
-    try {
-
-        // Recursively copying child nodes
-        if(other.m_children) {
-            m_children = new Node(*other.m_children, this);
-        }
-
-        // Recursively copying sibling nodes
-        if(other.m_next) {
-            m_next = new Node(*other.m_next, parent);
-        }
-    }
-    catch(std::bad_alloc&)
-    {
-        // Deleting all allocated resources
-        delete m_children;
-        delete m_next;
-
-        // Delegating the exception up to the caller
-        throw;
-    }
-
-#else
-
-    // Recursively copying child nodes
-    if(other.m_children) {
-        m_children = new Node(*other.m_children, this);
-    }
-
-    // Recursively copying sibling nodes
-    if(other.m_next) {
-        m_next = new Node(*other.m_next, parent);
-    }
-
-#endif
+    // Sharing the children of the other Node
+    if(m_children != nullptr) m_children->m_references++;
 }
 
 Node& Node::operator=(const Node& other)
 {
-    // Clearing the currently stored value and deleting childs
-    this->clear();
+    // Assigning to itself does not change anything
+    if(this == &other) return *this;
 
-    // Copying the name of the other Node
-    m_name = other.m_name;
+    // Making a copy from the other Node's name and value, and sharing its children
+    // before releasing the current ones (the other Node may be one of them)
+    std::string name = other.m_name;
+    any value = static_cast<const any&>(other);
+    Children* children = other.m_children;
+    if(children != nullptr) children->m_references++;
 
-    // Making a copy from the other Node's value
-    any::operator=(static_cast<const any&>(other));
-
-    // Making a copy from the other Node's children
-    if(other.m_children) m_children = new Node(*other.m_children, this);
+    // Releasing the current children and taking over the copies
+    release(m_children);
+    m_children = children;
+    m_name = std::move(name);
+    any::operator=(std::move(value));
 
     return *this;
 }
 
 Node::~Node()
 {
-    // Recursively deleting dependent Nodes
-    delete m_children;
-    delete m_next;
+    // Releasing the children, deleting them if they are not shared
+    release(m_children);
 }
 
 Node& Node::add(const std::string& name)
 {
-    // Pointer to hold onto the new node
-    Node* newNode = nullptr;
-
-    // Creating new child node
-    newNode = new Node(name, this);
-
-    // Iterating to the end of the child elements list
-    Node* lastNode = m_children;
-    while(m_children != nullptr && lastNode->m_next != nullptr) {
-        lastNode = lastNode->m_next;
-    }
+    // Taking ownership of the children before modifying them
+    own();
 
     // Adding new node to the end of the child element list
-    if(lastNode != nullptr) lastNode->m_next = newNode;
-    else                    m_children = newNode;
-
-    return *newNode;
+    return append(new Node(name, this));
 }
 
 Node& Node::operator[](const std::string& name)
 {
+    // Taking ownership of the children, as the caller may modify them
+    detach();
+
     // Pointer to the current child node being examined
-    Node* node = m_children;
+    Node* node = m_children ? m_children->m_first : nullptr;
 
     // Iterating through the children of this node
     while(node != nullptr) {
@@ -121,7 +108,7 @@ Node& Node::operator[](const std::string& name)
 const Node& Node::operator[](const std::string& name) const
 {
     // Pointer to the current child node being examined
-    Node* node = m_children;
+    const Node* node = first_child();
 
     // Iterating through the children of this node
     while(node != nullptr) {
@@ -147,17 +134,20 @@ const Node& Node::operator[](const std::string& name) const
 
 Node& Node::operator[](std::size_t index)
 {
+    // Taking ownership of the children, as the caller may modify them
+    own();
+
     // Checking if the first child Node exists, creating it if it doesn't
-    if(m_children == nullptr) m_children = new Node(this);
+    if(m_children->m_first == nullptr) append(new Node(this));
 
     // Pointer to the current child Node
-    Node* node = m_children;
+    Node* node = m_children->m_first;
 
     // Iterating the list of child Nodes
     for(std::size_t i = 0; i < index; i++)
     {
         // Checking if a next Node exists, creating it if it doesn't
-        if(node->m_next == nullptr) node->m_next = new Node(this);
+        if(node->m_next == nullptr) append(new Node(this));
 
         // Moving on, to the next Node
         node = node->m_next;
@@ -169,7 +159,7 @@ Node& Node::operator[](std::size_t index)
 
 const Node& Node::operator[](std::size_t index) const
 {
-    const Node* node = m_children;
+    const Node* node = first_child();
     for(std::size_t i = 0; i < index; i++)
     {
         node = node->m_next;
@@ -187,16 +177,140 @@ void Node::clear() noexcept
     // Clearing the value from this Node
     reset();
 
-    // Recursively deleting child Nodes
-    delete m_children;
+    // Releasing the child Nodes, deleting them if they are not shared
+    release(m_children);
     m_children = nullptr;
 }
 
+bool Node::remove(const std::string& name)
+{
+    // Taking ownership of the children before modifying them
+    detach();
+
+    // Searching for the child along the list, tracking the previous one for unlinking
+    Node* previous = nullptr;
+    Node* node = (m_children != nullptr) ? m_children->m_first : nullptr;
+
+    while(node != nullptr && node->m_name != name) {
+        previous = node;
+        node = node->m_next;
+    }
+
+    if(node == nullptr) return false;
+
+    // Unlinking the child from the list
+    if(previous != nullptr) previous->m_next = node->m_next;
+    else                    m_children->m_first = node->m_next;
+    if(m_children->m_last == node) m_children->m_last = previous;
+
+    // Deleting the child without its former siblings
+    node->m_next = nullptr;
+    delete node;
+
+    return true;
+}
+
+bool Node::operator==(const Node& other) const noexcept
+{
+    // Comparing the names and the values of the Nodes
+    if(this == &other) return true;
+    if(m_name != other.m_name || !equals(other)) return false;
+
+    // Children shared between copies are equal
+    if(m_children == other.m_children) return true;
+
+    // Comparing the children pairwise along the sibling links. Instead of
+    // recursing into the grandchildren, the next siblings of the Nodes entered
+    // are kept on the heap, so the stack usage is constant for any depth
+    std::vector<std::pair<const Node*, const Node*>> pending;
+    const Node* left = first_child();
+    const Node* right = other.first_child();
+
+    while(true) {
+
+        // Finishing a list of children, both have to end at the same time
+        if(left == nullptr || right == nullptr) {
+            if(left != right) return false;
+            if(pending.empty()) return true;
+
+            // Continuing with the siblings of the parents
+            left = pending.back().first;
+            right = pending.back().second;
+            pending.pop_back();
+            continue;
+        }
+
+        if(left->m_name != right->m_name || !left->equals(*right)) return false;
+
+        // Entering the children unless they are shared, the siblings come afterwards
+        if(left->m_children != right->m_children) {
+            pending.emplace_back(left->m_next, right->m_next);
+            left = left->first_child();
+            right = right->first_child();
+        }
+        else {
+            left = left->m_next;
+            right = right->m_next;
+        }
+    }
+}
+
+bool Node::operator!=(const Node& other) const noexcept
+{
+    return !(*this == other);
+}
+
+uint32_t Node::hash() const noexcept
+{
+    // Markers hashed when entering and leaving the children of a Node, so the
+    // levels of the Nodes are also distinguished
+    static const uint8_t ENTER = 1;
+    static const uint8_t LEAVE = 2;
+
+    // Hashing the name and the value of the Node
+    uint32_t hash = any::hash();
+    hash = hashBytes(m_name.data(), m_name.size(), hash);
+
+    const Node* node = first_child();
+    if(node == nullptr) return hash;
+
+    // Hashing the children in depth-first order along the sibling links. Instead
+    // of recursing into the grandchildren, the next siblings of the Nodes entered
+    // are kept on the heap, so the stack usage is constant for any depth
+    std::vector<const Node*> pending;
+    hash = hashBytes(&ENTER, sizeof(ENTER), hash);
+
+    while(true) {
+
+        // Finishing a list of children, continuing with the siblings of the parent
+        if(node == nullptr) {
+            hash = hashBytes(&LEAVE, sizeof(LEAVE), hash);
+            if(pending.empty()) return hash;
+
+            node = pending.back();
+            pending.pop_back();
+            continue;
+        }
+
+        uint32_t value = node->any::hash();
+        hash = hashBytes(&value, sizeof(value), hash);
+        hash = hashBytes(node->m_name.data(), node->m_name.size(), hash);
+
+        // Entering the children, the siblings come afterwards
+        if(node->first_child() != nullptr) {
+            hash = hashBytes(&ENTER, sizeof(ENTER), hash);
+            pending.push_back(node->m_next);
+            node = node->first_child();
+        }
+        else node = node->m_next;
+    }
+}
+
 std::size_t Node::child_count() const noexcept
 {
     // Initializing child counter and iteration pointer
     std::size_t count = 0;
-    Node* node = m_children;
+    const Node* node = first_child();
 
     // Iterating the list of child Nodes
     while(node != nullptr) {
@@ -211,7 +325,7 @@ std::size_t Node::child_count() const noexcept
 bool Node::has_child(const std::string& name) const noexcept
 {
     // Pointer to the current child node being examined
-    Node* node = m_children;
+    const Node* node = first_child();
 
     // Iterating through the children of this node
     while(node != nullptr) {
@@ -226,6 +340,16 @@ bool Node::has_child(const std::string& name) const noexcept
     return false;
 }
 
+const Node* Node::first_child() const noexcept
+{
+    return (m_children != nullptr) ? m_children->m_first : nullptr;
+}
+
+const Node* Node::next_sibling() const noexcept
+{
+    return m_next;
+}
+
 std::string& Node::name() noexcept
 {
     // Returning the reference for the name of this Node (read-write access)
@@ -240,6 +364,29 @@ const std::string& Node::name() const noexcept
 
 Node::iterator Node::begin()
 {
+    // Taking ownership of the children in the whole subtree, as the iterator
+    // may modify them and it climbs back on the parent links of the children.
+    // The subtree is traversed along the parent and sibling links, like the
+    // iterator does, so the stack usage is constant for any depth of the tree
+    Node* node = this;
+    while(node != nullptr) {
+        node->detach();
+
+        Node* first = (node->m_children != nullptr) ? node->m_children->m_first : nullptr;
+        for(Node* child = first; child != nullptr; child = child->m_next) {
+            child->m_parent = node;
+        }
+
+        // Moving on to the first child, or to the next unvisited sibling
+        if(first != nullptr) {
+            node = first;
+            continue;
+        }
+
+        while(node != this && node->m_next == nullptr) node = node->m_parent;
+        node = (node != this) ? node->m_next : nullptr;
+    }
+
     // Returning iterator referencing this Node
     return iterator(this);
 }
@@ -250,6 +397,100 @@ Node::iterator Node::end()
     return iterator(nullptr);
 }
 
+void Node::detach()
+{
+    // Lists referenced only by this Node can be modified in place
+    if(m_children == nullptr || m_children->m_references == 1) return;
+
+    // Copying the children into a new list, sharing their own children
+    Children* children = new Children{ {1}, nullptr, nullptr };
+
+#if defined(EXCEPTIONS_ENABLED)
+
+    try {
+        for(const Node* node = m_children->m_first; node != nullptr; node = node->m_next) {
+            Node* copy = new Node(*node, this);
+
+            if(children->m_last != nullptr) children->m_last->m_next = copy;
+            else                            children->m_first = copy;
+            children->m_last = copy;
+        }
+    }
+    catch(std::bad_alloc&)
+    {
+        // Deleting the partial copy, keeping the shared list
+        release(children);
+
+        // Delegating the exception up to the caller
+        throw;
+    }
+
+#else
+
+    for(const Node* node = m_children->m_first; node != nullptr; node = node->m_next) {
+        Node* copy = new Node(*node, this);
+
+        if(children->m_last != nullptr) children->m_last->m_next = copy;
+        else                            children->m_first = copy;
+        children->m_last = copy;
+    }
+
+#endif
+
+    // Releasing the shared list and taking over the copy
+    release(m_children);
+    m_children = children;
+}
+
+void Node::own()
+{
+    // Splitting the shared list, or allocating a new one
+    if(m_children != nullptr) detach();
+    else                      m_children = new Children{ {1}, nullptr, nullptr };
+}
+
+Node& Node::append(Node* node) noexcept
+{
+    // Adding new node to the end of the child element list
+    if(m_children->m_last != nullptr) m_children->m_last->m_next = node;
+    else                              m_children->m_first = node;
+    m_children->m_last = node;
+
+    return *node;
+}
+
+void Node::release(Children* children) noexcept
+{
+    // Only the last reference deletes the list
+    if(children == nullptr || --children->m_references != 0) return;
+
+    // Deleting the child Nodes along the list, instead of recursing into the
+    // lists of the grandchildren they are spliced into the front of the list,
+    // so the stack usage is constant for any size and depth of the tree
+    Node* pending = children->m_first;
+    delete children;
+
+    while(pending != nullptr) {
+        Node* node = pending;
+        pending = node->m_next;
+
+        // Splicing the children of the Node when it holds the last reference
+        Children* list = node->m_children;
+        node->m_children = nullptr;
+
+        if(list != nullptr && --list->m_references == 0) {
+            if(list->m_first != nullptr) {
+                list->m_last->m_next = pending;
+                pending = list->m_first;
+            }
+            delete list;
+        }
+
+        // The Node has no children left, deleting it does not recurse
+        delete node;
+    }
+}
+
 // Node::iterator
 
 Node::iterator::iterator(Node* node) noexcept
@@ -300,8 +541,8 @@ Node::iterator& Node::iterator::operator++() noexcept
     if(m_node == nullptr) return *this;
 
     // Moving on to the first child of the current node if possible
-    if(m_node->m_children != nullptr) {
-        m_node = m_node->m_children;
+    if(m_node->m_children != nullptr && m_node->m_children->m_first != nullptr) {
+        m_node = m_node->m_children->m_first;
         m_level++;
         return *this;
     }
@@ -432,8 +673,8 @@ Node::const_iterator& Node::const_iterator::operator++() noexcept
     if(m_node == nullptr) return *this;
 
     // Moving on to the first child of the current node if possible
-    if(m_node->m_children != nullptr) {
-        m_node = m_node->m_children;
+    if(m_node->m_children != nullptr && m_node->m_children->m_first != nullptr) {
+        m_node = m_node->m_children->m_first;
         m_level++;
         return *this;
     }
@@ -13,6 +13,13 @@
 
 /**
  * @brief The Node class implements a tree-hierarchy of any objects.
+ *
+ * The children of a Node are stored in a reference counted list, which is
+ * shared between copies of the Node, so copying a tree takes constant time.
+ * The first modification through a non-const accessor (operator[], add, clear,
+ * begin) splits the shared list of the modified Node only: the children are
+ * copied one level deep, still sharing the lists of the grandchildren. Shared
+ * lists are never modified, so copies can be read from multiple tasks.
  */
 class Node : public any {
 public:
@@ -21,6 +28,20 @@ public:
     class iterator;
     class const_iterator;
 
+    /**
+     * @brief  Allocates the memory of a Node through the Allocator, so the Nodes
+     *         are charged to the HeapAccount of the Component creating them.
+     * @param  size [in] The size of the Node in bytes.
+     * @return Pointer to the allocated memory.
+     */
+    static void* operator new(std::size_t size);
+
+    /**
+     * @brief Releases the memory of a Node through the Allocator.
+     * @param pointer [in] Pointer to the memory of the Node.
+     */
+    static void operator delete(void* pointer) noexcept;
+
     /**
      * @brief Constructs a Node with no value and the specified parent Node.
      * @param parent [in] Pointer to the parent Node (NOT linked from the parent side)!
@@ -48,14 +69,14 @@ public:
     }
 
     /**
-     * @brief Constructs a Node by copying another Node.
+     * @brief Constructs a Node by copying another Node, sharing its children.
      * @param other  [in] The other Node to copy.
      * @param parent [in] Pointer to the Node adopting the created Node.
      */
     Node(const Node& other, Node* parent = nullptr);
 
     /**
-     * @brief  Copy assigns this Node to another Node.
+     * @brief  Copy assigns this Node to another Node, sharing its children.
      * @param  other [in] The other Node to copy.
      * @return Reference to this Node after the assignment.
      */
@@ -74,7 +95,8 @@ public:
     }
 
     /**
-     * @brief Recursively destroys this Node and the dependent Nodes.
+     * @brief Destroys this Node, releasing its children (dependent Nodes are
+     *        destroyed with the last Node sharing them).
      */
     ~Node();
 
@@ -86,23 +108,11 @@ public:
     template <class Type>
     Node& add(const std::string& name, Type&& value)
     {
-        // Pointer to hold onto the new node
-        Node* newNode = nullptr;
-
-        // Creating new child node
-        newNode = new Node(name, value, this);
-
-        // Iterating to the end of the child elements list
-        Node* lastNode = m_children;
-        while(m_children != nullptr && lastNode->m_next != nullptr) {
-            lastNode = lastNode->m_next;
-        }
+        // Taking ownership of the children before modifying them
+        own();
 
         // Adding new node to the end of the child element list
-        if(lastNode != nullptr) lastNode->m_next = newNode;
-        else                    m_children = newNode;
-
-        return *newNode;
+        return append(new Node(name, value, this));
     }
 
     /**
@@ -118,23 +128,11 @@ public:
     template <class Type>
     Node& add(Type&& value)
     {
-        // Pointer to hold onto the new node
-        Node* newNode = nullptr;
-
-        // Creating new child node
-        newNode = new Node("", value, this);
-
-        // Iterating to the end of the child elements list
-        Node* lastNode = m_children;
-        while(m_children != nullptr && lastNode->m_next != nullptr) {
-            lastNode = lastNode->m_next;
-        }
+        // Taking ownership of the children before modifying them
+        own();
 
         // Adding new node to the end of the child element list
-        if(lastNode != nullptr) lastNode->m_next = newNode;
-        else                    m_children = newNode;
-
-        return *newNode;
+        return append(new Node("", value, this));
     }
 
     /**
@@ -174,6 +172,36 @@ public:
      */
     void clear() noexcept;
 
+    /**
+     * @brief  Deletes the first child Node with the specified name.
+     * @param  name [in] The name of the child Node to delete.
+     * @return True when the child existed and has been deleted.
+     */
+    bool remove(const std::string& name);
+
+    /**
+     * @brief  Compares this Node tree to another one. The trees are equal when the
+     *         names, values and children of the Nodes are equal, in the same order.
+     *         Children shared between copies are equal without comparing them.
+     * @param  other [in] The other Node to compare to.
+     * @return True when the trees are equal.
+     */
+    bool operator==(const Node& other) const noexcept;
+
+    /**
+     * @brief  Compares this Node tree to another one (see operator==).
+     * @param  other [in] The other Node to compare to.
+     * @return True when the trees are not equal.
+     */
+    bool operator!=(const Node& other) const noexcept;
+
+    /**
+     * @brief  Calculates a structural hash of this Node tree, from the names, values
+     *         and order of the Nodes. Equal trees have equal hashes (see any::hash).
+     * @return The 32-bit hash of the tree.
+     */
+    uint32_t hash() const noexcept;
+
     /**
      * @brief  Queries the number of childs this Node has.
      * @return The number of child Nodes attached to this Node.
@@ -187,6 +215,19 @@ public:
 	 */
 	bool has_child(const std::string& name) const noexcept;
 
+    /**
+     * @brief  Queries the first child of this Node, for iterating the children
+     *         along with next_sibling() without creating or throwing.
+     * @return Pointer to the first child Node, or nullptr when there are none.
+     */
+    const Node* first_child() const noexcept;
+
+    /**
+     * @brief  Queries the next Node on the same hierarchy level.
+     * @return Pointer to the next sibling Node, or nullptr for the last one.
+     */
+    const Node* next_sibling() const noexcept;
+
     /**
      * @brief  Queries the name of this Node.
      * @return Reference to the name property (read-write access).
@@ -200,7 +241,8 @@ public:
     const std::string& name() const noexcept;
 
     /**
-     * @brief  Creates an iterator referencing this Node.
+     * @brief  Creates an iterator referencing this Node. This splits all of the
+     *         shared children in the subtree, as they may be modified.
      * @return The iterator referencing this Node.
      */
     iterator begin();
@@ -224,9 +266,42 @@ public:
     const_iterator cend();
 
 private:
+
+    // Friend declaration for building the children while deserializing
+    friend class NodeSerializer;
+
+    // Forward declaration of the shared list of children
+    struct Children;
+
+    /**
+     * @brief Splits the list of children if it is shared with other Nodes, by
+     *        copying the children (but not the grandchildren) into a new list.
+     */
+    void detach();
+
+    /**
+     * @brief Splits the list of children and allocates it if it is empty,
+     *        so new children can be appended to it.
+     */
+    void own();
+
+    /**
+     * @brief  Appends a child Node to the owned list of children (see own()).
+     * @param  node [in] The child Node to append, adopted by this Node.
+     * @return Reference to the appended child Node.
+     */
+    Node& append(Node* node) noexcept;
+
+    /**
+     * @brief Releases a reference to a list of children, deleting it with the
+     *        children when the last reference is released.
+     * @param children [in] The list to release (may be nullptr).
+     */
+    static void release(Children* children) noexcept;
+
     std::string m_name;     /**< The name of this Node for identification. */
     Node*       m_parent;   /**< Pointer to the parent Node of this Node.  */
-    Node*       m_children; /**< Pointer to the list of child Nodes.       */
+    Children*   m_children; /**< Pointer to the shared list of children.   */
     Node*       m_next;     /**< Pointer to the next sibling Node.         */
 };
 
@@ -0,0 +1,119 @@
+#include "node_diff.h"
+
+bool NodeDiff::diff(const Node& previous, const Node& current, Node& delta)
+{
+	// Clearing the previous content, keeping the name of the delta
+	delta.clear();
+
+	compare(previous, current, "", delta);
+
+	return delta.first_child() != nullptr;
+}
+
+void NodeDiff::apply(Node& target, const Node& delta)
+{
+	static const std::string lists[] = { "removed", "changed", "added" };
+
+	// Applying the removals first, then the replaced and added subtrees
+	for(const std::string& list : lists) {
+		const Node* entries = find(delta, list);
+		if(entries == nullptr) continue;
+
+		bool removal = (list == "removed");
+
+		for(const Node* entry = entries->first_child(); entry != nullptr; entry = entry->next_sibling()) {
+			const std::string& path = entry->name();
+
+			// Walking the leading segments of the path, creating the missing Nodes
+			// except for removals, empty segments (eg. of the root "/") are skipped
+			Node* node = &target;
+			std::size_t start = 0;
+			std::size_t end = path.find('/');
+
+			while(node != nullptr && end != std::string::npos) {
+				const std::string name = path.substr(start, end - start);
+
+				if(!name.empty()) {
+					if(removal && find(*node, name) == nullptr) node = nullptr;
+					else                                        node = &(*node)[name];
+				}
+
+				start = end + 1;
+				end = path.find('/', start);
+			}
+
+			if(node == nullptr) continue;
+			const std::string name = path.substr(start);
+
+			// Removing the subtree, or the whole content at the root
+			if(removal) {
+				if(name.empty()) node->clear();
+				else             node->remove(name);
+				continue;
+			}
+
+			// Replacing the content of the Node, keeping its name
+			if(!name.empty()) node = &(*node)[name];
+
+			std::string original = node->name();
+			*node = *entry;
+			node->name() = original;
+		}
+	}
+}
+
+void NodeDiff::compare(const Node& previous, const Node& current, const std::string& path, Node& delta)
+{
+	// Equal subtrees have no differences (shared children are not even visited)
+	if(previous == current) return;
+
+	// Replacing the subtree when its value or its anonymous children changed
+	if(!previous.equals(current) || !named(previous) || !named(current)) {
+		record(delta["changed"], path, current);
+		return;
+	}
+
+	// Comparing the children by name, listing the added ones
+	for(const Node* child = current.first_child(); child != nullptr; child = child->next_sibling()) {
+		const std::string childPath = path.empty() ? child->name() : path + '/' + child->name();
+		const Node* counterpart = find(previous, child->name());
+
+		if(counterpart != nullptr) compare(*counterpart, *child, childPath, delta);
+		else                       record(delta["added"], childPath, *child);
+	}
+
+	// Listing the removed children
+	for(const Node* child = previous.first_child(); child != nullptr; child = child->next_sibling()) {
+		if(find(current, child->name()) == nullptr) {
+			record(delta["removed"], path.empty() ? child->name() : path + '/' + child->name(), Node());
+		}
+	}
+}
+
+void NodeDiff::record(Node& list, const std::string& path, const Node& node)
+{
+	// Naming the entry after the path, the root is named "/"
+	const std::string name = path.empty() ? "/" : path;
+
+	Node& entry = list.add(name);
+	entry = node;
+	entry.name() = name;
+}
+
+const Node* NodeDiff::find(const Node& node, const std::string& name) noexcept
+{
+	for(const Node* child = node.first_child(); child != nullptr; child = child->next_sibling()) {
+		if(child->name() == name) return child;
+	}
+
+	return nullptr;
+}
+
+bool NodeDiff::named(const Node& node) noexcept
+{
+	for(const Node* child = node.first_child(); child != nullptr; child = child->next_sibling()) {
+		if(child->name().empty()) return false;
+	}
+
+	return true;
+}
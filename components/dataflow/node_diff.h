@@ -0,0 +1,84 @@
+#pragma once
+#ifndef DATAFLOW_NODE_DIFF_H_INCLUDED
+#define DATAFLOW_NODE_DIFF_H_INCLUDED
+
+// Standard includes
+#include <string>
+
+// Project includes
+#include "node.hpp"
+
+
+/**
+ * The NodeDiff class calculates the difference of two Node trees as a delta
+ * Node, and applies deltas to trees, so only the changes of messages need to be
+ * sent (eg. by output ports in DELTA mode, see Port::Emit).
+ *
+ * The delta has up to three children, each listing paths (eg. "now/id") as the
+ * names of its children:
+ *
+ * "changed" - Subtrees replaced in the current tree, with their new content.
+ * "added"   - Subtrees added to the current tree, with their content.
+ * "removed" - Subtrees removed from the current tree, as empty Nodes.
+ *
+ * Children are matched by name, so Nodes with anonymous children (arrays) are
+ * compared and replaced as a whole. The path of the root Node itself is "/".
+ * Subtrees in the delta share their children with the current tree.
+ */
+class NodeDiff {
+public:
+
+	/**
+	 * Calculates the delta transforming the previous tree into the current one.
+	 * @param  previous [in]  The previous Node tree.
+	 * @param  current  [in]  The current Node tree.
+	 * @param  delta    [out] The Node to store the delta into, its content is replaced.
+	 * @return True when the trees are different (the delta is not empty).
+	 */
+	static bool diff(const Node& previous, const Node& current, Node& delta);
+
+	/**
+	 * Applies a delta calculated by diff() to a tree, transforming the previous
+	 * tree into the current one. The names of the existing Nodes are kept.
+	 * @param target [in] The Node tree to update.
+	 * @param delta  [in] The delta to apply.
+	 */
+	static void apply(Node& target, const Node& delta);
+
+private:
+
+	/**
+	 * Compares two Nodes at the same path, adding their differences to the delta.
+	 * @param previous [in]  The previous Node.
+	 * @param current  [in]  The current Node.
+	 * @param path     [in]  The path of the Nodes, empty for the root.
+	 * @param delta    [out] The delta to add the differences to.
+	 */
+	static void compare(const Node& previous, const Node& current, const std::string& path, Node& delta);
+
+	/**
+	 * Adds an entry to a list of the delta, sharing the children of the Node.
+	 * @param list [in] The list of the delta to add to ("changed", "added" or "removed").
+	 * @param path [in] The path of the entry, empty for the root.
+	 * @param node [in] The content of the entry.
+	 */
+	static void record(Node& list, const std::string& path, const Node& node);
+
+	/**
+	 * Queries the child with the specified name, without creating or throwing.
+	 * @param  node [in] The Node to search the children of.
+	 * @param  name [in] The name of the child.
+	 * @return Pointer to the first child with the name, or nullptr.
+	 */
+	static const Node* find(const Node& node, const std::string& name) noexcept;
+
+	/**
+	 * Checks whether the children of the Node are all named, so they can be
+	 * compared by name.
+	 * @param  node [in] The Node to check.
+	 * @return True when the Node has no anonymous children.
+	 */
+	static bool named(const Node& node) noexcept;
+};
+
+#endif // DATAFLOW_NODE_DIFF_H_INCLUDED
@@ -0,0 +1,360 @@
+#include "node_json.h"
+
+// Standard includes
+#include <cmath>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+/**
+ * The Parser structure stores the position of the parser in the JSON text.
+ */
+struct NodeJson::Parser {
+	const char* m_text;     /**< The JSON text being parsed. */
+	std::size_t m_length;   /**< The length of the text.     */
+	std::size_t m_position; /**< The current read position.  */
+
+	/**
+	 * Skips the whitespace characters at the current position.
+	 */
+	void skip() noexcept
+	{
+		while(m_position < m_length && strchr(" \t\r\n", m_text[m_position]) != nullptr && m_text[m_position] != '\0') m_position++;
+	}
+
+	/**
+	 * Queries the character at the current position.
+	 * @return The current character, or zero at the end of the text.
+	 */
+	char peek() const noexcept
+	{
+		return (m_position < m_length) ? m_text[m_position] : '\0';
+	}
+
+	/**
+	 * Consumes the specified literal at the current position.
+	 * @param  literal [in] The literal to consume (eg. "true").
+	 * @return True when the literal matches.
+	 */
+	bool consume(const char* literal) noexcept
+	{
+		std::size_t length = strlen(literal);
+		if(m_length - m_position < length || strncmp(m_text + m_position, literal, length) != 0) return false;
+
+		m_position += length;
+		return true;
+	}
+};
+
+/**
+ * Checks whether the text is a number in the format of RFC 8259: an optional minus
+ * sign, an integer part without leading zeros, an optional fraction with at least
+ * one digit and an optional exponent with at least one digit.
+ * @param  text   [in] The text to check.
+ * @param  length [in] The length of the text.
+ * @return True when the whole text is a valid JSON number.
+ */
+static bool isNumber(const char* text, std::size_t length) noexcept
+{
+	std::size_t position = 0;
+	auto digits = [&]() {
+		std::size_t start = position;
+		while(position < length && isdigit((unsigned char) text[position])) position++;
+		return position - start;
+	};
+
+	// Sign and integer part, which only starts with zero when it is zero
+	if(position < length && text[position] == '-') position++;
+	if(position < length && text[position] == '0') position++;
+	else if(digits() == 0) return false;
+
+	// Fraction
+	if(position < length && text[position] == '.') {
+		position++;
+		if(digits() == 0) return false;
+	}
+
+	// Exponent
+	if(position < length && (text[position] == 'e' || text[position] == 'E')) {
+		position++;
+		if(position < length && (text[position] == '+' || text[position] == '-')) position++;
+		if(digits() == 0) return false;
+	}
+
+	return position == length;
+}
+
+bool NodeJson::parse(const char* text, std::size_t length, Node& node)
+{
+	Parser parser{ text, length, 0 };
+
+	// Clearing the previous content, keeping the name of the Node
+	node.clear();
+
+	// Parsing the value, only whitespace may follow it
+	bool status = (text != nullptr) && parseValue(parser, node, 0);
+	parser.skip();
+	status = status && parser.m_position == parser.m_length;
+
+	if(!status) node.clear();
+	return status;
+}
+
+bool NodeJson::parse(const std::string& text, Node& node)
+{
+	return parse(text.data(), text.size(), node);
+}
+
+void NodeJson::stringify(const Node& node, std::string& output)
+{
+	// Writing the children as an object when any of them is named, or as an array
+	if(node.first_child() != nullptr) {
+		bool named = false;
+		for(const Node* child = node.first_child(); child != nullptr && !named; child = child->next_sibling()) {
+			named = !child->name().empty();
+		}
+
+		output += named ? '{' : '[';
+		for(const Node* child = node.first_child(); child != nullptr; child = child->next_sibling()) {
+			if(child != node.first_child()) output += ',';
+
+			if(named) {
+				writeString(child->name().data(), child->name().size(), output);
+				output += ':';
+			}
+
+			stringify(*child, output);
+		}
+		output += named ? '}' : ']';
+
+		return;
+	}
+
+	// Writing the value of the Node, non-finite numbers are not representable in JSON
+	char number[32] = "null";
+
+	if(node.get<EmptyContainer>() != nullptr)          snprintf(number, sizeof(number), "%s", (*node.get<EmptyContainer>() == EmptyContainer::OBJECT) ? "{}" : "[]");
+	else if(node.get<bool>() != nullptr)               snprintf(number, sizeof(number), "%s", *node.get<bool>() ? "true" : "false");
+	else if(node.string_data() != nullptr)             { std::size_t size = 0; const char* data = node.string_data(&size); writeString(data, size, output); return; }
+	else if(node.get<double>() != nullptr)             { if(std::isfinite(*node.get<double>())) snprintf(number, sizeof(number), "%.15g", *node.get<double>()); }
+	else if(node.get<float>() != nullptr)              { if(std::isfinite(*node.get<float>())) snprintf(number, sizeof(number), "%.7g", (double) *node.get<float>()); }
+	else if(node.get<int>() != nullptr)                snprintf(number, sizeof(number), "%d", *node.get<int>());
+	else if(node.get<unsigned>() != nullptr)           snprintf(number, sizeof(number), "%u", *node.get<unsigned>());
+	else if(node.get<long>() != nullptr)               snprintf(number, sizeof(number), "%ld", *node.get<long>());
+	else if(node.get<unsigned long>() != nullptr)      snprintf(number, sizeof(number), "%lu", *node.get<unsigned long>());
+	else if(node.get<int8_t>() != nullptr)             snprintf(number, sizeof(number), "%d", (int) *node.get<int8_t>());
+	else if(node.get<uint8_t>() != nullptr)            snprintf(number, sizeof(number), "%u", (unsigned) *node.get<uint8_t>());
+	else if(node.get<int16_t>() != nullptr)            snprintf(number, sizeof(number), "%d", (int) *node.get<int16_t>());
+	else if(node.get<uint16_t>() != nullptr)           snprintf(number, sizeof(number), "%u", (unsigned) *node.get<uint16_t>());
+	else if(node.get<long long>() != nullptr)          snprintf(number, sizeof(number), "%lld", *node.get<long long>());
+	else if(node.get<unsigned long long>() != nullptr) snprintf(number, sizeof(number), "%llu", *node.get<unsigned long long>());
+
+	output += number;
+}
+
+std::string NodeJson::stringify(const Node& node)
+{
+	std::string output;
+	stringify(node, output);
+
+	return output;
+}
+
+bool NodeJson::parseValue(Parser& parser, Node& node, std::size_t depth)
+{
+	// Limiting the nesting depth of the parsed text
+	if(depth > MAX_DEPTH) return false;
+
+	parser.skip();
+	char next = parser.peek();
+
+	// Parsing objects into named children
+	if(next == '{') {
+		parser.m_position++;
+		parser.skip();
+		if(parser.peek() == '}') { parser.m_position++; node = EmptyContainer::OBJECT; return true; }
+
+		while(true) {
+			std::string name;
+			parser.skip();
+			if(parser.peek() != '"' || !parseString(parser, name)) return false;
+
+			parser.skip();
+			if(parser.peek() != ':') return false;
+			parser.m_position++;
+
+			if(!parseValue(parser, node.add(static_cast<const std::string&>(name)), depth + 1)) return false;
+
+			parser.skip();
+			if(parser.peek() == ',') { parser.m_position++; continue; }
+			if(parser.peek() == '}') { parser.m_position++; return true; }
+			return false;
+		}
+	}
+
+	// Parsing arrays into anonymous children
+	if(next == '[') {
+		parser.m_position++;
+		parser.skip();
+		if(parser.peek() == ']') { parser.m_position++; node = EmptyContainer::ARRAY; return true; }
+
+		while(true) {
+			const std::string name;
+			if(!parseValue(parser, node.add(name), depth + 1)) return false;
+
+			parser.skip();
+			if(parser.peek() == ',') { parser.m_position++; continue; }
+			if(parser.peek() == ']') { parser.m_position++; return true; }
+			return false;
+		}
+	}
+
+	// Parsing strings
+	if(next == '"') {
+		std::string value;
+		if(!parseString(parser, value)) return false;
+
+		node = SmallString(value);
+		return true;
+	}
+
+	// Parsing literals
+	if(parser.consume("true"))  { node = true;  return true; }
+	if(parser.consume("false")) { node = false; return true; }
+	if(parser.consume("null"))  { return true; }
+
+	// Parsing numbers, copying them for the null-terminated conversion
+	char number[32];
+	std::size_t length = 0;
+
+	while(length < sizeof(number) - 1 && strchr("+-0123456789.eE", parser.peek()) != nullptr && parser.peek() != '\0') {
+		number[length++] = parser.m_text[parser.m_position++];
+	}
+	number[length] = '\0';
+
+	if(!isNumber(number, length)) return false;
+
+	char* end = nullptr;
+	double value = strtod(number, &end);
+	if(end != number + length) return false;
+
+	node = value;
+	return true;
+}
+
+bool NodeJson::parseString(Parser& parser, std::string& output)
+{
+	// Skipping the opening quote
+	parser.m_position++;
+
+	while(parser.m_position < parser.m_length) {
+		char character = parser.m_text[parser.m_position++];
+
+		// Finishing at the closing quote
+		if(character == '"') return true;
+
+		// Copying unescaped characters, control characters must be escaped
+		if(character != '\\') {
+			if((unsigned char) character < 0x20) return false;
+			output += character;
+			continue;
+		}
+
+		// Decoding escape sequences
+		if(parser.m_position >= parser.m_length) return false;
+		character = parser.m_text[parser.m_position++];
+
+		switch(character) {
+		case '"':  output += '"';  break;
+		case '\\': output += '\\'; break;
+		case '/':  output += '/';  break;
+		case 'b':  output += '\b'; break;
+		case 'f':  output += '\f'; break;
+		case 'n':  output += '\n'; break;
+		case 'r':  output += '\r'; break;
+		case 't':  output += '\t'; break;
+		case 'u': {
+
+			// Decoding the code point, combining surrogate pairs
+			uint32_t codePoint = 0;
+			for(std::size_t digits = 0; digits < 4; digits++) {
+				char digit = parser.peek();
+				if(!isxdigit((unsigned char) digit)) return false;
+
+				codePoint = (codePoint << 4) | (isdigit((unsigned char) digit) ? digit - '0' : (tolower(digit) - 'a' + 10));
+				parser.m_position++;
+			}
+
+			if(codePoint >= 0xD800 && codePoint < 0xDC00 && parser.consume("\\u")) {
+				uint32_t low = 0;
+				for(std::size_t digits = 0; digits < 4; digits++) {
+					char digit = parser.peek();
+					if(!isxdigit((unsigned char) digit)) return false;
+
+					low = (low << 4) | (isdigit((unsigned char) digit) ? digit - '0' : (tolower(digit) - 'a' + 10));
+					parser.m_position++;
+				}
+
+				if(low < 0xDC00 || low > 0xDFFF) return false;
+				codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+			}
+
+			// Encoding the code point as UTF-8
+			if(codePoint < 0x80) {
+				output += (char) codePoint;
+			}
+			else if(codePoint < 0x800) {
+				output += (char) (0xC0 | (codePoint >> 6));
+				output += (char) (0x80 | (codePoint & 0x3F));
+			}
+			else if(codePoint < 0x10000) {
+				output += (char) (0xE0 | (codePoint >> 12));
+				output += (char) (0x80 | ((codePoint >> 6) & 0x3F));
+				output += (char) (0x80 | (codePoint & 0x3F));
+			}
+			else {
+				output += (char) (0xF0 | (codePoint >> 18));
+				output += (char) (0x80 | ((codePoint >> 12) & 0x3F));
+				output += (char) (0x80 | ((codePoint >> 6) & 0x3F));
+				output += (char) (0x80 | (codePoint & 0x3F));
+			}
+			break;
+		}
+		default: return false;
+		}
+	}
+
+	// Missing closing quote
+	return false;
+}
+
+void NodeJson::writeString(const char* value, std::size_t size, std::string& output)
+{
+	output += '"';
+
+	for(std::size_t i = 0; i < size; i++) {
+		char character = value[i];
+		switch(character) {
+		case '"':  output += "\\\""; break;
+		case '\\': output += "\\\\"; break;
+		case '\b': output += "\\b";  break;
+		case '\f': output += "\\f";  break;
+		case '\n': output += "\\n";  break;
+		case '\r': output += "\\r";  break;
+		case '\t': output += "\\t";  break;
+		default:
+
+			// Escaping the remaining control characters
+			if((unsigned char) character < 0x20) {
+				char escape[8];
+				snprintf(escape, sizeof(escape), "\\u%04x", (unsigned) character);
+				output += escape;
+			}
+			else output += character;
+		}
+	}
+
+	output += '"';
+}
@@ -0,0 +1,104 @@
+#pragma once
+#ifndef DATAFLOW_NODE_JSON_H_INCLUDED
+#define DATAFLOW_NODE_JSON_H_INCLUDED
+
+// Standard includes
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// Project includes
+#include "node.hpp"
+
+
+/**
+ * The NodeJson class converts between JSON text and Node trees directly, in a
+ * single pass over the text, without building an intermediate cJSON document.
+ *
+ * When parsing, JSON objects become named children and arrays become anonymous
+ * (indexed) children of the Node. Numbers are stored as double, strings as
+ * std::string and booleans as bool, null values leave the Node empty. Empty
+ * objects and arrays have no children to tell them apart, so they store an
+ * EmptyContainer value instead. Only numbers in the RFC 8259 format are accepted.
+ *
+ * When stringifying, Nodes with children become JSON objects when any of the
+ * children is named, or arrays otherwise (the value of such Nodes is ignored).
+ * Nodes without children become their value: numbers, strings and booleans are
+ * written as such, EmptyContainer values as {} or [], empty Nodes and values of
+ * other types are written as null.
+ */
+class NodeJson {
+public:
+
+	/**
+	 * The value of the Nodes parsed from empty JSON objects and arrays.
+	 */
+	enum class EmptyContainer : uint8_t { OBJECT, ARRAY };
+
+	/**
+	 * Parses JSON text into the specified Node. The name of the Node is kept, its
+	 * previous value and children are replaced by the parsed content.
+	 * @param  text   [in]  The JSON text to parse (not necessarily null-terminated).
+	 * @param  length [in]  The length of the text in bytes.
+	 * @param  node   [out] The Node to store the parsed content into.
+	 * @return True when the text is valid JSON, the Node is left empty otherwise.
+	 */
+	static bool parse(const char* text, std::size_t length, Node& node);
+
+	/**
+	 * Parses JSON text into the specified Node.
+	 * @param  text [in]  The JSON text to parse.
+	 * @param  node [out] The Node to store the parsed content into.
+	 * @return True when the text is valid JSON, the Node is left empty otherwise.
+	 */
+	static bool parse(const std::string& text, Node& node);
+
+	/**
+	 * Appends the JSON representation of the Node to the output string.
+	 * @param node   [in]  The Node to convert.
+	 * @param output [out] The string to append the JSON text to.
+	 */
+	static void stringify(const Node& node, std::string& output);
+
+	/**
+	 * Converts the Node into its JSON representation.
+	 * @param  node [in] The Node to convert.
+	 * @return The JSON text.
+	 */
+	static std::string stringify(const Node& node);
+
+private:
+
+	// Forward declaration of the parser state
+	struct Parser;
+
+	// Maximum nesting depth accepted by the parser
+	static const std::size_t MAX_DEPTH = 32;
+
+	/**
+	 * Parses a JSON value into the Node.
+	 * @param  parser [in]  The parser state.
+	 * @param  node   [out] The Node to store the value into.
+	 * @param  depth  [in]  The nesting depth of the value.
+	 * @return True when the value is parsed successfully.
+	 */
+	static bool parseValue(Parser& parser, Node& node, std::size_t depth);
+
+	/**
+	 * Parses a JSON string, the parser must be positioned on the opening quote.
+	 * @param  parser [in]  The parser state.
+	 * @param  output [out] The unescaped string.
+	 * @return True when the string is parsed successfully.
+	 */
+	static bool parseString(Parser& parser, std::string& output);
+
+	/**
+	 * Appends a string to the output, quoted and escaped.
+	 * @param value  [in]  Pointer to the characters to append.
+	 * @param size   [in]  The number of characters.
+	 * @param output [out] The string to append to.
+	 */
+	static void writeString(const char* value, std::size_t size, std::string& output);
+};
+
+#endif // DATAFLOW_NODE_JSON_H_INCLUDED
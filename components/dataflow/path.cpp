@@ -0,0 +1,150 @@
+#include "path.h"
+
+// Standard includes
+#include <cctype>
+#include <cstdlib>
+
+// Path
+
+Path::Path(const std::string& path)
+{
+	// Splitting the path into segments, skipping empty ones (eg. leading '/')
+	std::size_t start = 0;
+	while(start <= path.size()) {
+		std::size_t end = path.find('/', start);
+		if(end == std::string::npos) end = path.size();
+
+		if(end > start) {
+			Segment segment{ path.substr(start, end - start), 0, false };
+
+			// Numeric segments also select children by position
+			char* last = nullptr;
+			unsigned long index = strtoul(segment.m_name.c_str(), &last, 10);
+			if(*last == '\0' && isdigit((unsigned char) segment.m_name[0])) {
+				segment.m_index = index;
+				segment.m_numeric = true;
+			}
+
+			m_segments.push_back(segment);
+		}
+
+		start = end + 1;
+	}
+}
+
+const Node* Path::resolve(const Node& root) const noexcept
+{
+	const Node* node = &root;
+
+	// Selecting the children along the segments
+	for(std::size_t i = 0; i < m_segments.size() && node != nullptr; i++) {
+		node = select(*node, m_segments[i]);
+	}
+
+	return node;
+}
+
+JsonObject Path::resolve(const JsonObject& root) const
+{
+	// Selecting the children along the segments, the selections are temporaries,
+	// so assigning them takes them over without copying the subtrees
+	if(m_segments.empty()) return root;
+
+	JsonObject object = (m_segments[0].m_numeric && root.isArray()) ? root[m_segments[0].m_index] : root[m_segments[0].m_name];
+
+	for(std::size_t i = 1; i < m_segments.size(); i++) {
+		const Segment& segment = m_segments[i];
+		object = (segment.m_numeric && object.isArray()) ? object[segment.m_index] : object[segment.m_name];
+	}
+
+	return object;
+}
+
+bool Path::Segment::operator==(const Segment& other) const noexcept
+{
+	return m_numeric == other.m_numeric && m_index == other.m_index && m_name == other.m_name;
+}
+
+const Node* Path::select(const Node& node, const Segment& segment) noexcept
+{
+	std::size_t position = 0;
+
+	// Scanning the children for the matching position or name
+	for(const Node* child = node.first_child(); child != nullptr; child = child->next_sibling(), position++) {
+		if(segment.m_numeric ? (position == segment.m_index) : (child->name() == segment.m_name)) return child;
+	}
+
+	return nullptr;
+}
+
+// PathSet
+
+PathSet::PathSet(std::initializer_list<std::string> paths)
+	: m_entries(1), m_size(paths.size())
+{
+	std::size_t output = 0;
+
+	// Merging the segments of the paths into the prefix tree
+	for(const std::string& text : paths) {
+		Path path(text);
+		std::size_t entry = 0;
+
+		for(const Path::Segment& segment : path.m_segments) {
+
+			// Searching for an existing entry with the same segment
+			std::size_t next = 0;
+			for(std::size_t child : m_entries[entry].m_children) {
+				if(m_entries[child].m_segment == segment) next = child;
+			}
+
+			// Creating a new entry for the segment
+			if(next == 0) {
+				next = m_entries.size();
+				m_entries.push_back(Entry{ segment, {}, {} });
+				m_entries[entry].m_children.push_back(next);
+			}
+
+			entry = next;
+		}
+
+		m_entries[entry].m_outputs.push_back(output++);
+	}
+}
+
+std::size_t PathSet::size() const noexcept
+{
+	return m_size;
+}
+
+std::size_t PathSet::extract(const Node& root, const Node* outputs[]) const noexcept
+{
+	// Clearing the outputs of the missing paths
+	for(std::size_t i = 0; i < m_size; i++) outputs[i] = nullptr;
+
+	return extract(root, 0, outputs);
+}
+
+std::size_t PathSet::extract(const Node& node, std::size_t entry, const Node* outputs[]) const noexcept
+{
+	const Entry& current = m_entries[entry];
+	std::size_t found = current.m_outputs.size();
+
+	// Setting the outputs of the paths ending here
+	for(std::size_t output : current.m_outputs) outputs[output] = &node;
+
+	// Scanning the children once, descending into the ones matching any of the segments
+	if(current.m_children.empty()) return found;
+
+	std::size_t position = 0;
+	for(const Node* child = node.first_child(); child != nullptr; child = child->next_sibling(), position++) {
+		for(std::size_t next : current.m_children) {
+			const Path::Segment& segment = m_entries[next].m_segment;
+
+			if(segment.m_numeric ? (position == segment.m_index) : (child->name() == segment.m_name)) {
+				found += extract(*child, next, outputs);
+			}
+		}
+	}
+
+	return found;
+}
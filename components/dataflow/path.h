@@ -0,0 +1,129 @@
+#pragma once
+#ifndef DATAFLOW_PATH_H_INCLUDED
+#define DATAFLOW_PATH_H_INCLUDED
+
+// Standard includes
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <initializer_list>
+
+// Project includes
+#include "node.hpp"
+#include "json.h"
+
+
+/**
+ * The Path class stores a pre-parsed path of child names and indices, such as
+ * "forecast/0/temperature/day", for repeated lookups in Node and JSON trees.
+ * The path is split into segments once at construction, so resolving it only
+ * compares the segments against the children, without parsing or allocation.
+ * Numeric segments select children by position (array items), others by name.
+ */
+class Path {
+public:
+
+	/**
+	 * Constructs a Path from its textual representation.
+	 * @param path [in] The segments of the path separated by '/' (eg. "forecast/0/id").
+	 */
+	Path(const std::string& path);
+
+	/**
+	 * Resolves the Path in the specified Node tree.
+	 * @param  root [in] The Node to start resolving from.
+	 * @return Pointer to the Node at the Path, or nullptr when it does not exist.
+	 */
+	const Node* resolve(const Node& root) const noexcept;
+
+	/**
+	 * Resolves the Path in the specified JSON tree, like the equivalent chain of
+	 * operator[] calls would (missing members resolve to empty objects). In JSON
+	 * objects numeric segments are looked up by name.
+	 * @param  root [in] The JsonObject to start resolving from.
+	 * @return The JsonObject at the Path.
+	 */
+	JsonObject resolve(const JsonObject& root) const;
+
+private:
+
+	// The PathSet compiles the segments of multiple Paths into a prefix tree
+	friend class PathSet;
+
+	/**
+	 * The Segment structure stores a single step of the Path.
+	 */
+	struct Segment {
+		std::string m_name;    /**< The name of the child to select.           */
+		std::size_t m_index;   /**< The position of the child (numeric only).  */
+		bool        m_numeric; /**< Whether the segment selects by position.   */
+
+		bool operator==(const Segment& other) const noexcept;
+	};
+
+	/**
+	 * Selects the child of the Node matching the segment.
+	 * @param  node    [in] The Node to select the child of.
+	 * @param  segment [in] The segment to match.
+	 * @return Pointer to the matching child, or nullptr when there is none.
+	 */
+	static const Node* select(const Node& node, const Segment& segment) noexcept;
+
+	std::vector<Segment> m_segments; /**< The segments of the path. */
+};
+
+/**
+ * The PathSet class extracts multiple Paths from a Node tree in a single traversal.
+ * The Paths are compiled into a prefix tree, so their common prefixes (eg. the
+ * "forecast/0" of "forecast/0/id" and "forecast/0/day") are only resolved once,
+ * and the children of every Node are scanned only once for all of the Paths.
+ */
+class PathSet {
+public:
+
+	/**
+	 * Constructs a PathSet from the textual representation of the Paths.
+	 * @param paths [in] The paths to extract, in the order of the outputs.
+	 */
+	PathSet(std::initializer_list<std::string> paths);
+
+	/**
+	 * Queries the number of Paths in the set.
+	 * @return The number of Paths, which is the number of outputs of extract().
+	 */
+	std::size_t size() const noexcept;
+
+	/**
+	 * Extracts all of the Paths from the Node tree.
+	 * @param  root    [in]  The Node to start resolving from.
+	 * @param  outputs [out] Array of size() pointers, set to the Nodes at the Paths
+	 *                       in the order of construction, or nullptr for missing ones.
+	 * @return The number of Paths found.
+	 */
+	std::size_t extract(const Node& root, const Node* outputs[]) const noexcept;
+
+private:
+
+	/**
+	 * The Entry structure stores a node of the prefix tree.
+	 */
+	struct Entry {
+		Path::Segment            m_segment;  /**< The segment leading to this entry.        */
+		std::vector<std::size_t> m_children; /**< Indices of the child entries.             */
+		std::vector<std::size_t> m_outputs;  /**< The outputs of the Paths ending here.     */
+	};
+
+	/**
+	 * Extracts the Paths below the specified entry of the prefix tree.
+	 * @param  node    [in]  The Node matching the entry.
+	 * @param  entry   [in]  The index of the entry.
+	 * @param  outputs [out] The outputs of extract().
+	 * @return The number of Paths found.
+	 */
+	std::size_t extract(const Node& node, std::size_t entry, const Node* outputs[]) const noexcept;
+
+	std::vector<Entry> m_entries; /**< The prefix tree, the first entry is the root. */
+	std::size_t        m_size;    /**< The number of Paths in the set.              */
+};
+
+#endif // DATAFLOW_PATH_H_INCLUDED
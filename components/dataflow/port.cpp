@@ -1,62 +1,252 @@
 #include "port.h"
 
-Port::Port(Direction direction, const std::string& name, std::size_t queueSize)
-	: m_direction(direction), m_name(name), m_connected(false)
+// Standard includes
+#include <chrono>
+#include <algorithm>
+
+// ESP-IDF includes
+#include "esp_log.h"
+
+// Project includes
+#include "recorder.h"
+#include "node_diff.h"
+
+Port::Port(Direction direction, const std::string& name, std::size_t queueSize, std::size_t lanes)
+	: m_available(nullptr), m_listener(nullptr), m_recorder(nullptr), m_channel(0), m_emit(Emit::ALWAYS), m_hasPrevious(false), m_direction(direction), m_name(name), m_connected(false), m_internal(false), m_invalid(0), m_messages(0), m_capacity(0), m_dropped(0), m_latency(0), m_closed(false)
 {
 	if(m_direction == Direction::INPUT) {
-		m_queues.push_back(xQueueCreate(queueSize, sizeof(Node*)));
+
+		// Creating a message queue for every priority lane
+		for(std::size_t i = 0; i < std::max<std::size_t>(lanes, 1); i++) {
+			m_lanes.push_back(xQueueCreate(queueSize, sizeof(Envelope)));
+		}
+
+		m_capacity = queueSize * m_lanes.size();
+
+		// Counting the messages of all lanes, so receiving can block on all of them
+		if(m_lanes.size() > 1) {
+			m_available = xSemaphoreCreateCounting(queueSize * m_lanes.size(), 0);
+		}
 	}
 }
 
+const char* PortClosed::what() const noexcept
+{
+	return "Port closed";
+}
+
 Port::~Port()
 {
-	if(m_direction == Direction::INPUT) {
-		//vQueueDelete(m_queue);
-	}
+	release();
 }
 
-bool Port::send(const Node& message)
+bool Port::send(const Node& message, TickType_t timeout)
 {
-	// Status flag to indicate sussessful write to all queues
-	bool status = true;
+	// Input ports send the message to their own queue (eg. initial messages)
+	if(m_direction == Direction::INPUT) return enqueue(message, 0, timeout);
+
+	// Skipping the emit mode processing of outputs nobody listens to
+	if(!hasSubscribers()) return true;
+
+	// Skipping unchanged messages, or replacing them with their changes
+	Node delta;
+	const Node* outgoing = &message;
+
+	if(m_emit != Emit::ALWAYS) {
 
-	// Sending the message to all queues
-	for(auto queue : m_queues) {
+		// The first message is always sent as a whole, there is nothing to compare it to
+		if(m_hasPrevious) {
+			if(message == m_previous) return true;
 
-		// Making a copy of the message to send
-		Node* copy = new Node(message);
+			if(m_emit == Emit::DELTA) {
+				NodeDiff::diff(m_previous, message, delta);
+				outgoing = &delta;
+			}
+		}
 
-		// Sending the message to the output queue
-		status &= (xQueueSendToBack(queue, (void*) &copy, portMAX_DELAY) == pdTRUE);
+		// Keeping a copy of the message, sharing its children
+		m_previous = message;
+		m_hasPrevious = true;
 	}
 
+	// Recording the message sent
+	if(m_recorder != nullptr) m_recorder->record(m_channel, *outgoing);
+
+	// Status flag to indicate sussessful write to all queues
+	bool status = true;
+
+	// Sending the message to all connected input ports
+	for(const Connection& connection : m_connections) {
+		status &= connection.m_target->enqueue(*outgoing, connection.m_lane, timeout);
+	}
+
+	m_messages++;
 	return status;
 }
 
-bool Port::receive(Node& message)
+bool Port::receive(Node& message, TickType_t timeout)
 {
 	// Checking if the port is an input port
 	if(m_direction != Direction::INPUT) return false;
 
+	// Checking if the port is closed
+	if(m_closed) {
+#if defined(EXCEPTIONS_ENABLED)
+		throw PortClosed();
+#else
+		return false;
+#endif
+	}
+
 	// Popping the message pointer from the queue
-	Node* message_ptr = nullptr;
-	bool status = xQueueReceive(m_queues[0], &message_ptr, portMAX_DELAY) == pdTRUE;
+	Envelope envelope = { nullptr, 0 };
+	bool status = false;
 
-	// Returning the message
-	if(status) message = *message_ptr;
+	// Single lane ports receive directly from the queue
+	if(m_available == nullptr) {
+		status = xQueueReceive(m_lanes[0], &envelope, timeout) == pdTRUE;
+	}
+
+	// Multi-lane ports wait for any message, then drain the highest lane first
+	else if(xSemaphoreTake(m_available, timeout) == pdTRUE) {
+		for(auto lane = m_lanes.rbegin(); lane != m_lanes.rend() && !status; ++lane) {
+			status = xQueueReceive(*lane, &envelope, 0) == pdTRUE;
+		}
+	}
+
+	// Closing the port queues an empty message to wake up the receiver
+	if(status && envelope.m_message == nullptr) {
+#if defined(EXCEPTIONS_ENABLED)
+		throw PortClosed();
+#else
+		return false;
+#endif
+	}
+
+	// Returning the message, accounting the time it was waiting in the queue
+	if(status) {
+		message = *envelope.m_message;
+		m_messages++;
+		m_latency += static_cast<uint32_t>(timestamp() - envelope.m_queued);
+	}
 
 	// Deleting the message copy
-	delete message_ptr;
+	delete envelope.m_message;
 
 	// Returning the message receive status
 	return status;
 }
 
+void Port::close() noexcept
+{
+	if(m_direction != Direction::INPUT || m_lanes.empty() || m_closed.exchange(true)) return;
+
+	// Deleting the queued messages, then waking up the receiver with an empty message
+	drain();
+
+	Envelope wakeup = { nullptr, 0 };
+	if(xQueueSendToBack(m_lanes[0], (void*) &wakeup, 0) == pdTRUE && m_available != nullptr) xSemaphoreGive(m_available);
+
+	// Waking up the executor of a cooperative component
+	if(m_listener != nullptr) xTaskNotifyGive(m_listener);
+}
+
+void Port::open() noexcept
+{
+	if(m_direction != Direction::INPUT || m_lanes.empty() || !m_closed) return;
+
+	// Removing the empty message queued by close()
+	drain();
+	m_closed = false;
+}
+
+bool Port::isClosed() const noexcept
+{
+	return m_closed;
+}
+
+void Port::release() noexcept
+{
+	m_closed = true;
+	drain();
+
+	// Deleting the message queues of the lanes and the counting semaphore
+	for(QueueHandle_t queue : m_lanes) vQueueDelete(queue);
+	if(m_available != nullptr) vSemaphoreDelete(m_available);
+
+	m_lanes.clear();
+	m_available = nullptr;
+}
+
 bool Port::isConnected() const noexcept
 {
 	return m_connected;
 }
 
+bool Port::hasSubscribers() const noexcept
+{
+	return !m_connections.empty() || m_recorder != nullptr;
+}
+
+void Port::setInternal(bool internal) noexcept
+{
+	m_internal = internal;
+}
+
+bool Port::isInternal() const noexcept
+{
+	return m_internal;
+}
+
+std::size_t Port::invalidConnections() const noexcept
+{
+	return m_invalid;
+}
+
+void Port::refuseConnection() noexcept
+{
+	m_invalid++;
+}
+
+std::size_t Port::messages() const noexcept
+{
+	return m_messages;
+}
+
+std::size_t Port::depth() const noexcept
+{
+	// Summing the messages waiting in the lanes without taking them
+	std::size_t depth = 0;
+	for(QueueHandle_t queue : m_lanes) depth += uxQueueMessagesWaiting(queue);
+
+	return depth;
+}
+
+std::size_t Port::capacity() const noexcept
+{
+	return m_capacity;
+}
+
+std::size_t Port::lanes() const noexcept
+{
+	return m_lanes.size();
+}
+
+uint64_t Port::latency() const noexcept
+{
+	return m_latency;
+}
+
+std::size_t Port::dropped() const noexcept
+{
+	return m_dropped;
+}
+
+const std::vector<Port::Connection>& Port::connections() const noexcept
+{
+	return m_connections;
+}
+
 const Port::Direction& Port::direction() const noexcept
 {
 	return m_direction;
@@ -67,15 +257,98 @@ const std::string& Port::name() const noexcept
 	return m_name;
 }
 
-void Port::operator>>(Port& other) noexcept
+void Port::setListener(TaskHandle_t listener) noexcept
+{
+	m_listener = listener;
+}
+
+void Port::setRecorder(PortRecorder* recorder, uint16_t channel) noexcept
+{
+	m_recorder = recorder;
+	m_channel = channel;
+}
+
+bool Port::enqueue(const Node& message, std::size_t lane, TickType_t timeout)
+{
+	// Dropping the messages of closed ports
+	if(m_closed || m_lanes.empty()) {
+		m_dropped++;
+		return false;
+	}
+
+	// Limiting the lane to the available lanes of this port
+	lane = std::min(lane, m_lanes.size() - 1);
+
+	// Recording the message queued
+	if(m_recorder != nullptr) m_recorder->record(m_channel, message);
+
+	// Making a copy of the message to send, stamped for measuring the latency
+	Envelope envelope = { new Node(message), timestamp() };
+
+	// Sending the message to the message queue of the lane
+	bool status = (xQueueSendToBack(m_lanes[lane], (void*) &envelope, timeout) == pdTRUE);
+
+	// Deleting the copy of the message dropped
+	if(!status) {
+		delete envelope.m_message;
+		m_dropped++;
+		return false;
+	}
+
+	// Indicating the new message for the receivers of multi-lane ports
+	if(m_available != nullptr) xSemaphoreGive(m_available);
+
+	// Waking up the executor of a cooperative component
+	if(m_listener != nullptr) xTaskNotifyGive(m_listener);
+
+	return status;
+}
+
+void Port::drain() noexcept
+{
+	// Deleting the messages of all lanes without blocking
+	for(QueueHandle_t queue : m_lanes) {
+		Envelope envelope = { nullptr, 0 };
+		while(xQueueReceive(queue, &envelope, 0) == pdTRUE) delete envelope.m_message;
+	}
+
+	// Resetting the count of the available messages
+	if(m_available != nullptr) while(xSemaphoreTake(m_available, 0) == pdTRUE) {}
+}
+
+void Port::setEmit(Emit mode)
+{
+	m_emit = mode;
+	m_previous.clear();
+	m_hasPrevious = false;
+}
+
+bool Port::connect(Port& other, std::size_t lane) noexcept
 {
 	// Checking if this Port is an output and the target is an input
-	if(m_direction != Direction::OUTPUT || other.m_direction != Direction::INPUT) return;
+	if(m_direction != Direction::OUTPUT || other.m_direction != Direction::INPUT) {
+		ESP_LOGE("DATAFLOW", "Refused to connect port \"%s\" to port \"%s\": wrong direction.", m_name.c_str(), other.m_name.c_str());
+		refuseConnection();
+		return false;
+	}
 
-	// Connecting the message queues of the ports
-	m_queues.push_back(other.m_queues[0]);
+	// Connecting the lane of the input port to this output port
+	m_connections.push_back(Connection{ &other, lane });
 
 	// Indicating connection status for both ports
 	m_connected = true;
 	other.m_connected = true;
+
+	return true;
+}
+
+void Port::operator>>(Port& other) noexcept
+{
+	connect(other, 0);
+}
+
+uint32_t Port::timestamp() noexcept
+{
+	auto now = std::chrono::steady_clock::now().time_since_epoch();
+	return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(now).count());
 }
@@ -3,16 +3,34 @@
 #define DATAFLOW_PORT_H_INCLUDED
 
 // Standard includes
+#include <atomic>
 #include <string>
 #include <vector>
+#include <cstdint>
+#include <exception>
 
 // FreeRTOS include
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 
 // Project includes
 #include "node.hpp"
 
+// Forward declaration of the recorder capturing the traffic of Ports
+class PortRecorder;
+
+
+/**
+ * The PortClosed exception is thrown by Port::receive() when the input Port is
+ * closed (eg. the flow is stopped), unwinding the Component back to its task, so
+ * the objects on its stack (eg. received messages) are destroyed properly.
+ */
+class PortClosed : public std::exception {
+public:
+	const char* what() const noexcept override;
+};
 
 /**
  * The Port class implements a generic input/output capability for
@@ -21,6 +39,14 @@
  * components at initialization and stored inside the components
  * themselves in an inherited storage container. The internal message
  * passing mechanism uses thread-safe message queues from the RTOS.
+ *
+ * Input ports may have multiple priority lanes, each with its own message
+ * queue. Connections are tagged with the lane they deliver to, and receiving
+ * always drains the highest lane first, so latency-sensitive control messages
+ * can overtake bulk data queued on the same port.
+ *
+ * Output ports may suppress unchanged messages (see Emit), so steady readings
+ * do not trigger downstream work (eg. redrawing displays or uploading data).
  */
 class Port {
 public:
@@ -33,33 +59,79 @@ public:
 		OUTPUT /**< OUTPUT, used to send messages.   */
 	};
 
+	/**
+	 * Defines the emit modes of output ports.
+	 */
+	enum class Emit {
+		ALWAYS,    /**< Every message is sent (default).                                 */
+		ON_CHANGE, /**< Messages equal to the previous one are not sent.                  */
+		DELTA      /**< Only the changes to the previous message are sent (see NodeDiff). */
+	};
+
 	/**
 	 * Constructs a Port with the specified dataflow direction and name.
 	 * @param direction [in] The dataflow direction of the Port.
 	 * @param name      [in] The unique (component-wise) name of the Port.
 	 * @param queueSize [in] Applicable only to input ports, the size of the message queue.
+	 * @param lanes     [in] Applicable only to input ports, the number of priority lanes.
 	 */
-	Port(Direction direction, const std::string& name, std::size_t queueSize);
+	Port(Direction direction, const std::string& name, std::size_t queueSize, std::size_t lanes = 1);
 
 	/**
-	 * Destroys the Port and releases internal resources (eg. RTOS message queues).
+	 * Destroys the Port and releases internal resources (eg. RTOS message queues),
+	 * deleting the messages still queued.
 	 */
 	~Port();
 
+	// Ports own their message queues, so they can not be copied
+	Port(const Port&) = delete;
+	Port& operator=(const Port&) = delete;
+
 	/**
 	 * Sends a message to all of the connected input ports. This operation
-	 * blocks when the input port message queue is full.
+	 * blocks when the input port message queue is full. Depending on the emit
+	 * mode, unchanged messages are skipped, or only the changes are sent.
 	 * @param  message [in] Pointer to the message to send.
+	 * @param  timeout [in] The time to wait for room in each full queue, zero to drop
+	 *                      the message instead (eg. when sending from the timer service).
 	 * @return True when the messages are sent successfully.
 	 */
-	bool send(const Node& message);
+	bool send(const Node& message, TickType_t timeout = portMAX_DELAY);
 
 	/**
-	 * Receives a message from the input port message queue.
+	 * Receives a message from the input port message queue, taking the messages
+	 * of higher priority lanes first when the port has multiple lanes.
 	 * @param  message [in] The referenced pointer that will point to the message.
-	 * @return True when the message is successfully received.
+	 * @param  timeout [in] The maximum number of ticks to wait for a message (zero to poll).
+	 * @return True when the message is successfully received. When the port is closed
+	 *         PortClosed is thrown (false is returned when exceptions are disabled).
+	 */
+	bool receive(Node& message, TickType_t timeout = portMAX_DELAY);
+
+	/**
+	 * Closes this input Port: the queued messages are deleted, the messages sent
+	 * later are dropped, and the receiving task is woken up with PortClosed. This
+	 * is used when stopping the flow, or when the Component finishes.
+	 */
+	void close() noexcept;
+
+	/**
+	 * Opens this input Port again after it was closed, eg. when restarting the flow.
+	 */
+	void open() noexcept;
+
+	/**
+	 * Queries whether this input Port is closed.
+	 * @return True when the Port is closed.
+	 */
+	bool isClosed() const noexcept;
+
+	/**
+	 * Closes this input Port and deletes its message queues, so only the Port object
+	 * itself remains. This is used when tearing down the flow, after all of the tasks
+	 * are stopped, the Port must not be used afterwards.
 	 */
-	bool receive(Node& message);
+	void release() noexcept;
 
 	/**
 	 * Queries whether the Port is connected to another Port.
@@ -67,6 +139,78 @@ public:
 	 */
 	bool isConnected() const noexcept;
 
+	/**
+	 * Queries whether anything consumes the messages sent by this output Port: a
+	 * connected input port or a recorder. Components can check this before building
+	 * a message, so the outputs nobody listens to cost nothing (see Dataflow::finalize()).
+	 * @return True when the messages sent are delivered anywhere.
+	 */
+	bool hasSubscribers() const noexcept;
+
+	/**
+	 * Marks this Port internal to its Component, eg. the input port receiving the
+	 * expirations of a Timer, so it is not reported as unconnected.
+	 * @param internal [in] Whether the Port is internal.
+	 */
+	void setInternal(bool internal) noexcept;
+
+	/**
+	 * Queries whether this Port is internal to its Component.
+	 * @return True when the Port is not meant to be connected.
+	 */
+	bool isInternal() const noexcept;
+
+	/**
+	 * Queries the number of connections refused from this Port, because of the
+	 * wrong direction of the ports or a port not found by a PortQuery.
+	 * @return The number of invalid connection attempts.
+	 */
+	std::size_t invalidConnections() const noexcept;
+
+	/**
+	 * Records a connection attempt from this Port which could not be made.
+	 */
+	void refuseConnection() noexcept;
+
+	/**
+	 * Queries the number of messages passed through this Port: the messages received
+	 * by input ports, and the messages sent (not skipped) by output ports.
+	 * @return The number of messages passed through this Port.
+	 */
+	std::size_t messages() const noexcept;
+
+	/**
+	 * Queries the number of messages waiting in the queues of this input Port.
+	 * @return The number of messages queued in all lanes.
+	 */
+	std::size_t depth() const noexcept;
+
+	/**
+	 * Queries the number of messages the queues of this input Port can hold.
+	 * @return The total capacity of the lanes.
+	 */
+	std::size_t capacity() const noexcept;
+
+	/**
+	 * Queries the number of priority lanes of this input Port.
+	 * @return The number of lanes, zero for output ports and released input ports.
+	 */
+	std::size_t lanes() const noexcept;
+
+	/**
+	 * Queries the total time the messages received by this input Port spent waiting
+	 * in its queues. Divided by the change of messages() it gives the mean latency.
+	 * @return The total queueing latency in microseconds.
+	 */
+	uint64_t latency() const noexcept;
+
+	/**
+	 * Queries the number of messages dropped by this input Port, because its queue
+	 * was full for the whole timeout of the sender, or the Port was closed.
+	 * @return The number of messages not queued.
+	 */
+	std::size_t dropped() const noexcept;
+
 	/**
 	 * Quries the dataflow direction of this Port.
 	 * @return The dataflow direction of this Port: input or output.
@@ -80,16 +224,107 @@ public:
 	const std::string& name() const noexcept;
 
 	/**
-	 * Connects this input Port to the specified output Port.
-	 * @param other [in] The other output port to connect to.
+	 * Sets the task to be notified whenever a message is queued on this input
+	 * Port. This is used by executors running cooperative components, which
+	 * sleep on their task notification instead of blocking on the queue.
+	 * @param listener [in] The task to notify, or nullptr to disable notifications.
+	 */
+	void setListener(TaskHandle_t listener) noexcept;
+
+	/**
+	 * Sets the recorder capturing the messages passing through this Port. Output
+	 * ports record the messages sent, input ports record the messages queued.
+	 * @param recorder [in] The recorder to use, or nullptr to stop recording.
+	 * @param channel  [in] The channel identifying this Port in the recording.
+	 */
+	void setRecorder(PortRecorder* recorder, uint16_t channel) noexcept;
+
+	/**
+	 * Sets the emit mode of this output Port, forgetting the previous message, so the
+	 * next message is sent as a whole.
+	 * @param mode [in] The emit mode to use.
+	 */
+	void setEmit(Emit mode);
+
+	/**
+	 * Connects this output Port to the specified priority lane of the input Port.
+	 * Connections between ports of the wrong direction are refused and logged.
+	 * @param  other [in] The other input port to connect to.
+	 * @param  lane  [in] The priority lane of the input port (higher is more urgent).
+	 * @return True when the ports are connected.
+	 */
+	bool connect(Port& other, std::size_t lane) noexcept;
+
+	/**
+	 * Connects this output Port to the lowest priority lane of the input Port.
+	 * @param other [in] The other input port to connect to.
 	 */
 	void operator>>(Port& other) noexcept;
 
+	/**
+	 * The Connection structure describes a connection to an input Port.
+	 */
+	struct Connection {
+		Port*       m_target; /**< The connected input port.           */
+		std::size_t m_lane;   /**< The priority lane of the input port. */
+	};
+
+	/**
+	 * Queries the input ports this output Port is connected to.
+	 * @return The connections of this Port, in the order of connecting.
+	 */
+	const std::vector<Connection>& connections() const noexcept;
+
 private:
-	std::vector<QueueHandle_t> m_queues;    /**< The list of message queues that are connected    */
-	Direction                  m_direction; /**< The dataflow direction of this port.             */
-	std::string                m_name;      /**< The unique name of this port.                    */
-	bool                       m_connected; /**< Flag to indicate whether this port is connected. */
+
+	/**
+	 * The Envelope structure is the item of the message queues, it carries the copy
+	 * of the message along with the time it was queued at.
+	 */
+	struct Envelope {
+		Node*    m_message; /**< The copy of the message, nullptr wakes up the receiver. */
+		uint32_t m_queued;  /**< The time of queueing in microseconds.                   */
+	};
+
+	/**
+	 * Queries the time used to measure the queueing latency.
+	 * @return The current time in microseconds, wrapping around.
+	 */
+	static uint32_t timestamp() noexcept;
+
+	/**
+	 * Places a copy of the message into the specified lane of this input Port.
+	 * @param  message [in] The message to copy into the queue.
+	 * @param  lane    [in] The priority lane to place the message into.
+	 * @param  timeout [in] The time to wait for room in the queue when it is full.
+	 * @return True when the message is queued successfully.
+	 */
+	bool enqueue(const Node& message, std::size_t lane, TickType_t timeout);
+
+	/**
+	 * Deletes the messages waiting in the queues of this input Port.
+	 */
+	void drain() noexcept;
+
+	std::vector<QueueHandle_t> m_lanes;       /**< The message queues of the lanes (input only).     */
+	SemaphoreHandle_t          m_available;   /**< Counts the messages of all lanes (input only).    */
+	std::vector<Connection>    m_connections; /**< The list of input ports connected (output only).  */
+	TaskHandle_t               m_listener;    /**< The task notified on new messages (input only).   */
+	PortRecorder*              m_recorder;    /**< The recorder capturing the traffic of this port.  */
+	uint16_t                   m_channel;     /**< The channel of this port in the recording.        */
+	Emit                       m_emit;        /**< The emit mode of this port (output only).         */
+	Node                       m_previous;    /**< The previous message sent in ON_CHANGE and DELTA. */
+	bool                       m_hasPrevious; /**< Flag to indicate whether a message has been sent. */
+	Direction                  m_direction;   /**< The dataflow direction of this port.              */
+	std::string                m_name;        /**< The unique name of this port.                     */
+	bool                       m_connected;   /**< Flag to indicate whether this port is connected.  */
+	bool                       m_internal;    /**< Flag to indicate whether this port is internal.   */
+	std::size_t                m_invalid;     /**< The number of connections refused from this port. */
+	std::size_t                m_messages;    /**< The number of messages passed through this port.  */
+	std::size_t                m_capacity;    /**< The capacity of the lanes (input only).           */
+	std::atomic<std::size_t>   m_dropped;     /**< The number of messages not queued (input only).   */
+	std::atomic<uint64_t>      m_latency;     /**< The total queueing time in microseconds.          */
+	std::atomic<bool>          m_closed;      /**< Flag to indicate whether this port is closed.     */
 };
 
 #endif // DATAFLOW_PORT_H_INCLUDED
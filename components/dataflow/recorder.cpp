@@ -0,0 +1,284 @@
+#include "recorder.h"
+
+// Standard includes
+#include <cstring>
+
+// FreeRTOS includes
+#include "freertos/task.h"
+
+// Project includes
+#include "serializer.h"
+
+// Values identifying the recording files
+static const char     RECORDING_MAGIC[4] = { 'D', 'F', 'R', 'C' };
+static const uint16_t RECORDING_VERSION  = 2;
+
+/**
+ * Defines the kinds of records in the recording files.
+ */
+enum RecordKind : uint8_t { RECORD_CHANNEL = 0, RECORD_MESSAGE = 1 };
+
+/**
+ * Appends an unsigned integer to the buffer in little-endian byte order.
+ * @param buffer [in] The buffer to append to.
+ * @param value  [in] The value to append.
+ * @param bytes  [in] The number of bytes to append.
+ */
+static void put(std::vector<uint8_t>& buffer, uint32_t value, std::size_t bytes)
+{
+	for(std::size_t i = 0; i < bytes; i++) buffer.push_back((value >> (8 * i)) & 0xFF);
+}
+
+/**
+ * Appends raw bytes to the buffer.
+ * @param buffer [in] The buffer to append to.
+ * @param data   [in] The bytes to append.
+ * @param size   [in] The number of bytes to append.
+ */
+static void append(std::vector<uint8_t>& buffer, const void* data, std::size_t size)
+{
+	buffer.insert(buffer.end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+}
+
+/**
+ * Reads a little-endian unsigned integer from the buffer.
+ * @param  data   [in]     The buffer to read from.
+ * @param  size   [in]     The size of the buffer.
+ * @param  offset [in,out] The read position, advanced past the value.
+ * @param  value  [out]    The value read.
+ * @param  bytes  [in]     The number of bytes to read.
+ * @return True when the buffer contains the value.
+ */
+static bool get(const uint8_t* data, std::size_t size, std::size_t& offset, uint32_t& value, std::size_t bytes)
+{
+	if(offset + bytes > size) return false;
+
+	value = 0;
+	for(std::size_t i = 0; i < bytes; i++) value |= (uint32_t) data[offset + i] << (8 * i);
+	offset += bytes;
+
+	return true;
+}
+
+/**
+ * Reads a little-endian unsigned integer from the file.
+ * @param  file  [in]  The file to read from.
+ * @param  value [out] The value read.
+ * @param  bytes [in]  The number of bytes to read.
+ * @return True when the file contains the value.
+ */
+static bool get(FILE* file, uint32_t& value, std::size_t bytes)
+{
+	uint8_t data[4];
+	std::size_t offset = 0;
+
+	return fread(data, 1, bytes, file) == bytes && get(data, bytes, offset, value, bytes);
+}
+
+// PortRecorder
+
+PortRecorder::PortRecorder()
+	: m_file(nullptr), m_mutex(xSemaphoreCreateMutex()), m_channels(0)
+{}
+
+PortRecorder::~PortRecorder()
+{
+	close();
+	vSemaphoreDelete(m_mutex);
+}
+
+bool PortRecorder::open(const std::string& path)
+{
+	// Closing the previous recording
+	close();
+
+	// Creating the recording file
+	FILE* file = fopen(path.c_str(), "wb");
+	if(file == nullptr) return false;
+
+	// Writing the header of the recording
+	std::vector<uint8_t> header;
+	append(header, RECORDING_MAGIC, sizeof(RECORDING_MAGIC));
+	put(header, RECORDING_VERSION, 2);
+	fwrite(header.data(), 1, header.size(), file);
+
+	xSemaphoreTake(m_mutex, portMAX_DELAY);
+	m_file = file;
+	m_channels = 0;
+	m_last = std::chrono::steady_clock::now();
+	xSemaphoreGive(m_mutex);
+
+	return true;
+}
+
+void PortRecorder::close()
+{
+	xSemaphoreTake(m_mutex, portMAX_DELAY);
+
+	if(m_file != nullptr) fclose(m_file);
+	m_file = nullptr;
+
+	xSemaphoreGive(m_mutex);
+}
+
+bool PortRecorder::attach(Port& port, const std::string& name)
+{
+	xSemaphoreTake(m_mutex, portMAX_DELAY);
+
+	// Checking if the recording is opened and the channel name fits
+	bool status = (m_file != nullptr) && (name.size() <= UINT16_MAX) && (m_channels < UINT16_MAX);
+
+	if(status) {
+
+		// Declaring the channel in the recording
+		std::vector<uint8_t> record;
+		put(record, RECORD_CHANNEL, 1);
+		put(record, m_channels, 2);
+		put(record, name.size(), 2);
+		append(record, name.data(), name.size());
+		status = fwrite(record.data(), 1, record.size(), m_file) == record.size();
+	}
+
+	// Attaching the port to the channel
+	if(status) port.setRecorder(this, m_channels++);
+
+	xSemaphoreGive(m_mutex);
+	return status;
+}
+
+void PortRecorder::record(uint16_t channel, const Node& message)
+{
+	// Taking the timestamp before waiting for other tasks recording
+	auto now = std::chrono::steady_clock::now();
+
+	xSemaphoreTake(m_mutex, portMAX_DELAY);
+
+	// Skipping the messages nested too deep to be encoded
+	uint32_t length = (m_file != nullptr) ? NodeSerializer::serializedSize(message) : 0;
+
+	if(length != 0) {
+
+		// Calculating the time elapsed since the previous message
+		auto delta = std::chrono::duration_cast<std::chrono::microseconds>(now - m_last).count();
+		if(delta < 0) delta = 0;
+		m_last = now;
+
+		// Writing the record header, reusing the buffer
+		m_buffer.clear();
+		put(m_buffer, RECORD_MESSAGE, 1);
+		put(m_buffer, channel, 2);
+		put(m_buffer, (uint32_t) delta, 4);
+		put(m_buffer, length, 4);
+
+		// Encoding the payload after the record header
+		std::size_t offset = m_buffer.size();
+		m_buffer.resize(offset + length);
+		NodeSerializer::serialize(message, m_buffer.data() + offset, length);
+
+		fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+	}
+
+	xSemaphoreGive(m_mutex);
+}
+
+// PortReplayer
+
+PortReplayer::PortReplayer()
+	: m_file(nullptr)
+{}
+
+PortReplayer::~PortReplayer()
+{
+	if(m_file != nullptr) fclose(m_file);
+}
+
+bool PortReplayer::open(const std::string& path)
+{
+	// Closing the previous recording
+	if(m_file != nullptr) fclose(m_file);
+
+	// Opening the recording file
+	m_file = fopen(path.c_str(), "rb");
+	if(m_file == nullptr) return false;
+
+	// Checking the header of the recording
+	char magic[sizeof(RECORDING_MAGIC)];
+	uint32_t version = 0;
+
+	if(fread(magic, 1, sizeof(magic), m_file) != sizeof(magic) || memcmp(magic, RECORDING_MAGIC, sizeof(magic)) != 0
+			|| !get(m_file, version, 2) || version != RECORDING_VERSION) {
+		fclose(m_file);
+		m_file = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+void PortReplayer::bind(const std::string& name, Port& port)
+{
+	m_ports[name] = &port;
+}
+
+std::size_t PortReplayer::replay(double speed)
+{
+	// Checking if a recording is opened
+	if(m_file == nullptr) return 0;
+
+	// The Ports bound to the channels declared in the recording
+	std::map<uint32_t, Port*> channels;
+	std::vector<uint8_t> payload;
+	std::size_t count = 0;
+
+	// The time the messages are scheduled to from the start of the replay
+	auto start = std::chrono::steady_clock::now();
+	double scheduled = 0;
+
+	uint32_t kind = 0, channel = 0;
+	while(get(m_file, kind, 1) && get(m_file, channel, 2)) {
+
+		// Resolving the Port of a declared channel
+		if(kind == RECORD_CHANNEL) {
+			uint32_t length = 0;
+			if(!get(m_file, length, 2)) break;
+
+			std::string name(length, '\0');
+			if(fread(&name[0], 1, length, m_file) != length) break;
+
+			auto it = m_ports.find(name);
+			channels[channel] = (it != m_ports.end()) ? it->second : nullptr;
+			continue;
+		}
+
+		// Reading the next message
+		uint32_t delta = 0, length = 0;
+		if(kind != RECORD_MESSAGE || !get(m_file, delta, 4) || !get(m_file, length, 4)) break;
+
+		payload.resize(length);
+		if(fread(payload.data(), 1, length, m_file) != length) break;
+
+		// Waiting for the time of the message, when replaying at the recorded speed
+		if(speed > 0) {
+			scheduled += delta / speed;
+			auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+			TickType_t ticks = (scheduled - elapsed) / (1000 * portTICK_RATE_MS);
+			if(scheduled > elapsed && ticks > 0) vTaskDelay(ticks);
+		}
+
+		// Sending the message to the bound Port
+		Port* port = channels.count(channel) ? channels[channel] : nullptr;
+		if(port == nullptr) continue;
+
+		Node message;
+		if(NodeSerializer::deserialize(payload.data(), payload.size(), message) == 0) break;
+
+		port->send(message);
+		count++;
+	}
+
+	// Rewinding the recording to the first record, so it can be replayed again
+	fseek(m_file, sizeof(RECORDING_MAGIC) + 2, SEEK_SET);
+
+	return count;
+}
@@ -0,0 +1,139 @@
+#pragma once
+#ifndef DATAFLOW_RECORDER_H_INCLUDED
+#define DATAFLOW_RECORDER_H_INCLUDED
+
+// Standard includes
+#include <map>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+
+// FreeRTOS includes
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+// Project includes
+#include "port.h"
+
+
+/**
+ * The PortRecorder class captures the messages passing through Ports into a
+ * compact binary file, along with the time elapsed between the messages. Each
+ * attached Port is identified by a channel name (eg. "display.in"), which is
+ * used to bind the recorded streams to Ports when replaying them.
+ *
+ * The message payloads are encoded by the NodeSerializer, so values of types
+ * not supported by it (eg. driver interface pointers) are recorded as empty
+ * Nodes, since they can not be reproduced on another device. Messages nested too
+ * deep to be encoded are not recorded.
+ *
+ * The file consists of a header and a sequence of records, all little-endian:
+ *
+ * header:  "DFRC" magic, uint16 version
+ * channel: uint8 kind (0), uint16 channel, uint16 name length, name
+ * message: uint8 kind (1), uint16 channel, uint32 microseconds since the
+ *          previous message, uint32 payload length, encoded payload
+ */
+class PortRecorder {
+public:
+
+	/**
+	 * Constructs a PortRecorder, which is not recording until opened.
+	 */
+	PortRecorder();
+
+	/**
+	 * Destroys the PortRecorder, closing the recording file.
+	 */
+	~PortRecorder();
+
+	/**
+	 * Opens a new recording file, eg. on a mounted SD card.
+	 * @param  path [in] The path of the recording file to create.
+	 * @return True when the file is created successfully.
+	 */
+	bool open(const std::string& path);
+
+	/**
+	 * Closes the recording file. The Ports stay attached, but are not recorded.
+	 */
+	void close();
+
+	/**
+	 * Starts recording the messages passing through the specified Port.
+	 * @param  port [in] The Port to record.
+	 * @param  name [in] The name of the channel in the recording (eg. "display.in").
+	 * @return True when the Port is attached successfully.
+	 */
+	bool attach(Port& port, const std::string& name);
+
+	/**
+	 * Records a message of the specified channel. This is called by the attached
+	 * Ports from the tasks sending the messages.
+	 * @param channel [in] The channel of the Port passing the message.
+	 * @param message [in] The message to record.
+	 */
+	void record(uint16_t channel, const Node& message);
+
+private:
+
+	FILE*                                 m_file;     /**< The recording file, nullptr when closed.   */
+	SemaphoreHandle_t                     m_mutex;    /**< Serializes the records of multiple tasks.  */
+	uint16_t                              m_channels; /**< The number of channels attached.           */
+	std::chrono::steady_clock::time_point m_last;     /**< The time of the last recorded message.     */
+	std::vector<uint8_t>                  m_buffer;   /**< Buffer for encoding the message payloads.  */
+};
+
+/**
+ * The PortReplayer class replays the message streams captured by a PortRecorder
+ * into Ports of a graph. The channels of the recording are bound to Ports by
+ * name, the messages of unbound channels are skipped. Messages are sent into the
+ * bound Ports, so input ports receive them directly, while output ports forward
+ * them to all of their connections. This makes it possible to load test components
+ * with real traffic, without the sensors and network attached (eg. on a host).
+ */
+class PortReplayer {
+public:
+
+	/**
+	 * Constructs a PortReplayer, which has no recording opened.
+	 */
+	PortReplayer();
+
+	/**
+	 * Destroys the PortReplayer, closing the recording file.
+	 */
+	~PortReplayer();
+
+	/**
+	 * Opens a recording file to replay.
+	 * @param  path [in] The path of the recording file.
+	 * @return True when the file is a valid recording.
+	 */
+	bool open(const std::string& path);
+
+	/**
+	 * Binds a channel of the recording to the specified Port.
+	 * @param name [in] The name of the channel in the recording.
+	 * @param port [in] The Port to send the messages of the channel into.
+	 */
+	void bind(const std::string& name, Port& port);
+
+	/**
+	 * Replays the whole recording, blocking the calling task until finished.
+	 * @param  speed [in] Playback speed relative to the recording (eg. 1.0 for the
+	 *                    recorded speed, 2.0 for double speed), or zero to replay
+	 *                    as fast as the graph consumes the messages.
+	 * @return The number of messages sent into bound Ports.
+	 */
+	std::size_t replay(double speed = 1.0);
+
+private:
+
+	FILE*                        m_file;  /**< The recording file, nullptr when closed. */
+	std::map<std::string, Port*> m_ports; /**< The Ports bound to channel names.        */
+};
+
+#endif // DATAFLOW_RECORDER_H_INCLUDED
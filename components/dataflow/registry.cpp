@@ -0,0 +1,89 @@
+#include "registry.h"
+
+bool ComponentRegistry::contains(const std::string& type) const noexcept
+{
+	return m_entries.count(type) != 0;
+}
+
+Component* ComponentRegistry::create(const std::string& type, const Node& parameters) const
+{
+	// Checking if the type is registered
+	auto it = m_entries.find(type);
+	if(it == m_entries.end()) return nullptr;
+
+	// Creating the component with the factory
+	return it->second.m_factory(parameters);
+}
+
+void ComponentRegistry::install(const std::string& type, Component* component, Dataflow& flow) const
+{
+	// Checking if the type is registered
+	auto it = m_entries.find(type);
+	if(it == m_entries.end()) return;
+
+	// Adding the component with its concrete type
+	it->second.m_install(component, flow);
+}
+
+double ComponentRegistry::getNumber(const Node& parameters, const std::string& name, double defaultValue)
+{
+	// Checking if the parameter is set
+	if(!parameters.has_child(name)) return defaultValue;
+
+	// Reading the parameter from a copy, as reading values requires non-const access
+	Node value = parameters[name];
+	return value.hasType<double>() ? (double) value : defaultValue;
+}
+
+std::string ComponentRegistry::getString(const Node& parameters, const std::string& name, const std::string& defaultValue)
+{
+	// Checking if the parameter is set
+	if(!parameters.has_child(name)) return defaultValue;
+
+	// Reading the parameter from a copy, as reading values requires non-const access
+	Node value = parameters[name];
+	return value.string_data() != nullptr ? (std::string) value : defaultValue;
+}
+
+bool ComponentRegistry::getBool(const Node& parameters, const std::string& name, bool defaultValue)
+{
+	// Checking if the parameter is set
+	if(!parameters.has_child(name)) return defaultValue;
+
+	// Reading the parameter from a copy, as reading values requires non-const access
+	Node value = parameters[name];
+	return value.hasType<bool>() ? (bool) value : defaultValue;
+}
+
+std::vector<std::string> ComponentRegistry::getStrings(const Node& parameters, const std::string& name)
+{
+	std::vector<std::string> strings;
+
+	// Checking if the parameter is set
+	if(!parameters.has_child(name)) return strings;
+
+	// Collecting the string elements of the array
+	for(const Node* element = parameters[name].first_child(); element != nullptr; element = element->next_sibling()) {
+		std::size_t size = 0;
+		const char* data = element->string_data(&size);
+		if(data != nullptr) strings.emplace_back(data, size);
+	}
+
+	return strings;
+}
+
+std::vector<double> ComponentRegistry::getNumbers(const Node& parameters, const std::string& name)
+{
+	std::vector<double> numbers;
+
+	// Checking if the parameter is set
+	if(!parameters.has_child(name)) return numbers;
+
+	// Collecting the numeric elements of the array
+	for(const Node* element = parameters[name].first_child(); element != nullptr; element = element->next_sibling()) {
+		double value = 0;
+		if(element->get_number(value)) numbers.push_back(value);
+	}
+
+	return numbers;
+}
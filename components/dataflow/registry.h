@@ -0,0 +1,145 @@
+#pragma once
+#ifndef DATAFLOW_REGISTRY_H_INCLUDED
+#define DATAFLOW_REGISTRY_H_INCLUDED
+
+// Standard includes
+#include <map>
+#include <string>
+#include <vector>
+#include <functional>
+#include <type_traits>
+
+// Project includes
+#include "dataflow.h"
+
+
+/**
+ * The ComponentRegistry class maps component type names to factories, which
+ * construct component instances from a Node of parameters. It is used by the
+ * GraphLoader to instantiate the components of a declaratively described graph.
+ * Numeric parameters are stored as double, string parameters as std::string and
+ * boolean parameters as bool, the static helper functions can be used to read
+ * them with default values inside the factories.
+ */
+class ComponentRegistry {
+public:
+
+	/**
+	 * Function signature of the factories creating components from parameters.
+	 */
+	using Factory = std::function<Component*(const Node&)>;
+
+	/**
+	 * Registers a factory for the specified component type name. The concrete type
+	 * is used when adding the created components to a Dataflow, so cooperative
+	 * components are assigned to executors as if they were added by hand.
+	 * @param  type    [in] The unique name of the component type.
+	 * @param  factory [in] Callable taking the parameters and returning a new Type*.
+	 * @return True when the factory is registered, false when the name is taken.
+	 */
+	template <class Type, class Callable>
+	bool add(const std::string& type, Callable&& factory)
+	{
+		// Checking if a factory already exists with the same name
+		if(m_entries.count(type) != 0) return false;
+
+		// Storing the factory along with the type-aware installer
+		typename std::decay<Callable>::type callable(std::forward<Callable>(factory));
+		m_entries[type] = Entry{ [callable](const Node& parameters) -> Component* {
+			return callable(parameters);
+		}, &installFunction<Type> };
+
+		return true;
+	}
+
+	/**
+	 * Queries whether a factory is registered for the specified type name.
+	 * @param  type [in] The name of the component type.
+	 * @return True when the type is registered.
+	 */
+	bool contains(const std::string& type) const noexcept;
+
+	/**
+	 * Creates a new component of the specified type from the parameters.
+	 * @param  type       [in] The name of the component type.
+	 * @param  parameters [in] The parameters passed to the factory.
+	 * @return Pointer to the new component, or nullptr on failure.
+	 */
+	Component* create(const std::string& type, const Node& parameters) const;
+
+	/**
+	 * Adds a component created by this registry to the specified Dataflow.
+	 * @param type      [in] The name of the type the component was created with.
+	 * @param component [in] Pointer to the component to add.
+	 * @param flow      [in] The Dataflow to add the component to.
+	 */
+	void install(const std::string& type, Component* component, Dataflow& flow) const;
+
+	/**
+	 * Reads a numeric parameter, or returns the default value when it is not set.
+	 * @param  parameters   [in] The parameters to read from.
+	 * @param  name         [in] The name of the parameter.
+	 * @param  defaultValue [in] The value returned when the parameter is not set.
+	 * @return The value of the parameter.
+	 */
+	static double getNumber(const Node& parameters, const std::string& name, double defaultValue = 0);
+
+	/**
+	 * Reads a string parameter, or returns the default value when it is not set.
+	 * @param  parameters   [in] The parameters to read from.
+	 * @param  name         [in] The name of the parameter.
+	 * @param  defaultValue [in] The value returned when the parameter is not set.
+	 * @return The value of the parameter.
+	 */
+	static std::string getString(const Node& parameters, const std::string& name, const std::string& defaultValue = "");
+
+	/**
+	 * Reads a boolean parameter, or returns the default value when it is not set.
+	 * @param  parameters   [in] The parameters to read from.
+	 * @param  name         [in] The name of the parameter.
+	 * @param  defaultValue [in] The value returned when the parameter is not set.
+	 * @return The value of the parameter.
+	 */
+	static bool getBool(const Node& parameters, const std::string& name, bool defaultValue = false);
+
+	/**
+	 * Reads a parameter holding an array of strings, eg. a list of field names.
+	 * @param  parameters [in] The parameters to read from.
+	 * @param  name       [in] The name of the parameter.
+	 * @return The strings of the array, elements of other types are skipped.
+	 */
+	static std::vector<std::string> getStrings(const Node& parameters, const std::string& name);
+
+	/**
+	 * Reads a parameter holding an array of numbers, eg. filter coefficients.
+	 * @param  parameters [in] The parameters to read from.
+	 * @param  name       [in] The name of the parameter.
+	 * @return The numbers of the array, elements of other types are skipped.
+	 */
+	static std::vector<double> getNumbers(const Node& parameters, const std::string& name);
+
+private:
+
+	/**
+	 * Adds a component to the Dataflow with its concrete type.
+	 * @param component [in] Pointer to the component to add.
+	 * @param flow      [in] The Dataflow to add the component to.
+	 */
+	template <class Type>
+	static void installFunction(Component* component, Dataflow& flow)
+	{
+		flow.addComponent(static_cast<Type*>(component));
+	}
+
+	/**
+	 * The Entry structure stores the factory and installer of a type.
+	 */
+	struct Entry {
+		Factory m_factory;                         /**< The factory creating the components. */
+		void  (*m_install)(Component*, Dataflow&); /**< Adds the components to a Dataflow.  */
+	};
+
+	std::map<std::string, Entry> m_entries; /**< The registered component types. */
+};
+
+#endif // DATAFLOW_REGISTRY_H_INCLUDED
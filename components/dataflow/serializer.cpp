@@ -0,0 +1,299 @@
+#include "serializer.h"
+
+// Standard includes
+#include <string>
+
+/**
+ * Defines the type tags of the built-in payload types.
+ */
+enum BuiltinTag : uint8_t {
+	TAG_NONE, TAG_FALSE, TAG_TRUE, TAG_INT, TAG_UINT, TAG_LONG, TAG_ULONG, TAG_INT8, TAG_UINT8,
+	TAG_INT16, TAG_UINT16, TAG_INT64, TAG_UINT64, TAG_FLOAT, TAG_DOUBLE, TAG_STRING, TAG_BLOB
+};
+
+/**
+ * Maps signed integers to unsigned ones, so small negative values have short varints.
+ * @param  value [in] The signed value to map.
+ * @return The zigzag encoded value.
+ */
+static uint64_t zigzag(int64_t value) noexcept
+{
+	return ((uint64_t) value << 1) ^ (uint64_t) (value >> 63);
+}
+
+/**
+ * Maps zigzag encoded values back to signed integers.
+ * @param  value [in] The zigzag encoded value.
+ * @return The signed value.
+ */
+static int64_t unzigzag(uint64_t value) noexcept
+{
+	return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+}
+
+// NodeSerializer::Writer
+
+void NodeSerializer::Writer::byte(uint8_t value) noexcept
+{
+	bytes(&value, 1);
+}
+
+void NodeSerializer::Writer::varint(uint64_t value) noexcept
+{
+	// Writing 7 bits at a time, the highest bit indicates continuation
+	while(value >= 0x80) {
+		byte((value & 0x7F) | 0x80);
+		value >>= 7;
+	}
+
+	byte(value);
+}
+
+void NodeSerializer::Writer::bytes(const void* data, std::size_t size) noexcept
+{
+	// Writing into the buffer when it has enough space, otherwise only counting
+	if(m_buffer != nullptr && m_offset + size <= m_size) memcpy(m_buffer + m_offset, data, size);
+	else if(m_buffer != nullptr) m_overflow = true;
+
+	m_offset += size;
+}
+
+// NodeSerializer::Reader
+
+bool NodeSerializer::Reader::byte(uint8_t& value) noexcept
+{
+	return bytes(&value, 1);
+}
+
+bool NodeSerializer::Reader::varint(uint64_t& value) noexcept
+{
+	value = 0;
+
+	// Reading 7 bits at a time until the continuation bit is cleared
+	for(std::size_t shift = 0; shift < 64; shift += 7) {
+		uint8_t data = 0;
+		if(!byte(data)) return false;
+
+		value |= (uint64_t) (data & 0x7F) << shift;
+		if((data & 0x80) == 0) return true;
+	}
+
+	return false;
+}
+
+bool NodeSerializer::Reader::bytes(void* data, std::size_t size) noexcept
+{
+	if(size > m_size - m_offset) return false;
+
+	memcpy(data, m_buffer + m_offset, size);
+	m_offset += size;
+
+	return true;
+}
+
+// NodeSerializer
+
+std::size_t NodeSerializer::serialize(const Node& node, uint8_t* buffer, std::size_t size)
+{
+	// Checking the buffer
+	if(buffer == nullptr) return 0;
+
+	Writer writer{ buffer, size, 0, false, false };
+	encode(node, writer, 0);
+
+	return (writer.m_overflow || writer.m_tooDeep) ? 0 : writer.m_offset;
+}
+
+std::size_t NodeSerializer::serializedSize(const Node& node)
+{
+	// Encoding without a buffer only counts the bytes
+	Writer writer{ nullptr, 0, 0, false, false };
+	encode(node, writer, 0);
+
+	return writer.m_tooDeep ? 0 : writer.m_offset;
+}
+
+std::size_t NodeSerializer::deserialize(const uint8_t* buffer, std::size_t size, Node& node)
+{
+	// Checking the buffer
+	if(buffer == nullptr) return 0;
+
+	Reader reader{ buffer, size, 0 };
+	node.clear();
+
+	if(!decode(reader, node, 0)) {
+		node.clear();
+		return 0;
+	}
+
+	return reader.m_offset;
+}
+
+std::vector<NodeSerializer::Codec>& NodeSerializer::codecs()
+{
+	// Helpers for the integer types encoded as varints
+	#define SIGNED_CODEC(TAG, TYPE)                                                                 \
+		Codec{ TAG, &matchFunction<TYPE>,                                                           \
+			[](const any& value, Writer& writer) { writer.varint(zigzag(*value.get<TYPE>())); },    \
+			[](Reader& reader, Node& node) {                                                        \
+				uint64_t data = 0; if(!reader.varint(data)) return false;                           \
+				node = (TYPE) unzigzag(data); return true; } }
+
+	#define UNSIGNED_CODEC(TAG, TYPE)                                                               \
+		Codec{ TAG, &matchFunction<TYPE>,                                                           \
+			[](const any& value, Writer& writer) { writer.varint(*value.get<TYPE>()); },            \
+			[](Reader& reader, Node& node) {                                                        \
+				uint64_t data = 0; if(!reader.varint(data)) return false;                           \
+				node = (TYPE) data; return true; } }
+
+	// The built-in payload types, in the order of matching
+	static std::vector<Codec> s_codecs = {
+		Codec{ TAG_FALSE, &matchFunction<bool>,
+			[](const any& value, Writer& writer) { (void)(value); (void)(writer); },
+			[](Reader& reader, Node& node) { (void)(reader); node = false; return true; } },
+		Codec{ TAG_TRUE, &matchFunction<bool>,
+			[](const any& value, Writer& writer) { (void)(value); (void)(writer); },
+			[](Reader& reader, Node& node) { (void)(reader); node = true; return true; } },
+		SIGNED_CODEC(TAG_INT, int),
+		UNSIGNED_CODEC(TAG_UINT, unsigned),
+		SIGNED_CODEC(TAG_LONG, long),
+		UNSIGNED_CODEC(TAG_ULONG, unsigned long),
+		SIGNED_CODEC(TAG_INT8, int8_t),
+		UNSIGNED_CODEC(TAG_UINT8, uint8_t),
+		SIGNED_CODEC(TAG_INT16, int16_t),
+		UNSIGNED_CODEC(TAG_UINT16, uint16_t),
+		SIGNED_CODEC(TAG_INT64, int64_t),
+		UNSIGNED_CODEC(TAG_UINT64, uint64_t),
+		Codec{ TAG_FLOAT, &matchFunction<float>, &encodeFloatFunction<float, uint32_t>, &decodeFloatFunction<float, uint32_t> },
+		Codec{ TAG_DOUBLE, &matchFunction<double>, &encodeFloatFunction<double, uint64_t>, &decodeFloatFunction<double, uint64_t> },
+		Codec{ TAG_STRING, [](const any& value) { return value.string_data() != nullptr; },
+			[](const any& value, Writer& writer) {
+				std::size_t size = 0;
+				const char* data = value.string_data(&size);
+				writer.varint(size);
+				writer.bytes(data, size);
+			},
+			[](Reader& reader, Node& node) {
+				uint64_t length = 0;
+				if(!reader.varint(length) || length > reader.m_size - reader.m_offset) return false;
+				node = SmallString(reinterpret_cast<const char*>(reader.m_buffer + reader.m_offset), length);
+				reader.m_offset += length;
+				return true;
+			} },
+		Codec{ TAG_BLOB, &matchFunction<Blob>,
+			[](const any& value, Writer& writer) {
+				const Blob* data = value.get<Blob>();
+				writer.varint(data->size());
+				writer.bytes(data->data(), data->size());
+			},
+			[](Reader& reader, Node& node) {
+				uint64_t length = 0;
+				if(!reader.varint(length) || length > reader.m_size - reader.m_offset) return false;
+				node = Blob(reader.m_buffer + reader.m_offset, reader.m_buffer + reader.m_offset + length);
+				reader.m_offset += length;
+				return true;
+			} }
+	};
+
+	#undef SIGNED_CODEC
+	#undef UNSIGNED_CODEC
+
+	return s_codecs;
+}
+
+const NodeSerializer::Codec* NodeSerializer::find(uint8_t tag)
+{
+	for(const Codec& codec : codecs()) {
+		if(codec.m_tag == tag) return &codec;
+	}
+
+	return nullptr;
+}
+
+void NodeSerializer::encode(const Node& node, Writer& writer, std::size_t depth)
+{
+	// Refusing to encode data the decoder would reject
+	if(depth > MAX_DEPTH) {
+		writer.m_tooDeep = true;
+		return;
+	}
+
+	// Searching for the codec of the value, booleans select the tag by their value
+	uint8_t tag = TAG_NONE;
+	const Codec* codec = nullptr;
+
+	if(node.get<bool>() != nullptr) {
+		tag = *node.get<bool>() ? TAG_TRUE : TAG_FALSE;
+	}
+	else if(node.has_value()) {
+		for(const Codec& candidate : codecs()) {
+			if(candidate.m_match(node)) {
+				codec = &candidate;
+				tag = candidate.m_tag;
+				break;
+			}
+		}
+	}
+
+	// Writing the header, the name and the value
+	uint8_t header = tag;
+	if(!node.m_name.empty())      header |= HAS_NAME;
+	if(node.first_child() != nullptr) header |= HAS_CHILDREN;
+	writer.byte(header);
+
+	if(header & HAS_NAME) {
+		writer.varint(node.m_name.size());
+		writer.bytes(node.m_name.data(), node.m_name.size());
+	}
+
+	if(codec != nullptr) codec->m_encode(node, writer);
+
+	// Writing the children
+	if(header & HAS_CHILDREN) {
+		writer.varint(node.child_count());
+		for(const Node* child = node.first_child(); child != nullptr; child = child->next_sibling()) encode(*child, writer, depth + 1);
+	}
+}
+
+bool NodeSerializer::decode(Reader& reader, Node& node, std::size_t depth)
+{
+	// Limiting the nesting depth of the decoded data
+	if(depth > MAX_DEPTH) return false;
+
+	// Reading the header
+	uint8_t header = 0;
+	if(!reader.byte(header)) return false;
+
+	// Reading the name
+	if(header & HAS_NAME) {
+		uint64_t length = 0;
+		if(!reader.varint(length) || length > reader.m_size - reader.m_offset) return false;
+
+		node.m_name.assign(reinterpret_cast<const char*>(reader.m_buffer + reader.m_offset), length);
+		reader.m_offset += length;
+	}
+
+	// Reading the value
+	uint8_t tag = header & TAG_MASK;
+	if(tag != TAG_NONE) {
+		const Codec* codec = find(tag);
+		if(codec == nullptr || !codec->m_decode(reader, node)) return false;
+	}
+
+	// Reading the children, appending them after each other
+	if(header & HAS_CHILDREN) {
+		uint64_t count = 0;
+		if(!reader.varint(count)) return false;
+
+		node.own();
+		for(uint64_t i = 0; i < count; i++) {
+
+			// Every child takes at least one byte, rejecting impossible counts early
+			if(reader.m_offset >= reader.m_size) return false;
+
+			if(!decode(reader, node.append(new Node(&node)), depth + 1)) return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,225 @@
+#pragma once
+#ifndef DATAFLOW_SERIALIZER_H_INCLUDED
+#define DATAFLOW_SERIALIZER_H_INCLUDED
+
+// Standard includes
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+// Project includes
+#include "node.hpp"
+
+
+/**
+ * The NodeSerializer class implements a compact binary encoding of Node trees,
+ * used for persisting messages, sending them over a network or storing them in
+ * snapshots. Encoding is streamed directly into a caller-provided buffer without
+ * intermediate allocations, decoding builds the Node tree from a buffer.
+ *
+ * Every Node is encoded as a header byte, holding the type tag of the value and
+ * flags for the presence of a name and children, followed by the name (varint
+ * length and bytes), the value and the children (varint count and Nodes). Integers
+ * are encoded as (zigzag) varints like in MessagePack/CBOR, floating-point values
+ * as little-endian IEEE-754 (on any host), strings and blobs as varint length and
+ * bytes. Trees nested deeper than 32 levels are neither encoded nor decoded.
+ *
+ * The types bool, int, unsigned int, long, unsigned long, int8_t, uint8_t, int16_t,
+ * uint16_t, int64_t, uint64_t, float, double, the string types (std::string, SmallString
+ * and SharedString, decoded as SmallString) and Blob are supported
+ * out of the box, further trivially copyable types can be registered. Values of
+ * unknown types (eg. pointers) are encoded as empty Nodes.
+ */
+class NodeSerializer {
+public:
+
+	/**
+	 * Payload type for storing arbitrary binary data in Nodes.
+	 */
+	using Blob = std::vector<uint8_t>;
+
+	/**
+	 * The first type tag available for registered types (tags up to 63).
+	 */
+	static const uint8_t USER_TAG = 32;
+
+	/**
+	 * Encodes the Node tree into the buffer.
+	 * @param  node   [in]  The Node to encode.
+	 * @param  buffer [out] The buffer to write the encoded Node into.
+	 * @param  size   [in]  The size of the buffer in bytes.
+	 * @return The number of bytes written, zero when the buffer is too small or the
+	 *         Node is nested too deep.
+	 */
+	static std::size_t serialize(const Node& node, uint8_t* buffer, std::size_t size);
+
+	/**
+	 * Calculates the size of the encoded Node tree, eg. for allocating the buffer.
+	 * @param  node [in] The Node to calculate the encoded size of.
+	 * @return The number of bytes required for encoding the Node, zero when it is
+	 *         nested too deep to be encoded.
+	 */
+	static std::size_t serializedSize(const Node& node);
+
+	/**
+	 * Decodes a Node tree from the buffer.
+	 * @param  buffer [in]  The buffer containing the encoded Node.
+	 * @param  size   [in]  The size of the buffer in bytes.
+	 * @param  node   [out] The Node to decode into, its previous content is cleared.
+	 * @return The number of bytes consumed, zero when the encoding is invalid.
+	 */
+	static std::size_t deserialize(const uint8_t* buffer, std::size_t size, Node& node);
+
+	/**
+	 * Registers a trivially copyable type with the specified type tag, so values
+	 * of the type are encoded as raw bytes. Types should be registered before the
+	 * flow is started, with the same tags on the encoding and decoding sides.
+	 * @param  tag [in] The type tag to use, from USER_TAG up to 63.
+	 * @return True when the type is registered, false when the tag is taken.
+	 */
+	template <class Type>
+	static bool registerType(uint8_t tag)
+	{
+		static_assert(std::is_trivially_copyable<Type>::value, "Only trivially copyable types can be registered.");
+
+		// Checking if the tag is valid and available
+		if(tag < USER_TAG || tag > TAG_MASK || find(tag) != nullptr) return false;
+
+		codecs().push_back(Codec{ tag, &matchFunction<Type>, &encodeFunction<Type>, &decodeFunction<Type> });
+		return true;
+	}
+
+private:
+
+	/**
+	 * The Writer structure streams encoded data into a buffer, or only counts
+	 * the number of bytes when no buffer is specified.
+	 */
+	struct Writer {
+		uint8_t*    m_buffer;   /**< The buffer to write into, or nullptr for counting. */
+		std::size_t m_size;     /**< The size of the buffer.                            */
+		std::size_t m_offset;   /**< The number of bytes written.                       */
+		bool        m_overflow; /**< Indicates that the buffer is too small.            */
+		bool        m_tooDeep;  /**< Indicates that the Node is nested too deep.        */
+
+		void byte(uint8_t value) noexcept;
+		void varint(uint64_t value) noexcept;
+		void bytes(const void* data, std::size_t size) noexcept;
+	};
+
+	/**
+	 * The Reader structure reads encoded data from a buffer with bounds checks.
+	 */
+	struct Reader {
+		const uint8_t* m_buffer; /**< The buffer to read from.     */
+		std::size_t    m_size;   /**< The size of the buffer.      */
+		std::size_t    m_offset; /**< The number of bytes read.    */
+
+		bool byte(uint8_t& value) noexcept;
+		bool varint(uint64_t& value) noexcept;
+		bool bytes(void* data, std::size_t size) noexcept;
+	};
+
+	/**
+	 * The Codec structure describes the encoding of a payload type.
+	 */
+	struct Codec {
+		uint8_t m_tag;                          /**< The type tag of the encoded values.      */
+		bool  (*m_match)(const any&);           /**< Checks whether a value has this type.    */
+		void  (*m_encode)(const any&, Writer&); /**< Encodes the value without the tag.       */
+		bool  (*m_decode)(Reader&, Node&);      /**< Decodes the value into the Node.         */
+	};
+
+	// Header byte layout: type tag and flags
+	static const uint8_t TAG_MASK     = 0x3F;
+	static const uint8_t HAS_NAME     = 0x40;
+	static const uint8_t HAS_CHILDREN = 0x80;
+
+	// Maximum nesting depth accepted by the encoder and the decoder
+	static const std::size_t MAX_DEPTH = 32;
+
+	template <class Type>
+	static bool matchFunction(const any& value)
+	{
+		return value.get<Type>() != nullptr;
+	}
+
+	template <class Type>
+	static void encodeFunction(const any& value, Writer& writer)
+	{
+		writer.bytes(value.get<Type>(), sizeof(Type));
+	}
+
+	template <class Type>
+	static bool decodeFunction(Reader& reader, Node& node)
+	{
+		Type value;
+		if(!reader.bytes(&value, sizeof(Type))) return false;
+
+		node = value;
+		return true;
+	}
+
+	template <class Type, class Bits>
+	static void encodeFloatFunction(const any& value, Writer& writer)
+	{
+		static_assert(sizeof(Type) == sizeof(Bits), "The bits must have the size of the floating-point type.");
+
+		// Writing the bits of the value in little-endian order, independently of the host
+		Bits bits;
+		memcpy(&bits, value.get<Type>(), sizeof(bits));
+		for(std::size_t i = 0; i < sizeof(bits); i++) writer.byte((bits >> (8 * i)) & 0xFF);
+	}
+
+	template <class Type, class Bits>
+	static bool decodeFloatFunction(Reader& reader, Node& node)
+	{
+		// Assembling the bits of the value from little-endian order
+		Bits bits = 0;
+		for(std::size_t i = 0; i < sizeof(bits); i++) {
+			uint8_t data = 0;
+			if(!reader.byte(data)) return false;
+			bits |= (Bits) data << (8 * i);
+		}
+
+		Type value;
+		memcpy(&value, &bits, sizeof(value));
+
+		node = value;
+		return true;
+	}
+
+	/**
+	 * Queries the list of the supported payload types.
+	 * @return Reference to the list of codecs.
+	 */
+	static std::vector<Codec>& codecs();
+
+	/**
+	 * Searches for the codec of the specified type tag.
+	 * @param  tag [in] The type tag to search for.
+	 * @return Pointer to the codec, or nullptr when the tag is unknown.
+	 */
+	static const Codec* find(uint8_t tag);
+
+	/**
+	 * Encodes the Node and its children with the writer.
+	 * @param node   [in] The Node to encode.
+	 * @param writer [in] The writer to encode with.
+	 * @param depth  [in] The nesting depth of the Node.
+	 */
+	static void encode(const Node& node, Writer& writer, std::size_t depth);
+
+	/**
+	 * Decodes a Node and its children with the reader.
+	 * @param  reader [in]  The reader to decode with.
+	 * @param  node   [out] The Node to decode into.
+	 * @param  depth  [in]  The nesting depth of the Node.
+	 * @return True when the Node is decoded successfully.
+	 */
+	static bool decode(Reader& reader, Node& node, std::size_t depth);
+};
+
+#endif // DATAFLOW_SERIALIZER_H_INCLUDED
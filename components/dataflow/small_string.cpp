@@ -0,0 +1,250 @@
+#include "small_string.hpp"
+
+// Standard includes
+#include <new>
+#include <atomic>
+#include <cstring>
+
+// Project includes
+#include "heap.h"
+
+// SharedString
+
+struct SharedString::Block {
+    std::atomic<std::size_t> m_references; /**< The number of SharedStrings sharing the block. */
+    std::size_t              m_size;       /**< The number of characters.                       */
+    char                     m_data[1];    /**< The null-terminated characters (over-allocated). */
+};
+
+SharedString::SharedString() noexcept : m_block(nullptr) {}
+
+SharedString::SharedString(const char* data, std::size_t size) : m_block(nullptr)
+{
+    // Empty strings are not allocated
+    if(size == 0) return;
+
+    // Allocating the block with room for the characters and the terminating zero
+    void* memory = Allocator::allocate(sizeof(Block) + size);
+    m_block = static_cast<Block*>(memory);
+
+    new (&m_block->m_references) std::atomic<std::size_t>(1);
+    m_block->m_size = size;
+    memcpy(m_block->m_data, data, size);
+    m_block->m_data[size] = '\0';
+}
+
+SharedString::SharedString(const char* string) : SharedString(string, strlen(string)) {}
+
+SharedString::SharedString(const std::string& string) : SharedString(string.data(), string.size()) {}
+
+SharedString::SharedString(const SharedString& other) noexcept : m_block(other.m_block)
+{
+    if(m_block) m_block->m_references++;
+}
+
+SharedString::SharedString(SharedString&& other) noexcept : m_block(other.m_block)
+{
+    other.m_block = nullptr;
+}
+
+SharedString& SharedString::operator=(const SharedString& other) noexcept
+{
+    // Acquiring the new block before releasing the old one handles self-assignment
+    if(other.m_block) other.m_block->m_references++;
+
+    this->~SharedString();
+    m_block = other.m_block;
+
+    return *this;
+}
+
+SharedString& SharedString::operator=(SharedString&& other) noexcept
+{
+    // Checking self-assignment
+    if(this == &other) return *this;
+
+    this->~SharedString();
+    m_block = other.m_block;
+    other.m_block = nullptr;
+
+    return *this;
+}
+
+SharedString::~SharedString()
+{
+    // Deleting the block with the last reference
+    if(m_block && --m_block->m_references == 0) {
+        Allocator::deallocate(m_block);
+    }
+
+    m_block = nullptr;
+}
+
+const char* SharedString::data() const noexcept
+{
+    return m_block ? m_block->m_data : "";
+}
+
+const char* SharedString::c_str() const noexcept
+{
+    return data();
+}
+
+std::size_t SharedString::size() const noexcept
+{
+    return m_block ? m_block->m_size : 0;
+}
+
+bool SharedString::empty() const noexcept
+{
+    return size() == 0;
+}
+
+std::string SharedString::str() const
+{
+    return std::string(data(), size());
+}
+
+bool SharedString::operator==(const SharedString& other) const noexcept
+{
+    // Strings sharing the same block are equal without comparing the characters
+    if(m_block == other.m_block) return true;
+
+    return size() == other.size() && memcmp(data(), other.data(), size()) == 0;
+}
+
+bool SharedString::operator!=(const SharedString& other) const noexcept
+{
+    return !(*this == other);
+}
+
+// SmallString
+
+SmallString::SmallString() noexcept
+{
+    m_chars[0] = '\0';
+    m_chars[SIZE - 1] = CAPACITY;
+}
+
+SmallString::SmallString(const char* data, std::size_t size)
+{
+    // Storing long strings as shared strings
+    if(size > CAPACITY) {
+        new (&m_shared) SharedString(data, size);
+        m_chars[SIZE - 1] = SHARED;
+        return;
+    }
+
+    // Storing short strings inline, the last byte is the unused capacity
+    memcpy(m_chars, data, size);
+    m_chars[size] = '\0';
+    m_chars[SIZE - 1] = CAPACITY - size;
+}
+
+SmallString::SmallString(const char* string) : SmallString(string, strlen(string)) {}
+
+SmallString::SmallString(const std::string& string) : SmallString(string.data(), string.size()) {}
+
+SmallString::SmallString(const SmallString& other) noexcept
+{
+    // Sharing the characters of long strings, copying short ones
+    if(!other.is_inline()) {
+        new (&m_shared) SharedString(other.m_shared);
+        m_chars[SIZE - 1] = SHARED;
+    }
+    else memcpy(m_chars, other.m_chars, SIZE);
+}
+
+SmallString::SmallString(SmallString&& other) noexcept
+{
+    // Taking the characters of long strings, copying short ones
+    if(!other.is_inline()) {
+        new (&m_shared) SharedString(std::move(other.m_shared));
+        m_chars[SIZE - 1] = SHARED;
+
+        other.m_shared.~SharedString();
+        other.m_chars[0] = '\0';
+        other.m_chars[SIZE - 1] = CAPACITY;
+    }
+    else memcpy(m_chars, other.m_chars, SIZE);
+}
+
+SmallString& SmallString::operator=(const SmallString& other) noexcept
+{
+    // Checking self-assignment
+    if(this == &other) return *this;
+
+    this->~SmallString();
+    new (this) SmallString(other);
+
+    return *this;
+}
+
+SmallString& SmallString::operator=(SmallString&& other) noexcept
+{
+    // Checking self-assignment
+    if(this == &other) return *this;
+
+    this->~SmallString();
+    new (this) SmallString(std::move(other));
+
+    return *this;
+}
+
+SmallString::~SmallString()
+{
+    if(!is_inline()) m_shared.~SharedString();
+}
+
+const char* SmallString::data() const noexcept
+{
+    return is_inline() ? m_chars : m_shared.data();
+}
+
+const char* SmallString::c_str() const noexcept
+{
+    return data();
+}
+
+std::size_t SmallString::size() const noexcept
+{
+    return is_inline() ? CAPACITY - static_cast<uint8_t>(m_chars[SIZE - 1]) : m_shared.size();
+}
+
+bool SmallString::empty() const noexcept
+{
+    return size() == 0;
+}
+
+bool SmallString::is_inline() const noexcept
+{
+    return static_cast<uint8_t>(m_chars[SIZE - 1]) != SHARED;
+}
+
+std::string SmallString::str() const
+{
+    return std::string(data(), size());
+}
+
+bool SmallString::operator==(const SmallString& other) const noexcept
+{
+    std::size_t length = size();
+    return length == other.size() && memcmp(data(), other.data(), length) == 0;
+}
+
+bool SmallString::operator!=(const SmallString& other) const noexcept
+{
+    return !(*this == other);
+}
+
+// Printing
+
+std::ostream& operator<<(std::ostream& stream, const SharedString& string)
+{
+    return stream.write(string.data(), string.size());
+}
+
+std::ostream& operator<<(std::ostream& stream, const SmallString& string)
+{
+    return stream.write(string.data(), string.size());
+}
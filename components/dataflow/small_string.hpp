@@ -0,0 +1,290 @@
+#pragma once
+#ifndef DATAFLOW_SMALL_STRING_HPP_INCLUDED
+#define DATAFLOW_SMALL_STRING_HPP_INCLUDED
+
+// Standard includes
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+// Size of SmallString objects, which also determines the inline storage of any
+// objects, strings shorter than this are stored without allocation
+#ifndef DATAFLOW_SMALL_STRING_SIZE
+#define DATAFLOW_SMALL_STRING_SIZE (16)
+#endif
+
+
+/**
+ * @brief The SharedString class implements an immutable, reference-counted string.
+ *        Copies share the same characters, so copying takes constant time and
+ *        no allocation, regardless of the length. This is used for large bodies
+ *        passed between components (eg. the forecast JSON text). The string
+ *        object is pointer-sized, so any objects store it without allocation.
+ */
+class SharedString {
+public:
+
+    /**
+     * @brief Constructs an empty SharedString.
+     */
+    SharedString() noexcept;
+
+    /**
+     * @brief Constructs a SharedString by copying the specified characters.
+     * @param data [in] Pointer to the characters.
+     * @param size [in] The number of characters.
+     */
+    SharedString(const char* data, std::size_t size);
+
+    /**
+     * @brief Constructs a SharedString by copying a C-string.
+     * @param string [in] The null-terminated string to copy.
+     */
+    SharedString(const char* string);
+
+    /**
+     * @brief Constructs a SharedString by copying an std::string.
+     * @param string [in] The string to copy.
+     */
+    SharedString(const std::string& string);
+
+    /**
+     * @brief Constructs a SharedString sharing the characters of another one.
+     * @param other [in] The other SharedString to share.
+     */
+    SharedString(const SharedString& other) noexcept;
+
+    /**
+     * @brief Constructs a SharedString by moving from another one.
+     * @param other [in] The other SharedString to move from, left empty.
+     */
+    SharedString(SharedString&& other) noexcept;
+
+    /**
+     * @brief  Assigns this SharedString to share the characters of another one.
+     * @param  other [in] The other SharedString to share.
+     * @return Reference to this object after the assignment.
+     */
+    SharedString& operator=(const SharedString& other) noexcept;
+
+    /**
+     * @brief  Moves another SharedString into this one.
+     * @param  other [in] The other SharedString to move from, left empty.
+     * @return Reference to this object after the assignment.
+     */
+    SharedString& operator=(SharedString&& other) noexcept;
+
+    /**
+     * @brief Destroys the SharedString, deleting the characters with the last reference.
+     */
+    ~SharedString();
+
+    /**
+     * @brief  Queries the characters of the string.
+     * @return Pointer to the null-terminated characters.
+     */
+    const char* data() const noexcept;
+
+    /**
+     * @brief  Queries the characters of the string.
+     * @return Pointer to the null-terminated characters.
+     */
+    const char* c_str() const noexcept;
+
+    /**
+     * @brief  Queries the length of the string.
+     * @return The number of characters.
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * @brief  Queries whether the string is empty.
+     * @return True when the string has no characters.
+     */
+    bool empty() const noexcept;
+
+    /**
+     * @brief  Copies the characters into an std::string.
+     * @return The std::string copy of the string.
+     */
+    std::string str() const;
+
+    /**
+     * @brief  Compares the characters of the strings.
+     * @param  other [in] The other string to compare to.
+     * @return True when the strings are equal.
+     */
+    bool operator==(const SharedString& other) const noexcept;
+
+    /**
+     * @brief  Compares the characters of the strings.
+     * @param  other [in] The other string to compare to.
+     * @return True when the strings are not equal.
+     */
+    bool operator!=(const SharedString& other) const noexcept;
+
+private:
+
+    // Forward declaration of the shared characters
+    struct Block;
+
+    Block* m_block; /**< Pointer to the shared characters, nullptr when empty. */
+};
+
+/**
+ * @brief The SmallString class implements a string with Small-String-Optimalization
+ *        sized for the short strings typical in messages (eg. units, field values
+ *        and flags). Strings up to CAPACITY characters are stored in the object
+ *        itself, longer ones are stored as a SharedString. SmallString objects fit
+ *        the inline storage of any objects, so short strings are never allocated.
+ */
+class SmallString {
+public:
+
+    /**
+     * The size of SmallString objects in bytes.
+     */
+    static const std::size_t SIZE = DATAFLOW_SMALL_STRING_SIZE;
+
+    /**
+     * The maximum number of characters stored without allocation.
+     */
+    static const std::size_t CAPACITY = SIZE - 1;
+
+    /**
+     * @brief Constructs an empty SmallString.
+     */
+    SmallString() noexcept;
+
+    /**
+     * @brief Constructs a SmallString by copying the specified characters.
+     * @param data [in] Pointer to the characters.
+     * @param size [in] The number of characters.
+     */
+    SmallString(const char* data, std::size_t size);
+
+    /**
+     * @brief Constructs a SmallString by copying a C-string.
+     * @param string [in] The null-terminated string to copy.
+     */
+    SmallString(const char* string);
+
+    /**
+     * @brief Constructs a SmallString by copying an std::string.
+     * @param string [in] The string to copy.
+     */
+    SmallString(const std::string& string);
+
+    /**
+     * @brief Constructs a SmallString by copying another one (long strings are shared).
+     * @param other [in] The other SmallString to copy.
+     */
+    SmallString(const SmallString& other) noexcept;
+
+    /**
+     * @brief Constructs a SmallString by moving from another one.
+     * @param other [in] The other SmallString to move from, left empty.
+     */
+    SmallString(SmallString&& other) noexcept;
+
+    /**
+     * @brief  Copy assigns this SmallString from another one (long strings are shared).
+     * @param  other [in] The other SmallString to copy.
+     * @return Reference to this object after the assignment.
+     */
+    SmallString& operator=(const SmallString& other) noexcept;
+
+    /**
+     * @brief  Moves another SmallString into this one.
+     * @param  other [in] The other SmallString to move from, left empty.
+     * @return Reference to this object after the assignment.
+     */
+    SmallString& operator=(SmallString&& other) noexcept;
+
+    /**
+     * @brief Destroys the SmallString, releasing the characters of long strings.
+     */
+    ~SmallString();
+
+    /**
+     * @brief  Queries the characters of the string.
+     * @return Pointer to the null-terminated characters.
+     */
+    const char* data() const noexcept;
+
+    /**
+     * @brief  Queries the characters of the string.
+     * @return Pointer to the null-terminated characters.
+     */
+    const char* c_str() const noexcept;
+
+    /**
+     * @brief  Queries the length of the string.
+     * @return The number of characters.
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * @brief  Queries whether the string is empty.
+     * @return True when the string has no characters.
+     */
+    bool empty() const noexcept;
+
+    /**
+     * @brief  Queries whether the characters are stored in the object itself.
+     * @return True for strings up to CAPACITY characters.
+     */
+    bool is_inline() const noexcept;
+
+    /**
+     * @brief  Copies the characters into an std::string.
+     * @return The std::string copy of the string.
+     */
+    std::string str() const;
+
+    /**
+     * @brief  Compares the characters of the strings.
+     * @param  other [in] The other string to compare to.
+     * @return True when the strings are equal.
+     */
+    bool operator==(const SmallString& other) const noexcept;
+
+    /**
+     * @brief  Compares the characters of the strings.
+     * @param  other [in] The other string to compare to.
+     * @return True when the strings are not equal.
+     */
+    bool operator!=(const SmallString& other) const noexcept;
+
+private:
+
+    // The last byte stores the unused capacity of inline strings (so it doubles as
+    // the terminating zero of full strings), or this marker for shared strings
+    static const uint8_t SHARED = 0xFF;
+
+    static_assert(SIZE > sizeof(SharedString) && SIZE <= 128, "Invalid SmallString size.");
+
+    union {
+        char         m_chars[SIZE]; /**< The characters of inline strings.   */
+        SharedString m_shared;      /**< The characters of long strings.     */
+    };
+};
+
+/**
+ * @brief  Prints a SharedString to the specified output stream.
+ * @param  stream [in] The output stream to print to.
+ * @param  string [in] The string to print.
+ * @return Reference to the output stream for chaining print statements.
+ */
+std::ostream& operator<<(std::ostream& stream, const SharedString& string);
+
+/**
+ * @brief  Prints a SmallString to the specified output stream.
+ * @param  stream [in] The output stream to print to.
+ * @param  string [in] The string to print.
+ * @return Reference to the output stream for chaining print statements.
+ */
+std::ostream& operator<<(std::ostream& stream, const SmallString& string);
+
+#endif // DATAFLOW_SMALL_STRING_HPP_INCLUDED
@@ -0,0 +1,111 @@
+#include "snapshot.h"
+
+// Standard includes
+#include <cstdio>
+#include <cstring>
+
+#if defined(ESP_PLATFORM)
+
+// ESP-IDF includes
+#include "esp_attr.h"
+
+/**
+ * The layout of the snapshot storage in RTC slow memory.
+ */
+struct SnapshotRecord {
+	uint32_t m_magic;                        /**< Marks the storage as initialized. */
+	uint32_t m_size;                         /**< The size of the stored snapshot.  */
+	uint32_t m_checksum;                     /**< The checksum of the snapshot.     */
+	uint8_t  m_data[DATAFLOW_SNAPSHOT_SIZE]; /**< The snapshot data.                */
+};
+
+// The snapshot storage retained during deep sleep
+static RTC_DATA_ATTR SnapshotRecord s_snapshot;
+
+#endif
+
+// Value marking the snapshot storage as initialized
+static const uint32_t SNAPSHOT_MAGIC = 0x44465353;
+
+bool SnapshotStorage::write(const uint8_t* data, std::size_t size)
+{
+	// Checking the capacity of the storage
+	if(size > DATAFLOW_SNAPSHOT_SIZE) return false;
+
+#if defined(ESP_PLATFORM)
+
+	// Copying the snapshot into RTC memory
+	memcpy(s_snapshot.m_data, data, size);
+	s_snapshot.m_size = size;
+	s_snapshot.m_checksum = checksum(data, size);
+	s_snapshot.m_magic = SNAPSHOT_MAGIC;
+
+	return true;
+
+#else
+
+	// Writing the snapshot with a header into the storage file
+	FILE* fp = fopen(DATAFLOW_SNAPSHOT_FILE, "wb");
+	if(fp == nullptr) return false;
+
+	uint32_t header[3] = { SNAPSHOT_MAGIC, (uint32_t) size, checksum(data, size) };
+	bool status = fwrite(header, sizeof(header), 1, fp) == 1 && fwrite(data, 1, size, fp) == size;
+
+	fclose(fp);
+	return status;
+
+#endif
+}
+
+std::size_t SnapshotStorage::read(uint8_t* data)
+{
+#if defined(ESP_PLATFORM)
+
+	// Checking if the RTC memory contains a valid snapshot
+	if(s_snapshot.m_magic != SNAPSHOT_MAGIC || s_snapshot.m_size > DATAFLOW_SNAPSHOT_SIZE) return 0;
+	if(checksum(s_snapshot.m_data, s_snapshot.m_size) != s_snapshot.m_checksum) return 0;
+
+	// Copying the snapshot from RTC memory
+	memcpy(data, s_snapshot.m_data, s_snapshot.m_size);
+	return s_snapshot.m_size;
+
+#else
+
+	// Reading the header of the storage file
+	FILE* fp = fopen(DATAFLOW_SNAPSHOT_FILE, "rb");
+	if(fp == nullptr) return 0;
+
+	uint32_t header[3] = { 0, 0, 0 };
+	bool status = fread(header, sizeof(header), 1, fp) == 1;
+	status = status && header[0] == SNAPSHOT_MAGIC && header[1] <= DATAFLOW_SNAPSHOT_SIZE;
+
+	// Reading and validating the snapshot data
+	status = status && fread(data, 1, header[1], fp) == header[1];
+	status = status && checksum(data, header[1]) == header[2];
+
+	fclose(fp);
+	return status ? header[1] : 0;
+
+#endif
+}
+
+void SnapshotStorage::invalidate()
+{
+#if defined(ESP_PLATFORM)
+	s_snapshot.m_magic = 0;
+#else
+	remove(DATAFLOW_SNAPSHOT_FILE);
+#endif
+}
+
+uint32_t SnapshotStorage::checksum(const uint8_t* data, std::size_t size) noexcept
+{
+	// Calculating the 32-bit FNV-1a hash of the data
+	uint32_t hash = 2166136261u;
+	for(std::size_t i = 0; i < size; i++) {
+		hash ^= data[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#ifndef DATAFLOW_SNAPSHOT_H_INCLUDED
+#define DATAFLOW_SNAPSHOT_H_INCLUDED
+
+// Standard includes
+#include <cstdint>
+#include <cstddef>
+
+// The capacity of the snapshot storage in bytes (RTC slow memory on the device)
+#ifndef DATAFLOW_SNAPSHOT_SIZE
+#define DATAFLOW_SNAPSHOT_SIZE (1024)
+#endif
+
+// The file used as snapshot storage when not running on the device
+#ifndef DATAFLOW_SNAPSHOT_FILE
+#define DATAFLOW_SNAPSHOT_FILE "dataflow_snapshot.bin"
+#endif
+
+
+/**
+ * The SnapshotStorage class implements the persistent storage of graph state
+ * snapshots. On the device the snapshot is kept in RTC slow memory, which is
+ * retained during deep sleep but lost on power loss. On other platforms the
+ * snapshot is written to a file. The stored data is protected by a checksum,
+ * so uninitialized or corrupted storage is never restored.
+ */
+class SnapshotStorage {
+public:
+
+	/**
+	 * Writes the snapshot data into the storage.
+	 * @param  data [in] The snapshot data to store.
+	 * @param  size [in] The size of the data, at most DATAFLOW_SNAPSHOT_SIZE.
+	 * @return True when the snapshot is stored successfully.
+	 */
+	static bool write(const uint8_t* data, std::size_t size);
+
+	/**
+	 * Reads a valid snapshot from the storage.
+	 * @param  data [out] The buffer to read the data into (DATAFLOW_SNAPSHOT_SIZE bytes).
+	 * @return The size of the snapshot, zero when there is no valid snapshot stored.
+	 */
+	static std::size_t read(uint8_t* data);
+
+	/**
+	 * Invalidates the snapshot stored, so it is not restored again.
+	 */
+	static void invalidate();
+
+	/**
+	 * Calculates the FNV-1a checksum of the specified data.
+	 * @param  data [in] The data to calculate the checksum for.
+	 * @param  size [in] The size of the data in bytes.
+	 * @return The checksum of the data.
+	 */
+	static uint32_t checksum(const uint8_t* data, std::size_t size) noexcept;
+};
+
+#endif // DATAFLOW_SNAPSHOT_H_INCLUDED
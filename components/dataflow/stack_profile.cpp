@@ -0,0 +1,107 @@
+#include "stack_profile.h"
+
+// Standard includes
+#include <cstdio>
+
+// Project includes
+#include "snapshot.h"
+
+#if defined(ESP_PLATFORM)
+
+// ESP-IDF includes
+#include "nvs.h"
+#include "nvs_flash.h"
+
+// The NVS namespace and key of the stack profile
+static const char* NVS_NAMESPACE = "dataflow";
+static const char* NVS_KEY       = "stacks";
+
+#endif
+
+// Value marking the stored stack profile
+static const uint32_t PROFILE_MAGIC = 0x44465350;
+
+bool StackProfileStorage::write(const std::vector<uint32_t>& data)
+{
+	// Prepending the magic and the checksum of the profile
+	std::vector<uint32_t> record = { PROFILE_MAGIC, SnapshotStorage::checksum(reinterpret_cast<const uint8_t*>(data.data()), data.size() * sizeof(uint32_t)) };
+	record.insert(record.end(), data.begin(), data.end());
+
+#if defined(ESP_PLATFORM)
+
+	// Initializing the NVS partition, which is also done by the WiFi driver later
+	if(nvs_flash_init() != ESP_OK) return false;
+
+	nvs_handle_t handle;
+	if(nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) return false;
+
+	// Writing the profile as a single blob
+	bool status = nvs_set_blob(handle, NVS_KEY, record.data(), record.size() * sizeof(uint32_t)) == ESP_OK;
+	status = status && nvs_commit(handle) == ESP_OK;
+
+	nvs_close(handle);
+	return status;
+
+#else
+
+	// Writing the profile into the storage file
+	FILE* fp = fopen(DATAFLOW_STACK_PROFILE_FILE, "wb");
+	if(fp == nullptr) return false;
+
+	bool status = fwrite(record.data(), sizeof(uint32_t), record.size(), fp) == record.size();
+
+	fclose(fp);
+	return status;
+
+#endif
+}
+
+bool StackProfileStorage::read(std::vector<uint32_t>& data)
+{
+	std::vector<uint32_t> record;
+	data.clear();
+
+#if defined(ESP_PLATFORM)
+
+	// Initializing the NVS partition, which is also done by the WiFi driver later
+	if(nvs_flash_init() != ESP_OK) return false;
+
+	nvs_handle_t handle;
+	if(nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) return false;
+
+	// Querying the size of the blob, then reading it
+	std::size_t size = 0;
+	bool status = nvs_get_blob(handle, NVS_KEY, nullptr, &size) == ESP_OK && size % sizeof(uint32_t) == 0;
+
+	if(status) {
+		record.resize(size / sizeof(uint32_t));
+		status = nvs_get_blob(handle, NVS_KEY, record.data(), &size) == ESP_OK;
+	}
+
+	nvs_close(handle);
+	if(!status) return false;
+
+#else
+
+	// Reading the whole storage file
+	FILE* fp = fopen(DATAFLOW_STACK_PROFILE_FILE, "rb");
+	if(fp == nullptr) return false;
+
+	uint32_t word = 0;
+	while(fread(&word, sizeof(word), 1, fp) == 1) record.push_back(word);
+
+	fclose(fp);
+
+#endif
+
+	// Validating the magic and the checksum of the profile
+	if(record.size() < 2 || record[0] != PROFILE_MAGIC) return false;
+
+	data.assign(record.begin() + 2, record.end());
+	if(SnapshotStorage::checksum(reinterpret_cast<const uint8_t*>(data.data()), data.size() * sizeof(uint32_t)) != record[1]) {
+		data.clear();
+		return false;
+	}
+
+	return true;
+}
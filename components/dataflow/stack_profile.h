@@ -0,0 +1,40 @@
+#pragma once
+#ifndef DATAFLOW_STACK_PROFILE_H_INCLUDED
+#define DATAFLOW_STACK_PROFILE_H_INCLUDED
+
+// Standard includes
+#include <vector>
+#include <cstdint>
+
+// The file used as stack profile storage when not running on the device
+#ifndef DATAFLOW_STACK_PROFILE_FILE
+#define DATAFLOW_STACK_PROFILE_FILE "dataflow_stacks.bin"
+#endif
+
+
+/**
+ * The StackProfileStorage class implements the persistent storage of the stack
+ * profile, which records the stack usage of the dataflow tasks measured during
+ * calibration (see Dataflow::saveStackProfile()). Unlike the snapshots, the profile
+ * has to survive power loss and firmware restarts, so on the device it is kept in
+ * the NVS flash partition. On other platforms the profile is written to a file.
+ */
+class StackProfileStorage {
+public:
+
+	/**
+	 * Writes the stack profile into the storage.
+	 * @param  data [in] The words of the profile to store.
+	 * @return True when the profile is stored successfully.
+	 */
+	static bool write(const std::vector<uint32_t>& data);
+
+	/**
+	 * Reads the stack profile from the storage.
+	 * @param  data [out] The words of the profile, cleared when there is no valid profile.
+	 * @return True when a valid profile is read.
+	 */
+	static bool read(std::vector<uint32_t>& data);
+};
+
+#endif // DATAFLOW_STACK_PROFILE_H_INCLUDED
@@ -0,0 +1,302 @@
+#include "timer.h"
+
+// ESP-IDF includes
+#include "esp_log.h"
+
+// The mask of the slot index within a level
+static const unsigned SLOT_MASK = TimerWheel::SLOTS - 1;
+
+// Timer
+
+Timer::Timer() noexcept
+	: m_target(nullptr), m_expiry(0), m_delay(0), m_period(0), m_slot(INACTIVE), m_used(false), m_missed(0)
+{
+	m_prev = m_next = nullptr;
+}
+
+Timer::Timer(Port& target, const Node& message)
+	: Timer()
+{
+	setTarget(target, message);
+}
+
+Timer::~Timer()
+{
+	stop();
+}
+
+void Timer::setTarget(Port& target, const Node& message)
+{
+	m_target = &target;
+	m_message = message;
+}
+
+void Timer::start(TickType_t delay, TickType_t period)
+{
+	m_used = true;
+	TimerService::instance().schedule(*this, delay, period);
+}
+
+void Timer::reset()
+{
+	start(m_delay, m_period);
+}
+
+void Timer::stop()
+{
+	// Timers never started do not need the service
+	if(m_used) TimerService::instance().cancel(*this);
+}
+
+bool Timer::active() const
+{
+	return m_used && TimerService::instance().active(*this);
+}
+
+uint32_t Timer::missed() const noexcept
+{
+	return m_missed;
+}
+
+// TimerWheel
+
+TimerWheel::TimerWheel(TickType_t now) noexcept
+	: m_now(now), m_count(0)
+{
+	// Initializing the slots as empty circular lists
+	for(unsigned level = 0; level < LEVELS; level++) {
+		for(unsigned index = 0; index < SLOTS; index++) {
+			m_slots[level][index].m_prev = m_slots[level][index].m_next = &m_slots[level][index];
+		}
+
+		m_occupied[level] = 0;
+	}
+}
+
+void TimerWheel::insert(Timer* timer) noexcept
+{
+	// Expiring the Timers due already on the next tick
+	if(static_cast<int32_t>(timer->m_expiry - m_now) <= 0) timer->m_expiry = m_now + 1;
+
+	place(timer);
+	m_count++;
+}
+
+void TimerWheel::remove(Timer* timer) noexcept
+{
+	// Unlinking the Timer from its slot
+	timer->m_prev->m_next = timer->m_next;
+	timer->m_next->m_prev = timer->m_prev;
+
+	// Marking the slot empty when this was its last Timer
+	unsigned level = timer->m_slot / SLOTS;
+	unsigned index = timer->m_slot % SLOTS;
+	if(m_slots[level][index].m_next == &m_slots[level][index]) m_occupied[level] &= ~(1ull << index);
+
+	timer->m_prev = timer->m_next = nullptr;
+	timer->m_slot = Timer::INACTIVE;
+	m_count--;
+}
+
+void TimerWheel::advance(TickType_t now, TimerLink& expired) noexcept
+{
+	expired.m_prev = expired.m_next = &expired;
+
+	while(m_now != now) {
+
+		// Jumping over the empty slots of the lowest level, but not over the end of its turn
+		TickType_t step = nextSlot();
+		if(step > now - m_now) step = now - m_now;
+		m_now += step;
+
+		// Cascading the higher levels when the level below completes a turn
+		unsigned index = m_now & SLOT_MASK;
+		for(unsigned level = 1; index == 0 && level < LEVELS; level++) {
+			index = (m_now >> (level * LEVEL_BITS)) & SLOT_MASK;
+			cascade(level, index);
+		}
+
+		// Moving the Timers of the current slot to the expired list
+		index = m_now & SLOT_MASK;
+		TimerLink& slot = m_slots[0][index];
+
+		while(slot.m_next != &slot) {
+			Timer* timer = static_cast<Timer*>(slot.m_next);
+			remove(timer);
+
+			timer->m_prev = expired.m_prev;
+			timer->m_next = &expired;
+			expired.m_prev->m_next = timer;
+			expired.m_prev = timer;
+		}
+	}
+}
+
+TickType_t TimerWheel::idleTicks() const noexcept
+{
+	return (m_count == 0) ? portMAX_DELAY : nextSlot();
+}
+
+std::size_t TimerWheel::size() const noexcept
+{
+	return m_count;
+}
+
+TickType_t TimerWheel::now() const noexcept
+{
+	return m_now;
+}
+
+void TimerWheel::place(Timer* timer) noexcept
+{
+	// Finding the lowest level covering the expiry, parking far Timers in the last slot of the top level
+	TickType_t delta = timer->m_expiry - m_now;
+	TickType_t expiry = (delta < RANGE) ? timer->m_expiry : m_now + RANGE - 1;
+
+	unsigned level = 0;
+	while(level < LEVELS - 1 && delta >= (1u << ((level + 1) * LEVEL_BITS))) level++;
+
+	unsigned index = (expiry >> (level * LEVEL_BITS)) & SLOT_MASK;
+
+	// Linking the Timer at the end of the slot
+	TimerLink& slot = m_slots[level][index];
+	timer->m_prev = slot.m_prev;
+	timer->m_next = &slot;
+	slot.m_prev->m_next = timer;
+	slot.m_prev = timer;
+
+	timer->m_slot = level * SLOTS + index;
+	m_occupied[level] |= 1ull << index;
+}
+
+void TimerWheel::cascade(unsigned level, unsigned index) noexcept
+{
+	TimerLink& slot = m_slots[level][index];
+	if(slot.m_next == &slot) return;
+
+	// Detaching the list of the slot, then placing its Timers again relative to the current tick
+	TimerLink* link = slot.m_next;
+	slot.m_prev->m_next = nullptr;
+	slot.m_prev = slot.m_next = &slot;
+	m_occupied[level] &= ~(1ull << index);
+
+	while(link != nullptr) {
+		Timer* timer = static_cast<Timer*>(link);
+		link = link->m_next;
+		place(timer);
+	}
+}
+
+TickType_t TimerWheel::nextSlot() const noexcept
+{
+	// Finding the first occupied slot after the current one on the lowest level
+	unsigned index = m_now & SLOT_MASK;
+	uint64_t later = (index < SLOT_MASK) ? m_occupied[0] & (~0ull << (index + 1)) : 0;
+
+	return later ? __builtin_ctzll(later) - index : SLOTS - index;
+}
+
+// TimerService
+
+TimerService& TimerService::instance()
+{
+	static TimerService s_service;
+	return s_service;
+}
+
+TimerService::TimerService()
+	: m_wheel(xTaskGetTickCount()), m_mutex(xSemaphoreCreateMutex()), m_task(nullptr)
+{
+	if(xTaskCreatePinnedToCore(serviceTaskFunction, "timers", DATAFLOW_TIMER_STACK_SIZE, this, DATAFLOW_TIMER_PRIORITY, &m_task, 0) != pdPASS) {
+		ESP_LOGE("DATAFLOW", "Failed to create the timer service task.");
+	}
+}
+
+std::size_t TimerService::size() const
+{
+	xSemaphoreTake(m_mutex, portMAX_DELAY);
+	std::size_t size = m_wheel.size();
+	xSemaphoreGive(m_mutex);
+
+	return size;
+}
+
+void TimerService::schedule(Timer& timer, TickType_t delay, TickType_t period)
+{
+	xSemaphoreTake(m_mutex, portMAX_DELAY);
+
+	// Rescheduling is removing and inserting, both O(1)
+	if(timer.m_slot != Timer::INACTIVE) m_wheel.remove(&timer);
+
+	timer.m_delay = delay;
+	timer.m_period = period;
+	timer.m_expiry = xTaskGetTickCount() + delay;
+	m_wheel.insert(&timer);
+
+	xSemaphoreGive(m_mutex);
+
+	// Waking up the service to sleep until the new Timer when it is sooner
+	xTaskNotifyGive(m_task);
+}
+
+void TimerService::cancel(Timer& timer)
+{
+	xSemaphoreTake(m_mutex, portMAX_DELAY);
+	if(timer.m_slot != Timer::INACTIVE) m_wheel.remove(&timer);
+	xSemaphoreGive(m_mutex);
+}
+
+bool TimerService::active(const Timer& timer) const
+{
+	xSemaphoreTake(m_mutex, portMAX_DELAY);
+	bool active = timer.m_slot != Timer::INACTIVE;
+	xSemaphoreGive(m_mutex);
+
+	return active;
+}
+
+void TimerService::deliver(TimerLink& expired)
+{
+	TickType_t now = m_wheel.now();
+
+	while(expired.m_next != &expired) {
+		Timer* timer = static_cast<Timer*>(expired.m_next);
+		expired.m_next = timer->m_next;
+		timer->m_prev = timer->m_next = nullptr;
+
+		// Sending the message without blocking the other Timers
+		if(timer->m_target == nullptr || !timer->m_target->send(timer->m_message, 0)) timer->m_missed++;
+
+		if(timer->m_period == 0) continue;
+
+		// Scheduling the next expiry relative to this one, skipping the periods passed already
+		timer->m_expiry += timer->m_period;
+		while(static_cast<int32_t>(timer->m_expiry - now) <= 0) {
+			timer->m_expiry += timer->m_period;
+			timer->m_missed++;
+		}
+
+		m_wheel.insert(timer);
+	}
+}
+
+void TimerService::serviceTaskFunction(void* servicePtr)
+{
+	TimerService* service = static_cast<TimerService*>(servicePtr);
+
+	while(true) {
+		xSemaphoreTake(service->m_mutex, portMAX_DELAY);
+
+		// Expiring the Timers due, then delivering them with the wheel locked, so
+		// Timers being stopped or destroyed by their components are not delivered
+		TimerLink expired;
+		service->m_wheel.advance(xTaskGetTickCount(), expired);
+		service->deliver(expired);
+
+		TickType_t idle = service->m_wheel.idleTicks();
+		xSemaphoreGive(service->m_mutex);
+
+		// Sleeping until the next occupied slot, or until a Timer is scheduled
+		ulTaskNotifyTake(pdTRUE, idle);
+	}
+}
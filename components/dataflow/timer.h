@@ -0,0 +1,287 @@
+#pragma once
+#ifndef DATAFLOW_TIMER_H_INCLUDED
+#define DATAFLOW_TIMER_H_INCLUDED
+
+// Standard includes
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// FreeRTOS includes
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+// Project includes
+#include "node.hpp"
+#include "port.h"
+
+// The stack size of the timer service task
+#ifndef DATAFLOW_TIMER_STACK_SIZE
+#define DATAFLOW_TIMER_STACK_SIZE (3072)
+#endif
+
+// The priority of the timer service task, above the component tasks
+#ifndef DATAFLOW_TIMER_PRIORITY
+#define DATAFLOW_TIMER_PRIORITY (11)
+#endif
+
+
+/**
+ * The TimerLink structure links the Timers scheduled into the same slot of the
+ * TimerWheel into a circular list, so they are added and removed in O(1).
+ */
+struct TimerLink {
+	TimerLink* m_prev; /**< The previous Timer of the slot. */
+	TimerLink* m_next; /**< The next Timer of the slot.     */
+};
+
+/**
+ * The Timer class implements a one-shot or periodic timer of the dataflow timer
+ * service (see TimerService). On expiry the message of the Timer is sent to its
+ * target Port from the timer service task without blocking: when the queue of a
+ * receiver is full the expiration is dropped and counted as missed. Targeting an
+ * input Port of the Component delivers the expirations to its own task, while
+ * targeting an output Port broadcasts them directly (which is safe as long as no
+ * other task sends to that Port). Periodic Timers are scheduled on the absolute
+ * time of the previous expiry, so they do not drift.
+ */
+class Timer : private TimerLink {
+public:
+
+	/**
+	 * Constructs a Timer without a target, set by setTarget() before starting.
+	 */
+	Timer() noexcept;
+
+	/**
+	 * Constructs a Timer sending to the specified Port.
+	 * @param target  [in] The Port to send the expirations to.
+	 * @param message [in] The message to send on each expiry.
+	 */
+	Timer(Port& target, const Node& message);
+
+	/**
+	 * Destroys the Timer, stopping it first.
+	 */
+	~Timer();
+
+	// Timers are linked into the timer wheel by their address
+	Timer(const Timer&) = delete;
+	Timer& operator=(const Timer&) = delete;
+
+	/**
+	 * Sets the Port and the message sent on expiry. This must be called before
+	 * starting the Timer.
+	 * @param target  [in] The Port to send the expirations to.
+	 * @param message [in] The message to send on each expiry.
+	 */
+	void setTarget(Port& target, const Node& message);
+
+	/**
+	 * Starts the Timer, or restarts it when it is active already (eg. to reset a
+	 * watchdog). Restarting is O(1) no matter how many Timers are active.
+	 * @param delay  [in] The ticks until the first expiry.
+	 * @param period [in] The ticks between the following expirations, zero for a one-shot Timer.
+	 */
+	void start(TickType_t delay, TickType_t period = 0);
+
+	/**
+	 * Restarts the Timer with the delay and period of the last start().
+	 */
+	void reset();
+
+	/**
+	 * Stops the Timer, messages sent already are not affected.
+	 */
+	void stop();
+
+	/**
+	 * Queries whether the Timer is scheduled to expire.
+	 * @return True when the Timer is active.
+	 */
+	bool active() const;
+
+	/**
+	 * Queries the number of expirations not delivered, because the queue of a
+	 * receiver was full or the timer service was late for a whole period.
+	 * @return The number of expirations missed.
+	 */
+	uint32_t missed() const noexcept;
+
+private:
+
+	// The timer wheel schedules and the timer service delivers the Timers
+	friend class TimerWheel;
+	friend class TimerService;
+
+	// Value of the slot of inactive Timers
+	static const uint16_t INACTIVE = 0xFFFF;
+
+	Port*                 m_target;  /**< The Port to send the expirations to.           */
+	Node                  m_message; /**< The message sent on each expiry.               */
+	TickType_t            m_expiry;  /**< The absolute tick of the next expiry.          */
+	TickType_t            m_delay;   /**< The delay of the last start.                   */
+	TickType_t            m_period;  /**< The period of the Timer, zero for one-shots.   */
+	uint16_t              m_slot;    /**< The slot of the Timer in the wheel.            */
+	bool                  m_used;    /**< Whether the Timer was ever started.            */
+	std::atomic<uint32_t> m_missed;  /**< The number of expirations missed.              */
+};
+
+/**
+ * The TimerWheel class implements a hierarchical timing wheel: each of the levels
+ * has SLOTS slots, the slots of the lowest level are one tick wide, and the slots of
+ * each higher level are as wide as a whole turn of the level below. Timers are put
+ * into the slot of their expiry on the lowest level covering it, so scheduling and
+ * cancelling are O(1), and the Timers of a higher level slot are cascaded to the
+ * lower levels when the wheel below completes a turn. Timers further than the top
+ * level are parked in its last slot and rescheduled from there. The wheel is not
+ * synchronized, the TimerService serializes the access to it.
+ */
+class TimerWheel {
+public:
+
+	static const unsigned   LEVEL_BITS = 6;                             /**< The bits of the slot index.        */
+	static const unsigned   SLOTS      = 1u << LEVEL_BITS;              /**< The number of slots of a level.    */
+	static const unsigned   LEVELS     = 4;                             /**< The number of levels.              */
+	static const TickType_t RANGE      = 1u << (LEVEL_BITS * LEVELS);   /**< The number of ticks of the wheel.  */
+
+	/**
+	 * Constructs an empty TimerWheel.
+	 * @param now [in] The current tick.
+	 */
+	explicit TimerWheel(TickType_t now) noexcept;
+
+	/**
+	 * Schedules a Timer to expire at its expiry tick, which is moved to the next
+	 * tick when it has passed already.
+	 * @param timer [in] Pointer to the inactive Timer to schedule.
+	 */
+	void insert(Timer* timer) noexcept;
+
+	/**
+	 * Cancels a scheduled Timer.
+	 * @param timer [in] Pointer to the active Timer to cancel.
+	 */
+	void remove(Timer* timer) noexcept;
+
+	/**
+	 * Advances the wheel to the specified tick, skipping the empty slots. The
+	 * expired Timers are removed from the wheel and linked into a list.
+	 * @param now     [in]  The current tick.
+	 * @param expired [out] The head of the circular list to link the expired Timers into.
+	 */
+	void advance(TickType_t now, TimerLink& expired) noexcept;
+
+	/**
+	 * Queries the ticks until the wheel has to be advanced next, which is the
+	 * next occupied slot of the lowest level, or the end of its turn.
+	 * @return The ticks until the next advance, portMAX_DELAY when the wheel is empty.
+	 */
+	TickType_t idleTicks() const noexcept;
+
+	/**
+	 * Queries the number of scheduled Timers.
+	 * @return The number of Timers in the wheel.
+	 */
+	std::size_t size() const noexcept;
+
+	/**
+	 * Queries the tick the wheel is advanced to.
+	 * @return The current tick of the wheel.
+	 */
+	TickType_t now() const noexcept;
+
+private:
+
+	/**
+	 * Links a Timer into the slot covering its expiry.
+	 * @param timer [in] Pointer to the Timer to link.
+	 */
+	void place(Timer* timer) noexcept;
+
+	/**
+	 * Reschedules the Timers of a slot on the lower levels.
+	 * @param level [in] The level of the slot.
+	 * @param index [in] The index of the slot.
+	 */
+	void cascade(unsigned level, unsigned index) noexcept;
+
+	/**
+	 * Queries the ticks until the next occupied slot of the lowest level, or the
+	 * end of its turn when the rest of the level is empty.
+	 * @return The ticks until the next slot to process.
+	 */
+	TickType_t nextSlot() const noexcept;
+
+	TimerLink   m_slots[LEVELS][SLOTS]; /**< The heads of the circular lists of the slots. */
+	uint64_t    m_occupied[LEVELS];     /**< The bitmaps of the non-empty slots.            */
+	TickType_t  m_now;                  /**< The tick the wheel is advanced to.             */
+	std::size_t m_count;                /**< The number of scheduled Timers.                */
+};
+
+/**
+ * The TimerService class runs the timer wheel of all Timers on a single task, which
+ * only wakes up when a slot of the wheel has to be processed. The service is started
+ * by the first Timer started.
+ */
+class TimerService {
+public:
+
+	/**
+	 * Queries the timer service, starting it on the first call.
+	 * @return Reference to the timer service.
+	 */
+	static TimerService& instance();
+
+	/**
+	 * Queries the number of active Timers.
+	 * @return The number of Timers scheduled.
+	 */
+	std::size_t size() const;
+
+private:
+
+	// The Timers are scheduled through the service
+	friend class Timer;
+
+	/**
+	 * Constructs the timer service and starts its task.
+	 */
+	TimerService();
+
+	/**
+	 * Schedules a Timer, cancelling it first when it is active.
+	 * @param timer  [in] The Timer to schedule.
+	 * @param delay  [in] The ticks until the first expiry.
+	 * @param period [in] The ticks between the following expirations, zero for a one-shot Timer.
+	 */
+	void schedule(Timer& timer, TickType_t delay, TickType_t period);
+
+	/**
+	 * Cancels a Timer when it is active.
+	 * @param timer [in] The Timer to cancel.
+	 */
+	void cancel(Timer& timer);
+
+	/**
+	 * Queries whether a Timer is scheduled.
+	 * @param  timer [in] The Timer to query.
+	 * @return True when the Timer is active.
+	 */
+	bool active(const Timer& timer) const;
+
+	/**
+	 * Sends the messages of the expired Timers and reschedules the periodic ones.
+	 * @param expired [in] The head of the circular list of the expired Timers.
+	 */
+	void deliver(TimerLink& expired);
+
+	static void serviceTaskFunction(void* servicePtr);
+
+	TimerWheel        m_wheel; /**< The wheel scheduling the Timers.          */
+	SemaphoreHandle_t m_mutex; /**< The mutex serializing access to the wheel. */
+	TaskHandle_t      m_task;  /**< The task of the timer service.            */
+};
+
+#endif // DATAFLOW_TIMER_H_INCLUDED
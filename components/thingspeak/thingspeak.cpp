@@ -81,16 +81,15 @@ ThingSpeakQuery ThingSpeakClient::readChannel(uint64_t channelID, const std::str
 	// Parsing returned JSON data from the server
 	JsonObject data = JsonObject::parse(response.get_body());
 
+	// Resolving the shared prefix of the fields only once
+	const JsonObject feed = data["feeds"][0];
+
 	// Extracting returned data from the response
 	std::string fields[8];
-	fields[0] = data["feeds"][0]["field1"].isNull() ? "" : data["feeds"][0]["field1"].getString();
-	fields[1] = data["feeds"][0]["field1"].isNull() ? "" : data["feeds"][0]["field2"].getString();
-	fields[2] = data["feeds"][0]["field1"].isNull() ? "" : data["feeds"][0]["field3"].getString();
-	fields[3] = data["feeds"][0]["field1"].isNull() ? "" : data["feeds"][0]["field4"].getString();
-	fields[4] = data["feeds"][0]["field1"].isNull() ? "" : data["feeds"][0]["field5"].getString();
-	fields[5] = data["feeds"][0]["field1"].isNull() ? "" : data["feeds"][0]["field6"].getString();
-	fields[6] = data["feeds"][0]["field1"].isNull() ? "" : data["feeds"][0]["field7"].getString();
-	fields[7] = data["feeds"][0]["field1"].isNull() ? "" : data["feeds"][0]["field8"].getString();
+	for(std::size_t i = 0; i < 8; i++) {
+		const JsonObject field = feed["field" + std::to_string(i + 1)];
+		fields[i] = field.isString() ? field.getString() : "";
+	}
 
 	return ThingSpeakQuery(fields);
 }
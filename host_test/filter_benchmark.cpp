@@ -0,0 +1,120 @@
+/**
+ * Throughput benchmark of the filter kernels (see filter_kernels.h). Each kernel
+ * filters blocks of a noisy signal for a fixed time and the rate is reported in
+ * samples per second. The rates of the host only compare the kernels and track
+ * regressions, the ESP32 is one to two orders of magnitude slower. The handling of
+ * NaN samples by the median kernel is checked before the benchmarks.
+ *
+ * Usage: filter_benchmark [seconds per kernel]
+ */
+
+// Standard includes
+#include <cmath>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+
+// Project includes
+#include "filter_kernels.h"
+
+// The number of samples filtered at once, like an array field of a message
+static const std::size_t BLOCK_SIZE = 256;
+
+/**
+ * Filters the signal by the kernel repeatedly for the given time.
+ * @param  name    [in] The name of the kernel in the report.
+ * @param  kernel  [in] The kernel to benchmark.
+ * @param  signal  [in] The samples to filter, a multiple of BLOCK_SIZE.
+ * @param  seconds [in] The duration of the benchmark.
+ * @return True when the kernel produced finite samples.
+ */
+static bool benchmark(const char* name, FilterKernel& kernel, const std::vector<float>& signal, double seconds)
+{
+	typedef std::chrono::steady_clock Clock;
+
+	std::vector<float> output(BLOCK_SIZE);
+	std::size_t consumed = 0, produced = 0;
+	float checksum = 0;
+
+	Clock::time_point start = Clock::now();
+	Clock::time_point deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+
+	// Checking the clock once per pass over the signal only
+	do {
+		for(std::size_t offset = 0; offset < signal.size(); offset += BLOCK_SIZE) {
+			std::size_t count = kernel.process(signal.data() + offset, output.data(), BLOCK_SIZE);
+			if(count > 0) checksum += output[count - 1];
+
+			consumed += BLOCK_SIZE;
+			produced += count;
+		}
+	} while(Clock::now() < deadline);
+
+	double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+	std::printf("%-16s %12.0f samples/s  (%zu in, %zu out)\n", name, consumed / elapsed, consumed, produced);
+
+	return std::isfinite(checksum) && produced > 0;
+}
+
+/**
+ * Checks that the median kernel skips NaN samples instead of sorting them into
+ * its window, which breaks the ordering the window relies on.
+ * @return True when the NaN samples are skipped.
+ */
+static bool medianSkipsNan()
+{
+	const float nan = std::nanf("");
+	const float input[] = { nan, 1.0f, nan, 3.0f, nan, 2.0f, 5.0f, nan, 4.0f };
+	const float expected[] = { nan, 1.0f, 1.0f, 2.0f, 2.0f, 2.0f, 3.0f, 3.0f, 4.0f };
+	const std::size_t count = sizeof(input) / sizeof(input[0]);
+
+	MedianKernel kernel(3);
+	float output[count];
+	kernel.process(input, output, count);
+
+	bool valid = std::isnan(output[0]);
+	for(std::size_t i = 1; i < count; i++) valid &= (output[i] == expected[i]);
+
+	std::printf("%s: median kernel skips NaN samples\n", valid ? "PASS" : "FAIL");
+	return valid;
+}
+
+int main(int argc, char** argv)
+{
+	double seconds = (argc > 1) ? std::atof(argv[1]) : 0.2;
+
+	// Generating a slow sine with pseudo-random noise
+	std::vector<float> signal(64 * BLOCK_SIZE);
+	uint32_t random = 12345;
+	for(std::size_t i = 0; i < signal.size(); i++) {
+		random = random * 1664525u + 1013904223u;
+		signal[i] = std::sin(i * 0.01f) + ((random >> 8) / 16777216.0f - 0.5f) * 0.2f;
+	}
+
+	// A 32 tap moving average and two low-pass biquad sections
+	std::vector<float> taps(32, 1.0f / 32);
+	std::vector<float> sections = { 0.0675f, 0.1349f, 0.0675f, -1.1430f, 0.4128f,
+	                                0.0675f, 0.1349f, 0.0675f, -1.1430f, 0.4128f };
+
+	std::unique_ptr<FilterKernel> kernels[] = {
+		std::unique_ptr<FilterKernel>(new EmaKernel(0.1f)),
+		std::unique_ptr<FilterKernel>(new MedianKernel(15)),
+		std::unique_ptr<FilterKernel>(new KalmanKernel(0.01f, 1.0f)),
+		std::unique_ptr<FilterKernel>(new FirKernel(taps)),
+		std::unique_ptr<FilterKernel>(new FirKernel(taps, 4)),
+		std::unique_ptr<FilterKernel>(new IirKernel(sections)),
+		std::unique_ptr<FilterKernel>(new IirKernel(sections, 4)),
+	};
+
+	const char* names[] = { "EMA", "Median(15)", "Kalman", "FIR(32)", "FIR(32)/4", "IIR(2x biquad)", "IIR(2x biquad)/4" };
+
+	bool valid = medianSkipsNan();
+	for(std::size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+		valid &= benchmark(names[i], *kernels[i], signal, seconds);
+	}
+
+	return valid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
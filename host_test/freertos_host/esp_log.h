@@ -0,0 +1,12 @@
+#pragma once
+#ifndef HOST_ESP_LOG_H_INCLUDED
+#define HOST_ESP_LOG_H_INCLUDED
+
+// Standard includes
+#include <cstdio>
+
+#define ESP_LOGE(tag, format, ...) std::fprintf(stderr, "E %s: " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) std::fprintf(stderr, "W %s: " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) std::fprintf(stderr, "I %s: " format "\n", tag, ##__VA_ARGS__)
+
+#endif // HOST_ESP_LOG_H_INCLUDED
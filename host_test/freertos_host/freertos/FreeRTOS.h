@@ -0,0 +1,29 @@
+#pragma once
+#ifndef HOST_FREERTOS_H_INCLUDED
+#define HOST_FREERTOS_H_INCLUDED
+
+// Standard includes
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Host port of the FreeRTOS definitions used by the dataflow library, so its
+ * platform independent parts (ports, recorder) can be built for host tests.
+ * The kernel objects are emulated with standard threads and condition variables.
+ */
+
+typedef uint32_t TickType_t;
+typedef int      BaseType_t;
+typedef unsigned UBaseType_t;
+
+#define pdTRUE             1
+#define pdFALSE            0
+#define pdPASS             pdTRUE
+#define pdFAIL             pdFALSE
+#define portMAX_DELAY      ((TickType_t) 0xFFFFFFFFUL)
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define portTICK_RATE_MS   portTICK_PERIOD_MS
+#define pdMS_TO_TICKS(ms)  ((TickType_t) (((TickType_t) (ms) * configTICK_RATE_HZ) / 1000))
+
+#endif // HOST_FREERTOS_H_INCLUDED
@@ -0,0 +1,17 @@
+#pragma once
+#ifndef HOST_FREERTOS_QUEUE_H_INCLUDED
+#define HOST_FREERTOS_QUEUE_H_INCLUDED
+
+// Project includes
+#include "FreeRTOS.h"
+
+struct QueueDefinition;
+typedef QueueDefinition* QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+void          vQueueDelete(QueueHandle_t queue);
+BaseType_t    xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t timeout);
+BaseType_t    xQueueReceive(QueueHandle_t queue, void* item, TickType_t timeout);
+UBaseType_t   uxQueueMessagesWaiting(QueueHandle_t queue);
+
+#endif // HOST_FREERTOS_QUEUE_H_INCLUDED
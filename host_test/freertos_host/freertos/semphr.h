@@ -0,0 +1,17 @@
+#pragma once
+#ifndef HOST_FREERTOS_SEMPHR_H_INCLUDED
+#define HOST_FREERTOS_SEMPHR_H_INCLUDED
+
+// Project includes
+#include "queue.h"
+
+// Semaphores are queues of empty items, as in FreeRTOS
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maximum, UBaseType_t initial);
+BaseType_t        xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t timeout);
+BaseType_t        xSemaphoreGive(SemaphoreHandle_t semaphore);
+void              vSemaphoreDelete(SemaphoreHandle_t semaphore);
+
+#endif // HOST_FREERTOS_SEMPHR_H_INCLUDED
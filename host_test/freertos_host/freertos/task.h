@@ -0,0 +1,14 @@
+#pragma once
+#ifndef HOST_FREERTOS_TASK_H_INCLUDED
+#define HOST_FREERTOS_TASK_H_INCLUDED
+
+// Project includes
+#include "FreeRTOS.h"
+
+struct tskTaskControlBlock;
+typedef tskTaskControlBlock* TaskHandle_t;
+
+void       vTaskDelay(TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+
+#endif // HOST_FREERTOS_TASK_H_INCLUDED
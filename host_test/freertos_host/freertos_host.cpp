@@ -0,0 +1,135 @@
+// Standard includes
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstring>
+#include <condition_variable>
+
+// Project includes
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+/**
+ * The emulated queue, a bounded FIFO of fixed size items.
+ */
+struct QueueDefinition {
+	std::mutex                     m_mutex;    /**< Guards the items of the queue.            */
+	std::condition_variable        m_changed;  /**< Signalled when items are added or taken.  */
+	std::deque<std::vector<char>>  m_items;    /**< The items in the queue.                   */
+	std::size_t                    m_length;   /**< The maximum number of items in the queue. */
+	std::size_t                    m_itemSize; /**< The size of an item in bytes.             */
+};
+
+/**
+ * Waits until the condition holds or the timeout expires.
+ * @param  lock      [in] The lock of the queue, held by the caller.
+ * @param  queue     [in] The queue to wait on.
+ * @param  timeout   [in] The timeout in ticks.
+ * @param  condition [in] The condition to wait for.
+ * @return True when the condition holds.
+ */
+template <class Condition>
+static bool wait(std::unique_lock<std::mutex>& lock, QueueHandle_t queue, TickType_t timeout, Condition condition)
+{
+	if(timeout == portMAX_DELAY) {
+		queue->m_changed.wait(lock, condition);
+		return true;
+	}
+
+	return queue->m_changed.wait_for(lock, std::chrono::milliseconds(timeout * portTICK_PERIOD_MS), condition);
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize)
+{
+	QueueHandle_t queue = new QueueDefinition();
+	queue->m_length = length;
+	queue->m_itemSize = itemSize;
+
+	return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+	delete queue;
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t timeout)
+{
+	std::unique_lock<std::mutex> lock(queue->m_mutex);
+
+	// Waiting for a free slot
+	if(!wait(lock, queue, timeout, [queue]{ return queue->m_items.size() < queue->m_length; })) return pdFALSE;
+
+	// Copying the item into the queue
+	const char* data = static_cast<const char*>(item);
+	queue->m_items.emplace_back(data, data + queue->m_itemSize);
+	queue->m_changed.notify_all();
+
+	return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t timeout)
+{
+	std::unique_lock<std::mutex> lock(queue->m_mutex);
+
+	// Waiting for an item
+	if(!wait(lock, queue, timeout, [queue]{ return !queue->m_items.empty(); })) return pdFALSE;
+
+	// Copying the item out of the queue
+	if(queue->m_itemSize > 0) memcpy(item, queue->m_items.front().data(), queue->m_itemSize);
+	queue->m_items.pop_front();
+	queue->m_changed.notify_all();
+
+	return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+	std::lock_guard<std::mutex> lock(queue->m_mutex);
+	return queue->m_items.size();
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+	// A mutex is a binary semaphore which is available initially
+	return xSemaphoreCreateCounting(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maximum, UBaseType_t initial)
+{
+	SemaphoreHandle_t semaphore = xQueueCreate(maximum, 0);
+	for(UBaseType_t i = 0; i < initial; i++) xSemaphoreGive(semaphore);
+
+	return semaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t timeout)
+{
+	return xQueueReceive(semaphore, nullptr, timeout);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+	return xQueueSendToBack(semaphore, nullptr, 0);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+	vQueueDelete(semaphore);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS));
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+	// There are no executor tasks on the host to wake up
+	(void) task;
+	return pdPASS;
+}
@@ -0,0 +1,109 @@
+/**
+ * Stress test of the Node tree operations which must use constant stack: the
+ * destruction, copying, mutable iteration, comparison and hashing of very wide
+ * and very deep trees. The checks run on a thread with a small stack, so any
+ * recursion proportional to the size of the tree overflows it and crashes the test.
+ */
+
+// Standard includes
+#include <cstdio>
+#include <cstdlib>
+#include <pthread.h>
+
+// Project includes
+#include "node.hpp"
+
+// The number of children of the wide tree and the depth of the deep tree
+static const std::size_t TREE_SIZE = 100000;
+
+// The stack of the checks, far less than a recursion over TREE_SIZE nodes needs
+static const std::size_t STACK_SIZE = 256 * 1024;
+
+static int s_failures = 0;
+
+static void check(bool condition, const char* description)
+{
+	std::printf("%s: %s\n", condition ? "PASS" : "FAIL", description);
+	if(!condition) s_failures++;
+}
+
+static std::size_t countNodes(Node& root)
+{
+	std::size_t count = 0;
+	for(Node::iterator it = root.begin(); it != root.end(); ++it) count++;
+	return count;
+}
+
+static void wideArray()
+{
+	Node* array = new Node("array");
+	for(std::size_t i = 0; i < TREE_SIZE; i++) array->add("") = (double) i;
+	check(array->child_count() == TREE_SIZE, "wide array built");
+
+	// Copying shares the children, iterating the copy splits them
+	Node* copy = new Node(*array);
+	check(countNodes(*copy) == TREE_SIZE + 1, "wide array copy iterated");
+
+	const double* last = (*copy)[TREE_SIZE - 1].get<double>();
+	check((last != nullptr) && (*last == TREE_SIZE - 1), "wide array copy holds the values");
+
+	delete array;
+	check(copy->child_count() == TREE_SIZE, "wide array copy outlives the original");
+	delete copy;
+	check(true, "wide array destroyed");
+}
+
+static void deepChain()
+{
+	Node* chain = new Node("chain");
+	Node* node = chain;
+	for(std::size_t i = 0; i < TREE_SIZE; i++) node = &node->add("link");
+	*node = 1.0;
+
+	// Copying shares the top level, iterating the copy splits every level
+	Node* copy = new Node(*chain);
+	check(countNodes(*copy) == TREE_SIZE + 1, "deep chain copy iterated");
+
+	// The split copy shares no level with the original, so every level is compared
+	check(*copy == *chain && copy->hash() == chain->hash(), "deep chain copy equal to the original");
+
+	Node* leaf = copy;
+	for(Node::iterator it = copy->begin(); it != copy->end(); ++it) leaf = &*it;
+	*leaf = 2.0;
+	check(*copy != *chain && copy->hash() != chain->hash(), "deep chain copy differs after changing the leaf");
+
+	Node* copyChain = new Node();
+	*copyChain = *copy;
+	delete chain;
+	check(countNodes(*copyChain) == TREE_SIZE + 1, "deep chain assigned copy outlives the original");
+
+	delete copy;
+	delete copyChain;
+	check(true, "deep chain destroyed");
+}
+
+static void* runChecks(void*)
+{
+	wideArray();
+	deepChain();
+	return nullptr;
+}
+
+int main()
+{
+	// Running the checks on a thread with a limited stack
+	pthread_attr_t attributes;
+	pthread_attr_init(&attributes);
+	pthread_attr_setstacksize(&attributes, STACK_SIZE);
+
+	pthread_t thread;
+	if(pthread_create(&thread, &attributes, &runChecks, nullptr) != 0) {
+		std::printf("FAIL: creating the test thread\n");
+		return EXIT_FAILURE;
+	}
+
+	pthread_join(thread, nullptr);
+	pthread_attr_destroy(&attributes);
+
+	return (s_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
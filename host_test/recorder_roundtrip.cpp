@@ -0,0 +1,94 @@
+/**
+ * Round-trip test of the port traffic recording: the messages queued into an
+ * input Port are recorded into a file, which is then replayed into another Port
+ * of the same kind, as when replaying the traffic of a device on a host.
+ */
+
+// Standard includes
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Project includes
+#include "port.h"
+#include "recorder.h"
+
+// The number of messages recorded
+static const std::size_t MESSAGE_COUNT = 50;
+
+static int s_failures = 0;
+
+static void check(bool condition, const char* description)
+{
+	std::printf("%s: %s\n", condition ? "PASS" : "FAIL", description);
+	if(!condition) s_failures++;
+}
+
+/**
+ * Builds a message resembling a measurement, with nested and array children.
+ * @param index [in] The index of the message.
+ * @return The message.
+ */
+static Node message(std::size_t index)
+{
+	Node message("measurement");
+	message["temperature"] = 20.0 + index / 10.0;
+	message["valid"] = (index % 2) == 0;
+	message["location"]["name"] = std::string("station-") + std::to_string(index % 3);
+
+	Node& samples = message["samples"];
+	for(std::size_t i = 0; i < index % 5; i++) samples.add((double) i);
+
+	return message;
+}
+
+int main(int argc, char* argv[])
+{
+	const std::string path = (argc > 1) ? argv[1] : "recorder_roundtrip.bin";
+
+	// Recording the messages queued into the input port
+	std::vector<Node> sent;
+	{
+		Port input(Port::Direction::INPUT, "in", MESSAGE_COUNT);
+		PortRecorder recorder;
+
+		check(recorder.open(path), "recording opened");
+		check(recorder.attach(input, "sensor.in"), "port attached");
+
+		for(std::size_t i = 0; i < MESSAGE_COUNT; i++) {
+			sent.push_back(message(i));
+			input.send(sent.back(), 0);
+		}
+
+		// Draining the recorded port
+		Node received;
+		std::size_t count = 0;
+		while(input.receive(received, 0)) count++;
+		check(count == MESSAGE_COUNT, "recorded messages received");
+
+		recorder.close();
+	}
+
+	// Replaying the recording into another port as fast as possible
+	Port replayed(Port::Direction::INPUT, "in", MESSAGE_COUNT);
+	Port unbound(Port::Direction::INPUT, "other", 1);
+	PortReplayer replayer;
+
+	check(replayer.open(path), "recording reopened");
+	replayer.bind("sensor.in", replayed);
+	replayer.bind("unknown.in", unbound);
+	check(replayer.replay(0) == MESSAGE_COUNT, "all messages replayed");
+
+	// Comparing the replayed messages with the recorded ones
+	bool identical = true;
+	for(std::size_t i = 0; i < MESSAGE_COUNT; i++) {
+		Node received;
+		identical &= replayed.receive(received, 0) && (received == sent[i]);
+	}
+	check(identical, "replayed messages match the recorded ones");
+	check(replayed.depth() == 0 && unbound.depth() == 0, "no extra messages replayed");
+
+	std::remove(path.c_str());
+	return (s_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,83 @@
+/**
+ * Test of the limits of the binary Node encoding: the nesting depth accepted by
+ * both the encoder and the decoder, and the byte order of floating-point values.
+ */
+
+// Standard includes
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Project includes
+#include "serializer.h"
+
+static int s_failures = 0;
+
+static void check(bool condition, const char* description)
+{
+	std::printf("%s: %s\n", condition ? "PASS" : "FAIL", description);
+	if(!condition) s_failures++;
+}
+
+/**
+ * Builds a chain of Nodes with the specified number of levels below the root.
+ * @param root  [in] The root of the chain.
+ * @param depth [in] The number of levels to add.
+ */
+static void chain(Node& root, std::size_t depth)
+{
+	Node* node = &root;
+	for(std::size_t i = 0; i < depth; i++) node = &node->add("link");
+	*node = 1.0;
+}
+
+static void nesting()
+{
+	std::vector<uint8_t> buffer(1024);
+
+	// The deepest tree accepted round trips
+	Node deepest("root");
+	chain(deepest, 32);
+	std::size_t length = NodeSerializer::serialize(deepest, buffer.data(), buffer.size());
+
+	Node decoded;
+	check(length != 0 && length == NodeSerializer::serializedSize(deepest), "deepest tree encoded");
+	check(NodeSerializer::deserialize(buffer.data(), length, decoded) == length && decoded == deepest, "deepest tree decoded");
+
+	// A tree one level deeper is refused by the encoder, as the decoder would refuse it
+	Node deeper("root");
+	chain(deeper, 33);
+	check(NodeSerializer::serialize(deeper, buffer.data(), buffer.size()) == 0, "deeper tree not encoded");
+	check(NodeSerializer::serializedSize(deeper) == 0, "deeper tree has no encoded size");
+}
+
+static void byteOrder()
+{
+	uint8_t buffer[16];
+
+	// Header (double tag), then the IEEE-754 bits of 1.0 starting with the lowest byte
+	Node node;
+	node = 1.0;
+	std::size_t length = NodeSerializer::serialize(node, buffer, sizeof(buffer));
+
+	const uint8_t expected[8] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F };
+	check(length == 9 && memcmp(buffer + 1, expected, sizeof(expected)) == 0, "double encoded little-endian");
+
+	node = 1.0f;
+	length = NodeSerializer::serialize(node, buffer, sizeof(buffer));
+
+	const uint8_t expectedFloat[4] = { 0x00, 0x00, 0x80, 0x3F };
+	check(length == 5 && memcmp(buffer + 1, expectedFloat, sizeof(expectedFloat)) == 0, "float encoded little-endian");
+
+	Node decoded;
+	NodeSerializer::deserialize(buffer, length, decoded);
+	check(decoded.get<float>() != nullptr && *decoded.get<float>() == 1.0f, "float decoded");
+}
+
+int main()
+{
+	nesting();
+	byteOrder();
+
+	return (s_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
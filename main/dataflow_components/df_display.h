@@ -3,9 +3,13 @@
 #define DATAFLOW_COMPONENTS_DF_DISPLAY_H_INCLUDED
 
 #include <time.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 
-#include "json.h"
 #include "dataflow.h"
+#include "path.h"
 #include "ssd1306.h"
 #include "font6x6.h"
 #include "font8x8.h"
@@ -24,24 +28,33 @@
  *                       received.
  *
  * [input] "in"        - Used to receive data to be display or control messages.
- *                       The received data is buffered in static non-volatile-memory.
+ *                       The port has two priority lanes: control messages (eg. button
+ *                       presses) should be connected to lane 1, so they are handled
+ *                       before the bulk data queued on lane 0.
+ *                       The received data is buffered and saved into the graph snapshot,
+ *                       so the last screen is redrawn right after waking up from deep sleep.
  *                       The input messages should have child nodes called:
  *                       "temperature" - Double, for measured temperature.
  *                       "pressure"    - Double, for measured pressure.
  *                       "humidity"    - Double, for measured humidity.
- *                       "forecast"    - std::string, forecast data in JSON format
+ *                       "query"       - Node, parsed forecast data (see DF_ThingspeakRead)
  *                       "battery"     - uint16_t, for raw battery ADC measurements.
  *                        ...
  */
 class DF_Display : public Component {
 public:
 
-	DF_Display() : m_display(nullptr)
+	DF_Display() : m_display(nullptr), m_displayData(), m_restored(false), m_mutex(xSemaphoreCreateMutex())
 	{
-		m_ports.addInputPort("in");
+		m_ports.addInputPort("in", 10, 2);
 		m_ports.addInputPort("interface", 1);
 	}
 
+	~DF_Display()
+	{
+		vSemaphoreDelete(m_mutex);
+	}
+
 	virtual void process() override
 	{
 		// Node object for reading messages
@@ -53,53 +66,65 @@ public:
 		// Creating SSD1306 display object
 		m_display = new SSD1306((DriverInterface*) message);
 
+		// Redrawing the last screen when the data is restored from a snapshot
+		if(m_restored) {
+			switch(m_displayData.s_displayState) {
+			case CURRENT_WEATHER: drawCurrentWeather(*m_display); break;
+			case FORECAST: drawWeatherForecast(*m_display); break;
+			case STATUS: drawStatus(*m_display); break;
+			}
+		}
+
 		while(true) {
 
 			// Reading message from the input port
 			m_ports["in"].receive(message);
 
+			// Updating the display data, while the snapshot is not being saved
+			xSemaphoreTake(m_mutex, portMAX_DELAY);
+
 			// Checking if the message contains measurement data
 			if(message.has_child("temperature") && message.has_child("pressure") && message.has_child("humidity"))
 			{
-				s_displayData.s_temperature = (double) message["temperature"];
-				s_displayData.s_pressure = (double) message["pressure"];
-				s_displayData.s_humidity = (double) message["humidity"];
+				m_displayData.s_temperature = (double) message["temperature"];
+				m_displayData.s_pressure = (double) message["pressure"];
+				m_displayData.s_humidity = (double) message["humidity"];
 
-				if(s_displayData.s_displayState == CURRENT_WEATHER) drawCurrentWeather(*m_display);
+				if(m_displayData.s_displayState == CURRENT_WEATHER) drawCurrentWeather(*m_display);
 			}
 
 			// Checking if the message contains forecast data
 			if(message.has_child("query")) {
 
-				// Parsing the forecast data
-				JsonObject data = JsonObject::parse((std::string) message["query"]);
-
-				// Extracting data from the forecast JSON
-				s_displayData.s_temperature_1 = data["forecast"][0]["temperature"]["day"].getDouble();
-				s_displayData.s_temperature_2 = data["forecast"][1]["temperature"]["day"].getDouble();
-				s_displayData.s_temperature_3 = data["forecast"][2]["temperature"]["day"].getDouble();
-				s_displayData.s_weatherID_1 = data["forecast"][0]["id"].getInteger();
-				s_displayData.s_weatherID_2 = data["forecast"][1]["id"].getInteger();
-				s_displayData.s_weatherID_3 = data["forecast"][2]["id"].getInteger();
-				s_displayData.s_dayIndex_1 = data["forecast"][0]["day"].getInteger();
-				s_displayData.s_dayIndex_2 = data["forecast"][1]["day"].getInteger();
-				s_displayData.s_dayIndex_3 = data["forecast"][2]["day"].getInteger();
-
-				if(s_displayData.s_displayState == FORECAST) drawWeatherForecast(*m_display);
+				// Extracting data from the already parsed forecast in a single traversal
+				const Node* data[9];
+				s_forecastPaths.extract(message["query"], data);
+
+				m_displayData.s_temperature_1 = number(data[0]);
+				m_displayData.s_temperature_2 = number(data[1]);
+				m_displayData.s_temperature_3 = number(data[2]);
+				m_displayData.s_weatherID_1 = number(data[3]);
+				m_displayData.s_weatherID_2 = number(data[4]);
+				m_displayData.s_weatherID_3 = number(data[5]);
+				m_displayData.s_dayIndex_1 = number(data[6]);
+				m_displayData.s_dayIndex_2 = number(data[7]);
+				m_displayData.s_dayIndex_3 = number(data[8]);
+
+				if(m_displayData.s_displayState == FORECAST) drawWeatherForecast(*m_display);
 			}
 
 			// Checking if the message contains battery data
 			if(message.has_child("battery")) {
-				s_displayData.s_battery = (uint16_t) message["battery"];
+				m_displayData.s_battery = (uint16_t) message["battery"];
 
-				if(s_displayData.s_displayState == STATUS) drawStatus(*m_display);
+				if(m_displayData.s_displayState == STATUS) drawStatus(*m_display);
 			}
 
 			// Checking if the message contains NEXT SCREEN request
 			if(message.hasType<int>()) {
-				s_displayData.s_displayState = (displayState)((s_displayData.s_displayState + 1) % 3);
+				m_displayData.s_displayState = (displayState)((m_displayData.s_displayState + 1) % 3);
 
-				switch(s_displayData.s_displayState) {
+				switch(m_displayData.s_displayState) {
 				case CURRENT_WEATHER: drawCurrentWeather(*m_display); break;
 				case FORECAST: drawWeatherForecast(*m_display); break;
 				case STATUS: drawStatus(*m_display); break;
@@ -108,9 +133,32 @@ public:
 
 			// Checking if the message contains PREVIOUS SCREEN request
 			// ???
+
+			xSemaphoreGive(m_mutex);
 		}
 	}
 
+	virtual std::size_t saveState(uint8_t* buffer, std::size_t size) override
+	{
+		// Saving the buffered display data, while the task of the component does not modify it
+		if(size < sizeof(m_displayData)) return 0;
+
+		xSemaphoreTake(m_mutex, portMAX_DELAY);
+		memcpy(buffer, &m_displayData, sizeof(m_displayData));
+		xSemaphoreGive(m_mutex);
+
+		return sizeof(m_displayData);
+	}
+
+	virtual void restoreState(const uint8_t* buffer, std::size_t size) override
+	{
+		// Restoring the buffered display data
+		if(size != sizeof(m_displayData)) return;
+		memcpy(&m_displayData, buffer, sizeof(m_displayData));
+
+		m_restored = true;
+	}
+
 private:
 
 	/**
@@ -119,7 +167,7 @@ private:
 	enum displayState { CURRENT_WEATHER, FORECAST, STATUS };
 
 	/**
-	 * Defines the display data to be persistently stored during deep sleep.
+	 * Defines the display data to be saved into the snapshot during deep sleep.
 	 */
 	struct DisplayData {
 		double       s_temperature;
@@ -142,6 +190,16 @@ private:
 	const Font font8x8 = {font8x8_descriptors, font8x8_data, 8+1};
 	const Font font6x6 = {font6x6_descriptors, font6x6_data, 6+1};
 
+	/**
+	 * Reads a number from a Node of parsed JSON data.
+	 * @param  node [in] Pointer to the Node to read (nullptr when missing).
+	 * @return The number stored in the Node, or zero when it is missing.
+	 */
+	static double number(const Node* node) noexcept {
+		const double* value = (node != nullptr) ? node->get<double>() : nullptr;
+		return (value != nullptr) ? *value : 0;
+	}
+
 	/**
 	 * Queries the weather condition icon index for the specified weather ID.
 	 * @param  weatherID [in] The weather ID to query the symbol index for.
@@ -178,15 +236,15 @@ private:
 		display.set_fonts(font6x6);
 		display.draw_rectangle(0, 0, 128, 64, Color::white());
 
-		char tempText[10]; sprintf(tempText, "%.1lf degC", s_displayData.s_temperature);
+		char tempText[10]; sprintf(tempText, "%.1lf degC", m_displayData.s_temperature);
 		display.set_text_cursor(30, 4);
 		display.print_text(tempText);
 
-		char presText[10]; sprintf(presText, "%.1lf hPa", s_displayData.s_pressure / 100);
+		char presText[10]; sprintf(presText, "%.1lf hPa", m_displayData.s_pressure / 100);
 		display.set_text_cursor(30, 28);
 		display.print_text(presText);
 
-		char humText[10]; sprintf(humText, "%.1lf %%", s_displayData.s_humidity);
+		char humText[10]; sprintf(humText, "%.1lf %%", m_displayData.s_humidity);
 		display.set_text_cursor(30, 50);
 		display.print_text(humText);
 
@@ -206,29 +264,29 @@ private:
 		display.draw_rectangle(0, 0, 128, 64, Color::white());
 
 		// Printing weather information for tomorrow
-		char text_1[15]; sprintf(text_1, "%.0lf'C", round(s_displayData.s_temperature_1));
-		display.draw_symbol(5, 5, weather_icon(s_displayData.s_weatherID_1));
+		char text_1[15]; sprintf(text_1, "%.0lf'C", round(m_displayData.s_temperature_1));
+		display.draw_symbol(5, 5, weather_icon(m_displayData.s_weatherID_1));
 		display.set_text_cursor(5, 54);
 		display.print_text(text_1);
-		sprintf(text_1, "%s", dayNames[s_displayData.s_dayIndex_1]);
+		sprintf(text_1, "%s", dayNames[m_displayData.s_dayIndex_1]);
 		display.set_text_cursor(5, 45);
 		display.print_text(text_1);
 
 		// Printing weather information for 2 days from now
-		char text_2[15]; sprintf(text_2, "%.0lf'C", round(s_displayData.s_temperature_2));
-		display.draw_symbol(47, 5, weather_icon(s_displayData.s_weatherID_2));
+		char text_2[15]; sprintf(text_2, "%.0lf'C", round(m_displayData.s_temperature_2));
+		display.draw_symbol(47, 5, weather_icon(m_displayData.s_weatherID_2));
 		display.set_text_cursor(47, 54);
 		display.print_text(text_2);
-		sprintf(text_2, "%s", dayNames[s_displayData.s_dayIndex_2]);
+		sprintf(text_2, "%s", dayNames[m_displayData.s_dayIndex_2]);
 		display.set_text_cursor(47, 45);
 		display.print_text(text_2);
 
 		// Printing weather information for 3 days from now
-		char text_3[15]; sprintf(text_3, "%.0lf'C", round(s_displayData.s_temperature_3));
-		display.draw_symbol(90, 5, weather_icon(s_displayData.s_weatherID_3));
+		char text_3[15]; sprintf(text_3, "%.0lf'C", round(m_displayData.s_temperature_3));
+		display.draw_symbol(90, 5, weather_icon(m_displayData.s_weatherID_3));
 		display.set_text_cursor(90, 54);
 		display.print_text(text_3);
-		sprintf(text_3, "%s", dayNames[s_displayData.s_dayIndex_3]);
+		sprintf(text_3, "%s", dayNames[m_displayData.s_dayIndex_3]);
 		display.set_text_cursor(90, 45);
 		display.print_text(text_3);
 
@@ -259,12 +317,19 @@ private:
 		display.refresh();
 	}
 
-	SSD1306* m_display; /**< Pointer to the specific display driver. */
+	SSD1306*          m_display;     /**< Pointer to the specific display driver.         */
+	DisplayData       m_displayData; /**< The buffered display data.                      */
+	bool              m_restored;    /**< Whether the data is restored from snapshot.     */
+	SemaphoreHandle_t m_mutex;       /**< The mutex guarding the data against snapshots. */
 
-	static RTC_DATA_ATTR DisplayData s_displayData;
+	static const PathSet s_forecastPaths; /**< The paths of the forecast data. */
 };
 
-// Definitions for static non-volatile storage display data
-DF_Display::DisplayData DF_Display::s_displayData;
+// Definition of the forecast data paths, compiled once
+const PathSet DF_Display::s_forecastPaths = {
+	"forecast/0/temperature/day", "forecast/1/temperature/day", "forecast/2/temperature/day",
+	"forecast/0/id", "forecast/1/id", "forecast/2/id",
+	"forecast/0/day", "forecast/1/day", "forecast/2/day"
+};
 
 #endif // DATAFLOW_COMPONENTS_DF_DISPLAY_H_INCLUDED
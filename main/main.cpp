@@ -268,6 +268,9 @@ void weatherTaskFunction(void *pvParameters) {
 
 void dataflow_test(void *pvParameters) {
 
+	// Creating dataflow manager object
+	Dataflow flow;
+
 	// Debug component for printing debug messages
 	DF_Debug debug;
 
@@ -316,6 +319,9 @@ void dataflow_test(void *pvParameters) {
 	// Thingspeak update component for writing sensor readings to Thingspeak
 	DF_ThingspeakWrite readingPoster(THINGSPEAK_WRITE_KEY);
 
+	// Keeping the updates until Thingspeak accepts them, across deep sleep (in RTC memory)
+	DF_DurableQueue uploadQueue("", 8);
+
 	// Test GPIO for switching display menus
 	DF_GPIO gpio(GPIO_NUM_0, DF_GPIO::Direction::INPUT, DF_GPIO::PullMode::PULLUP, DF_GPIO::TriggerType::POSEDGE);
 
@@ -325,7 +331,7 @@ void dataflow_test(void *pvParameters) {
 	// Simple watchdog timer which fires after 10 seconds of inactivity
 	DF_Watchdog inactivityTimer(10 * 1000);
 
-	DF_Function deepSleepStart([](Component::PortContainer& ports) {
+	DF_Function deepSleepStart([&flow](Component::PortContainer& ports) {
 
 			// Node object to receive messages
 			Node message;
@@ -340,6 +346,12 @@ void dataflow_test(void *pvParameters) {
 			esp_sleep_enable_timer_wakeup(DEEP_SLEEP_DURATION_SEC * 1000 * 1000);
 			esp_sleep_enable_ext0_wakeup(GPIO_NUM_0, 0);
 
+			// Saving the state of the components into RTC memory
+			flow.saveSnapshot();
+
+			// Recording the stack usage measured during this run
+			flow.saveStackProfile();
+
 			// Starting deep sleep
 			esp_deep_sleep_start();
 	});
@@ -350,7 +362,10 @@ void dataflow_test(void *pvParameters) {
 		SD_SPI sdCard(SPI_MISO_PIN, SPI_MOSI_PIN, SPI_CLK_PIN, SPI_CS_PIN);
 
 		// Mounting the SD card as a partition
-		if(!sdCard.mount("/sd")) vTaskSuspend(xTaskGetCurrentTaskHandle());
+		if(!sdCard.mount("/sd")) {
+			ports.finish();
+			return;
+		}
 
 		// Node object for reading messages
 		Node message;
@@ -397,7 +412,8 @@ void dataflow_test(void *pvParameters) {
 		setenv("TZ", "CET-1CEST,M3.5.0/2,M10.5.0/3", 1);
 		tzset();
 
-		vTaskSuspend(xTaskGetCurrentTaskHandle());
+		// Finishing the component, which returns the stack of its task
+		ports.finish();
 	});
 
 	// Connecting component outputs which should reset the inactivity timer
@@ -405,8 +421,8 @@ void dataflow_test(void *pvParameters) {
 	gpio["out"] >> inactivityTimer["in"];
 	inactivityTimer["out"] >> deepSleepStart["in"];
 
-	// Connecting GPIO input to the display
-	gpio["out"] >> debouncer["in"]["out"] >> display["in"];
+	// Connecting GPIO input to the display (on the high priority control lane)
+	gpio["out"] >> debouncer["in"]["out"] >> display["in"].lane(1);
 
 	// Specifying dataflow connections
 	master["interface"] >> sensor["interface"];
@@ -415,12 +431,15 @@ void dataflow_test(void *pvParameters) {
 	// Logging sensor data to SD card
 	sensor["out"] >> logger["in"];
 
-	// When we connected to the WiFi read the forecast data from Thingspeak
-	wifi["out"] >> forecastReader["in"]["out"] >> display["in"];
+	// When we connected to the WiFi read the forecast data from Thingspeak (redrawing only on changes)
+	wifi["out"] >> forecastReader["in"]["out"].emit(Port::Emit::ON_CHANGE) >> display["in"];
 
-	// When we connected to the WiFi, take sensor readings and send a Thingspeak update
-	wifi["out"] >> sensor["in"]["out"] >> thingspeakPostPrepare["in"]["out"] >> debug["in"]["out"]
-				>> readingPoster["in"];
+	// When we connected to the WiFi, take sensor readings and send a Thingspeak update (skipping duplicates)
+	wifi["out"] >> sensor["in"]["out"] >> thingspeakPostPrepare["in"]["out"].emit(Port::Emit::ON_CHANGE) >> debug["in"]["out"]
+				>> uploadQueue["in"]["out"] >> readingPoster["in"];
+
+	// Removing the updates from the queue when Thingspeak accepted them
+	readingPoster["out"] >> uploadQueue["ack"];
 
 	wifi["out"] >> timesync["in"];
 
@@ -430,9 +449,6 @@ void dataflow_test(void *pvParameters) {
 	// Kickstarting the flow by sending an initial message to the sensor
 	wifi["in"].sendInitialMessage(nullptr);
 
-	// Creating dataflow manager object
-	Dataflow flow;
-
 	// Adding dataflow components to the manager
 	flow.addComponent(&master);
 	flow.addComponent(&sensor);
@@ -441,6 +457,7 @@ void dataflow_test(void *pvParameters) {
 	flow.addComponent(&forecastReader);
 	flow.addComponent(&thingspeakPostPrepare);
 	flow.addComponent(&readingPoster);
+	flow.addComponent(&uploadQueue);
 	flow.addComponent(&wifi);
 	flow.addComponent(&gpio);
 	flow.addComponent(&debouncer);
@@ -449,8 +466,17 @@ void dataflow_test(void *pvParameters) {
 	flow.addComponent(&logger);
 	flow.addComponent(&timesync);
 
-	// Starting the dataflow execution
-	flow.startFlow();
+	// Restoring the state of the components saved before deep sleep
+	flow.restoreSnapshot();
+
+	// Applying the measured stack sizes, or calibrating them when there are none yet
+	if(!flow.loadStackProfile()) flow.setStackCalibration(true);
+
+	// Starting the dataflow execution, a graph without all of its tasks can not run
+	if(!flow.startFlow()) {
+		ESP_LOGE("DATAFLOW", "Failed to start the flow, restarting.");
+		esp_restart();
+	}
 
 	// Suspending the current task to let the dataflow execute
 	vTaskSuspend(xTaskGetCurrentTaskHandle());